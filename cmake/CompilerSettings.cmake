@@ -26,6 +26,58 @@ if (("${CMAKE_CXX_COMPILER_ID}" MATCHES "GNU") OR ("${CMAKE_CXX_COMPILER_ID}" MA
         endif()
     endif()
 
+    # 目标CPU
+    if (MARCH)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -march=${MARCH}")
+    endif()
+
+    # 链接时优化（静态库需要使用带插件的ar/ranlib，否则库中只有中间代码而没有符号表）
+    # CMAKE_CXX_FLAGS同时用于链接，链接时按同样的优化级别生成代码
+    if (WITH_LTO)
+        if ("${CMAKE_CXX_COMPILER_ID}" MATCHES "GNU")
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -flto=auto -fno-fat-lto-objects")
+            if (CMAKE_CXX_COMPILER_AR AND CMAKE_CXX_COMPILER_RANLIB)
+                set(CMAKE_AR "${CMAKE_CXX_COMPILER_AR}")
+                set(CMAKE_RANLIB "${CMAKE_CXX_COMPILER_RANLIB}")
+            endif()
+        else()
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -flto=thin")
+            find_program(LLVM_AR llvm-ar)
+            find_program(LLVM_RANLIB llvm-ranlib)
+            if (LLVM_AR AND LLVM_RANLIB)
+                set(CMAKE_AR "${LLVM_AR}")
+                set(CMAKE_RANLIB "${LLVM_RANLIB}")
+            endif()
+        endif()
+    endif()
+
+    # 基于剖析数据的优化（多个线程同时更新计数器，GCC需要-fprofile-update=atomic）
+    if (PGO STREQUAL "GENERATE")
+        if ("${CMAKE_CXX_COMPILER_ID}" MATCHES "GNU")
+            set(PGO_FLAGS "-fprofile-generate=${PGO_DIR} -fprofile-update=atomic")
+        else()
+            set(PGO_FLAGS "-fprofile-instr-generate=${PGO_DIR}/%m-%p.profraw")
+        endif()
+    elseif (PGO STREQUAL "USE")
+        if ("${CMAKE_CXX_COMPILER_ID}" MATCHES "GNU")
+            # 训练负载没有覆盖到的函数按正常方式优化，而不是按冷代码处理
+            set(PGO_FLAGS "-fprofile-use=${PGO_DIR} -fprofile-partial-training -Wno-missing-profile")
+        else()
+            set(PGO_FLAGS "-fprofile-instr-use=${PGO_DIR}/default.profdata -Wno-profile-instr-unprofiled")
+        endif()
+    endif()
+    if (PGO_FLAGS)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${PGO_FLAGS}")
+    endif()
+
+    # 模糊测试（Clang为所有代码加上libFuzzer的覆盖率插桩，只有模糊测试程序链接libFuzzer）
+    if (WITH_FUZZING)
+        set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=address,undefined -fno-omit-frame-pointer")
+        if ("${CMAKE_CXX_COMPILER_ID}" MATCHES "Clang")
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsanitize=fuzzer-no-link")
+        endif()
+    endif()
+
     # 各编译模式专有的编译选项
     set(CMAKE_CXX_FLAGS_DEBUG          "-Og -g")
     set(CMAKE_CXX_FLAGS_MINSIZEREL     "-Os -DNDEBUG")
@@ -6,8 +6,8 @@ if (NOT CMAKE_BUILD_TYPE)
     )
 endif()
 
-# C++标准，使用C++11
-set(CMAKE_CXX_STANDARD 11)
+# C++标准，使用C++17
+set(CMAKE_CXX_STANDARD 17)
 set(CMAKE_CXX_EXTENSIONS OFF)
 set(CMAKE_CXX_STANDARD_REQUIRED ON)
 
@@ -17,6 +17,50 @@ option(WITH_TESTS "Build and run tests" ON)
 # 是否构建检测代码覆盖率目标
 option(WITH_COVERAGE "Test code coverage" OFF)
 
+# 是否启用PROFILE_SCOPE性能剖析（关闭时PROFILE_SCOPE展开为空）
+option(WITH_PROFILING "Enable scoped profiling" OFF)
+if (WITH_PROFILING)
+    add_definitions(-DDEV_PROFILING)
+endif()
+
+# 是否启用内存分配跟踪（替换全局operator new/delete，按子系统统计，关闭时ALLOC_SCOPE展开为空）
+option(WITH_ALLOC_TRACKING "Enable allocation tracking" OFF)
+if (WITH_ALLOC_TRACKING)
+    add_definitions(-DDEV_ALLOC_TRACKING)
+    # 导出符号，采样的调用栈才能显示函数名
+    set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} -rdynamic")
+endif()
+
+# 是否启用链接时优化（跨编译单元内联vector_ref::cropped，bytesRequired等小函数）
+option(WITH_LTO "Enable link time optimization" OFF)
+
+# 基于剖析数据的优化，两阶段构建：
+# 1. cmake -DPGO=GENERATE 构建插桩版本，构建后自动运行的单元测试作为训练负载，剖析数据写入PGO_DIR
+# 2. cmake -DPGO=USE 使用PGO_DIR中的剖析数据重新构建（Clang需要先用llvm-profdata merge合并为default.profdata）
+set(PGO "OFF" CACHE STRING "Profile guided optimization, options are: OFF GENERATE USE")
+set_property(CACHE PGO PROPERTY STRINGS OFF GENERATE USE)
+set(PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Directory of PGO profile data")
+if (NOT PGO MATCHES "^(OFF|GENERATE|USE)$")
+    message(FATAL_ERROR "Invalid PGO value ${PGO}, options are: OFF GENERATE USE")
+endif()
+if (PGO STREQUAL "GENERATE" AND NOT WITH_TESTS)
+    message(FATAL_ERROR "PGO=GENERATE uses the unit tests as training workload. Please set WITH_TESTS=ON")
+endif()
+
+# 目标CPU（-march的值，例如native，x86-64-v3，skylake-avx512，为空时使用编译器默认值）
+# 部署到多种机器时保持为空，并打开WITH_MULTIVERSIONING
+set(MARCH "" CACHE STRING "Target CPU architecture passed to -march")
+
+# 是否为热点函数（Keccak，16进制编解码）生成多个CPU特性版本，运行时选择（DEV_TARGET_CLONES）
+option(WITH_MULTIVERSIONING "Enable function multiversioning for hot kernels" OFF)
+if (WITH_MULTIVERSIONING)
+    add_definitions(-DDEV_MULTIVERSIONING)
+endif()
+
+# 是否构建模糊测试程序（test/fuzz，所有代码加上AddressSanitizer和UndefinedBehaviorSanitizer）
+# Clang链接libFuzzer；其它编译器生成从文件或标准输入读取样本的程序，可以用afl-g++编译后交给AFL运行
+option(WITH_FUZZING "Build fuzzing harnesses" OFF)
+
 # 显示所有配置信息
 macro(print_config)
     message("")
@@ -30,6 +74,13 @@ macro(print_config)
     message("-- CMAKE_CXX_STANDARD C++ standard                 ${CMAKE_CXX_STANDARD}")
     message("-- WITH_TESTS         Build and run tests          ${WITH_TESTS}")
     message("-- WITH_COVERAGE      Test code coverage           ${WITH_COVERAGE}")
+    message("-- WITH_PROFILING     Enable scoped profiling      ${WITH_PROFILING}")
+    message("-- WITH_ALLOC_TRACKING Enable allocation tracking  ${WITH_ALLOC_TRACKING}")
+    message("-- WITH_LTO           Link time optimization       ${WITH_LTO}")
+    message("-- PGO                Profile guided optimization  ${PGO} (${PGO_DIR})")
+    message("-- MARCH              Target CPU architecture      ${MARCH}")
+    message("-- WITH_MULTIVERSIONING Function multiversioning   ${WITH_MULTIVERSIONING}")
+    message("-- WITH_FUZZING       Build fuzzing harnesses      ${WITH_FUZZING}")
     message("------------------------------------------------------------------------")
     message("")
 endmacro()
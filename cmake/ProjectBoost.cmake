@@ -28,7 +28,7 @@ ExternalProject_Add(
     CONFIGURE_COMMAND ./bootstrap.sh
     # 构建命令
     BUILD_COMMAND ./b2 stage
-                  cxxflags=-std=c++11
+                  cxxflags=-std=c++17
                   variant=release
                   link=static
                   threading=multi
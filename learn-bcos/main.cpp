@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <csignal>
+#include <pthread.h>
 #include <boost/program_options.hpp>
 #include <BuildInfo.h>
 #include <libconfig/Version.h>
+#include <libdevcore/AllocTracker.h>
+#include <libdevcore/MetricsExporter.h>
 
 namespace bpo = boost::program_options;
 
@@ -14,6 +21,12 @@ int main(int argc, char const *argv[])
         ("help,h", "Print help information")
         ("version,v", "Print version information")
         ("config,c", bpo::value<std::string>(), "Config file path. Default config.ini")
+        ("metrics-port", bpo::value<uint16_t>(), "Serve Prometheus metrics over HTTP on this port")
+        ("metrics-address", bpo::value<std::string>()->default_value("127.0.0.1"), "Listen address of the metrics endpoint")
+        ("metrics-textfile", bpo::value<std::string>(), "Write Prometheus metrics to this file (node_exporter textfile collector)")
+        ("metrics-interval", bpo::value<unsigned>()->default_value(15), "Seconds between metrics textfile writes")
+        ("alloc-report-interval", bpo::value<unsigned>()->default_value(60),
+            "Seconds between allocation reports (builds with WITH_ALLOC_TRACKING only)")
     ;
     bpo::variables_map vMap;
     bpo::store(bpo::parse_command_line(argc, argv, myOptions), vMap);
@@ -33,5 +46,45 @@ int main(int argc, char const *argv[])
         configPath = vMap["config"].as<std::string>();
     }
 
+    // 监控指标导出
+    if (!vMap.count("metrics-port") && !vMap.count("metrics-textfile")) {
+        return 0;
+    }
+    dev::MetricsRegistry::instance().gauge("learn_bcos_build_info", "Build information",
+        {{"version", PROJECT_VERSION}}).set(1);
+
+    // 在创建后台线程之前屏蔽退出信号，由主线程同步等待
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::unique_ptr<dev::MetricsHTTPServer> server;
+    std::unique_ptr<dev::MetricsTextfileWriter> writer;
+    std::unique_ptr<dev::AllocReporter> allocReporter;
+    try {
+        if (vMap.count("metrics-port")) {
+            server.reset(new dev::MetricsHTTPServer(vMap["metrics-address"].as<std::string>(),
+                vMap["metrics-port"].as<uint16_t>()));
+            std::cout << "Serving metrics on http://" << vMap["metrics-address"].as<std::string>()
+                << ":" << server->port() << "/metrics" << std::endl;
+        }
+        if (vMap.count("metrics-textfile")) {
+            writer.reset(new dev::MetricsTextfileWriter(vMap["metrics-textfile"].as<std::string>(),
+                std::chrono::seconds(std::max(vMap["metrics-interval"].as<unsigned>(), 1u))));
+        }
+        if (dev::AllocTracker::enabled()) {
+            allocReporter.reset(new dev::AllocReporter(
+                std::chrono::seconds(std::max(vMap["alloc-report-interval"].as<unsigned>(), 1u))));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    int sig = 0;
+    sigwait(&signals, &sig);
+
     return 0;
 }
@@ -9,6 +9,8 @@
  * @date: 2021-02-02
  */
 #include "ECDSA.h"
+#include <libdevcore/AllocTracker.h>
+#include <libdevcore/Metrics.h>
 #include <memory>
 #include <array>
 #include <cassert>
@@ -17,6 +19,25 @@
 
 namespace dev {
 
+// 签名/恢复的耗时（直方图的计数即调用次数）和失败次数
+static Histogram& signSeconds() {
+    static Histogram& s_histogram = MetricsRegistry::instance().histogram(
+        "crypto_ecdsa_seconds", "ECDSA operation latency", Histogram::latencyBuckets(), {{"op", "sign"}});
+    return s_histogram;
+}
+
+static Histogram& recoverSeconds() {
+    static Histogram& s_histogram = MetricsRegistry::instance().histogram(
+        "crypto_ecdsa_seconds", "ECDSA operation latency", Histogram::latencyBuckets(), {{"op", "recover"}});
+    return s_histogram;
+}
+
+static Counter& recoverErrors() {
+    static Counter& s_counter = MetricsRegistry::instance().counter(
+        "crypto_ecdsa_errors_total", "Failed ECDSA operations", {{"op", "recover"}});
+    return s_counter;
+}
+
 // secp256k1的阶数n
 const U256 c_secp256k1n("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141");
 const U256 c_secp256k1nHalf = c_secp256k1n / 2;
@@ -77,6 +98,9 @@ PubKey toPubKey(const SecKey& sec) {
  * @throw 签名错误抛出BadSignature异常
  */
 Signature sign(const SecKey& sec, const H256& digest) {
+    ALLOC_SCOPE(Crypto);
+    HistogramTimer timer(signSeconds());
+
     // 获取上下文
     auto secp256k1Ctx = getSECP256K1Ctx();
 
@@ -120,16 +144,21 @@ Signature sign(const SecKey& sec, const H256& digest) {
  * @throw 恢复错误抛出BadSignature异常
  */
 PubKey recover(const Signature& sig, const H256& digest) {
+    ALLOC_SCOPE(Crypto);
+    HistogramTimer timer(recoverSeconds());
+
     // 对于secp256k1曲线而言，只有四种recoveryId，分别是0，1，2，3
     // 以太坊中直接忽略了recoveryId等于2和3的情况，因为概率很低，大约为3.73*10^-39
     // 详见fisco-bcos的博客 https://my.oschina.net/fiscobcos/blog/4384028
     // 至于为什么忽略，我也不懂，可能是为了省id数吧，有知道的可以补充一下
     if (sig.v > 1) {
+        recoverErrors().inc();
         throw BadSignature();
     }
 
     // 见上面关于s值取值范围的解释
     if (sig.s.toArith() > c_secp256k1nHalf) {
+        recoverErrors().inc();
         throw BadSignature();
     }
 
@@ -139,12 +168,14 @@ PubKey recover(const Signature& sig, const H256& digest) {
     // 解析出原始签名信息格式
     secp256k1_ecdsa_recoverable_signature rawSig;
     if (!secp256k1_ecdsa_recoverable_signature_parse_compact(secp256k1Ctx, &rawSig, reinterpret_cast<const unsigned char*>(&sig), sig.v)) {
+        recoverErrors().inc();
         throw BadSignature();
     }
 
     // 解析出原始公钥
     secp256k1_pubkey rawPub;
     if (!secp256k1_ecdsa_recover(secp256k1Ctx, &rawPub, &rawSig, digest.data())) {
+        recoverErrors().inc();
         throw BadSignature();
     }
 
@@ -10,6 +10,7 @@
  * @date: 2021-01-24
  */
 #include "Keccak.h"
+#include <libdevcore/Metrics.h>
 #include <cstdint>
 
 #if _MSC_VER
@@ -67,8 +68,8 @@ static const uint64_t s_roundConstants[24] = {
     0x8000000080008008,
 };
 
-// 对内部状态进行搅拌的函数f，1600表示内部状态state包含的bit位数
-static void keccakf1600(uint64_t state[25]) {
+// 对内部状态进行搅拌的函数f，1600表示内部状态state包含的bit位数（BMI的andn/rorx能明显减少指令数）
+DEV_TARGET_CLONES static void keccakf1600(uint64_t state[25]) {
     /* The implementation based on the "simple" implementation by Ronny Van Keer. */
 
     int round;
@@ -363,8 +364,30 @@ static void keccak(uint64_t* out, size_t outBits, const uint8_t* data, size_t si
     }
 }
 
+/**
+ * keccak256的调用次数和字节数（单次哈希只有几百纳秒，只计数不计时）
+ * keccak256是noexcept的，而注册指标可能抛出异常，所以不在第一次调用时注册，而是在静态初始化时注册；
+ * 其它编译单元的静态初始化中可能已经在调用keccak256，注册之前的调用不计数
+ */
+static Counter* s_keccakCalls = nullptr;
+static Counter* s_keccakBytes = nullptr;
+
+static bool registerKeccakMetrics() {
+    auto& registry = MetricsRegistry::instance();
+    s_keccakCalls = &registry.counter("crypto_keccak256_total", "Keccak-256 hash calls");
+    s_keccakBytes = &registry.counter("crypto_keccak256_bytes_total", "Bytes hashed by Keccak-256");
+    return true;
+}
+
+static const bool s_keccakMetricsRegistered = registerKeccakMetrics();
+
 // 计算字节数组的keccak256哈希值
 H256 keccak256(BytesConstRef src) noexcept {
+    if (s_keccakMetricsRegistered) {
+        s_keccakCalls->inc();
+        s_keccakBytes->inc(src.size());
+    }
+
     H256 dst;
     keccak(reinterpret_cast<uint64_t*>(dst.data()), 256, src.data(), src.size());
     return dst;
@@ -0,0 +1,400 @@
+/**
+ * 内存分配跟踪（按子系统统计，采样分配位置）
+ * @file: AllocTracker.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "AllocTracker.h"
+#include "FastHash.h"
+#include "Log.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <execinfo.h>
+
+namespace dev {
+
+// 当前线程的子系统
+static thread_local AllocTag t_allocTag = AllocTag::Other;
+
+// 子系统名称
+const char* allocTagName(AllocTag tag) noexcept {
+    static const char* const c_names[c_allocTagCount] = {"other", "rlp", "crypto", "compression", "pool"};
+    size_t i = static_cast<size_t>(tag);
+    return i < c_allocTagCount ? c_names[i] : "unknown";
+}
+
+// 当前线程的子系统
+AllocTag currentAllocTag() noexcept {
+    return t_allocTag;
+}
+
+// 设置当前线程的子系统，返回之前的子系统
+AllocTag exchangeAllocTag(AllocTag tag) noexcept {
+    AllocTag previous = t_allocTag;
+    t_allocTag = tag;
+    return previous;
+}
+
+#if defined(DEV_ALLOC_TRACKING)
+
+// 以下全局变量都是常量初始化的，其它编译单元的静态对象在构造时分配内存也是安全的
+
+// 一个子系统的原子计数
+struct alignas(64) AllocCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+    std::atomic<uint64_t> freedBytes{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+};
+
+// 各个子系统和合计
+static AllocCounters s_tagCounters[c_allocTagCount];
+static AllocCounters s_totalCounters;
+
+// 每块内存前面的头部（16字节，保持operator new返回地址的对齐）
+struct alignas(16) AllocHeader {
+    uint64_t size;              // 请求的长度
+    uint8_t tag;                // 分配时的子系统
+};
+
+// 分配位置哈希表的槽位个数（满了之后新的位置不再记录）
+static const size_t c_siteSlots = 4096;
+
+// 插入时最多探测的槽位个数
+static const size_t c_siteProbes = 32;
+
+// 采样时跳过的调用栈层数（sampleSite和trackedAlloc自身）
+static const int c_siteSkip = 2;
+
+// 分配位置哈希表的槽位
+struct AllocSiteSlot {
+    std::atomic<uint64_t> key{0};                   // 调用栈的哈希值（0表示空闲）
+    std::atomic<bool> ready{false};                 // 调用栈已经写入
+    void* frames[c_allocSiteDepth] = {};
+    int depth = 0;
+    std::atomic<uint64_t> samples{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+static AllocSiteSlot s_sites[c_siteSlots];
+
+// 当前线程距离下次采样还需分配的字节数
+static thread_local int64_t t_untilSample = c_allocSampleBytes;
+
+// 当前线程正在采样（采样过程中的分配不再采样）
+static thread_local bool t_sampling = false;
+
+// 更新峰值
+static inline void updatePeak(AllocCounters& counters, int64_t live) noexcept {
+    int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+// 记录一次分配
+static inline void recordAlloc(AllocCounters& counters, uint64_t size) noexcept {
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    updatePeak(counters, counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + static_cast<int64_t>(size));
+}
+
+// 记录一次释放
+static inline void recordFree(AllocCounters& counters, uint64_t size) noexcept {
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    counters.freedBytes.fetch_add(size, std::memory_order_relaxed);
+    counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// 采样当前调用栈
+__attribute__((noinline)) static void sampleSite(uint64_t size) noexcept {
+    void* frames[c_allocSiteDepth + c_siteSkip];
+    int depth = backtrace(frames, c_allocSiteDepth + c_siteSkip) - c_siteSkip;
+    if (depth <= 0) {
+        return;
+    }
+    uint64_t key = fastHash(reinterpret_cast<const Byte*>(frames + c_siteSkip), depth * sizeof(void*), 0) | 1;
+
+    for (size_t i = 0; i < c_siteProbes; ++i) {
+        auto& slot = s_sites[(key + i) % c_siteSlots];
+        uint64_t current = slot.key.load(std::memory_order_acquire);
+        if (0 == current) {
+            if (!slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                if (current != key) {
+                    continue;
+                }
+            } else {
+                // 占用了空闲槽位，写入调用栈
+                memcpy(slot.frames, frames + c_siteSkip, depth * sizeof(void*));
+                slot.depth = depth;
+                slot.ready.store(true, std::memory_order_release);
+            }
+        } else if (current != key) {
+            continue;
+        }
+        slot.samples.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+        return;
+    }
+}
+
+// 分配内存并计入当前线程的子系统
+__attribute__((noinline)) static void* trackedAlloc(size_t size, bool nothrow) {
+    if (size > SIZE_MAX - sizeof(AllocHeader)) {
+        if (nothrow) {
+            return nullptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* raw;
+    while (!(raw = malloc(sizeof(AllocHeader) + size))) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            if (nothrow) {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        if (nothrow) {
+            try {
+                handler();
+            } catch (...) {
+                return nullptr;
+            }
+        } else {
+            handler();
+        }
+    }
+
+    auto header = static_cast<AllocHeader*>(raw);
+    header->size = size;
+    header->tag = static_cast<uint8_t>(t_allocTag);
+    recordAlloc(s_tagCounters[header->tag], size);
+    recordAlloc(s_totalCounters, size);
+
+    t_untilSample -= static_cast<int64_t>(size);
+    if (t_untilSample <= 0 && !t_sampling) {
+        t_sampling = true;
+        t_untilSample = c_allocSampleBytes;
+        sampleSite(size);
+        t_sampling = false;
+    }
+    return header + 1;
+}
+
+// 释放内存并计入分配时的子系统
+static void trackedFree(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    auto header = static_cast<AllocHeader*>(p) - 1;
+    recordFree(s_tagCounters[header->tag], header->size);
+    recordFree(s_totalCounters, header->size);
+    free(header);
+}
+
+// 读取一个子系统的计数
+static AllocTagStats loadCounters(const AllocCounters& counters) noexcept {
+    AllocTagStats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.frees = counters.frees.load(std::memory_order_relaxed);
+    stats.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+    stats.freedBytes = counters.freedBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = std::max<int64_t>(counters.peakBytes.load(std::memory_order_relaxed), 0);
+    return stats;
+}
+
+bool AllocTracker::enabled() noexcept {
+    return true;
+}
+
+AllocSnapshot AllocTracker::snapshot() noexcept {
+    AllocSnapshot snapshot;
+    for (size_t i = 0; i < c_allocTagCount; ++i) {
+        snapshot.tags[i] = loadCounters(s_tagCounters[i]);
+    }
+    snapshot.total = loadCounters(s_totalCounters);
+    snapshot.time = std::chrono::steady_clock::now();
+    return snapshot;
+}
+
+// 采样次数最多的n个分配位置
+std::vector<AllocSite> AllocTracker::topSites(size_t n) {
+    std::vector<std::pair<uint64_t, size_t>> ranked;
+    for (size_t i = 0; i < c_siteSlots; ++i) {
+        if (s_sites[i].ready.load(std::memory_order_acquire)) {
+            ranked.emplace_back(s_sites[i].samples.load(std::memory_order_relaxed), i);
+        }
+    }
+    n = std::min(n, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(),
+        [](const std::pair<uint64_t, size_t>& a, const std::pair<uint64_t, size_t>& b) { return a.first > b.first; });
+
+    std::vector<AllocSite> sites;
+    for (size_t i = 0; i < n; ++i) {
+        auto& slot = s_sites[ranked[i].second];
+        AllocSite site;
+        site.samples = ranked[i].first;
+        site.bytes = slot.bytes.load(std::memory_order_relaxed);
+        // 需要链接时加-rdynamic才能显示函数名，否则显示模块和偏移（可以用addr2line解析）
+        char** symbols = backtrace_symbols(slot.frames, slot.depth);
+        for (int j = 0; j < slot.depth; ++j) {
+            site.frames.push_back(symbols ? symbols[j] : "??");
+        }
+        free(symbols);
+        sites.push_back(std::move(site));
+    }
+    return sites;
+}
+
+#else
+
+bool AllocTracker::enabled() noexcept {
+    return false;
+}
+
+AllocSnapshot AllocTracker::snapshot() noexcept {
+    AllocSnapshot snapshot;
+    snapshot.time = std::chrono::steady_clock::now();
+    return snapshot;
+}
+
+std::vector<AllocSite> AllocTracker::topSites(size_t) {
+    return std::vector<AllocSite>();
+}
+
+#endif
+
+// 导出为文本
+std::string AllocTracker::toText(const AllocSnapshot& now, const AllocSnapshot* before, const std::vector<AllocSite>& sites) {
+    double seconds = before ? std::chrono::duration<double>(now.time - before->time).count() : 0;
+    std::string text;
+    char line[256];
+    snprintf(line, sizeof(line), "%-12s %14s %14s %14s %14s %12s\n",
+        "subsystem", "live(B)", "peak(B)", "allocs", "allocated(B)", "rate(MB/s)");
+    text += line;
+    for (size_t i = 0; i <= c_allocTagCount; ++i) {
+        bool total = i == c_allocTagCount;
+        const AllocTagStats& stats = total ? now.total : now.tags[i];
+        const AllocTagStats* previous = before ? (total ? &before->total : &before->tags[i]) : nullptr;
+        double rate = previous && seconds > 0
+            ? (stats.allocatedBytes - previous->allocatedBytes) / seconds / (1 << 20) : 0;
+        snprintf(line, sizeof(line), "%-12s %14lld %14llu %14llu %14llu %12.2f\n",
+            total ? "total" : allocTagName(static_cast<AllocTag>(i)),
+            static_cast<long long>(stats.liveBytes()),
+            static_cast<unsigned long long>(stats.peakBytes),
+            static_cast<unsigned long long>(stats.allocations),
+            static_cast<unsigned long long>(stats.allocatedBytes), rate);
+        text += line;
+    }
+    for (size_t i = 0; i < sites.size(); ++i) {
+        snprintf(line, sizeof(line), "site #%zu: %llu samples, %llu bytes\n", i + 1,
+            static_cast<unsigned long long>(sites[i].samples), static_cast<unsigned long long>(sites[i].bytes));
+        text += line;
+        for (auto& frame : sites[i].frames) {
+            text += "    " + frame + "\n";
+        }
+    }
+    return text;
+}
+
+// 写入全局监控指标
+void AllocTracker::publish(const AllocSnapshot& now, const AllocSnapshot& before) {
+    auto& registry = MetricsRegistry::instance();
+    for (size_t i = 0; i < c_allocTagCount; ++i) {
+        MetricLabels labels = {{"subsystem", allocTagName(static_cast<AllocTag>(i))}};
+        auto& stats = now.tags[i];
+        registry.gauge("memory_live_bytes", "Heap bytes live by allocating subsystem", labels).set(stats.liveBytes());
+        registry.gauge("memory_peak_bytes", "Peak heap bytes live by allocating subsystem", labels)
+            .set(static_cast<int64_t>(stats.peakBytes));
+        registry.counter("memory_allocations_total", "Heap allocations by subsystem", labels)
+            .inc(stats.allocations - before.tags[i].allocations);
+        registry.counter("memory_allocated_bytes_total", "Heap bytes allocated by subsystem", labels)
+            .inc(stats.allocatedBytes - before.tags[i].allocatedBytes);
+    }
+    registry.gauge("memory_total_live_bytes", "Heap bytes live").set(now.total.liveBytes());
+    registry.gauge("memory_total_peak_bytes", "Peak heap bytes live").set(static_cast<int64_t>(now.total.peakBytes));
+}
+
+AllocReporter::AllocReporter(std::chrono::milliseconds interval, size_t topSites)
+: m_interval(interval), m_topSites(topSites) {
+    m_thread = std::thread([this] {
+        AllocSnapshot before = AllocTracker::snapshot();
+        AllocTracker::publish(before, AllocSnapshot());
+        UniqueLock l(m_mutex);
+        while (!m_cv.wait_for(l, m_interval, [this] { return m_stop; })) {
+            l.unlock();
+            AllocSnapshot now = AllocTracker::snapshot();
+            AllocTracker::publish(now, before);
+            LOG(Info) << LOG_BADGE("Alloc") << "\n" << AllocTracker::toText(now, &before, AllocTracker::topSites(m_topSites));
+            before = now;
+            l.lock();
+        }
+    });
+}
+
+// 停止后台线程
+AllocReporter::~AllocReporter() {
+    {
+        Guard l(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+}   // namespace dev
+
+#if defined(DEV_ALLOC_TRACKING)
+
+// 替换全局的operator new/delete（按对齐要求分配的版本仍使用标准库的实现，不计入统计）
+void* operator new(size_t size) {
+    return dev::trackedAlloc(size, false);
+}
+
+void* operator new[](size_t size) {
+    return dev::trackedAlloc(size, false);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return dev::trackedAlloc(size, true);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return dev::trackedAlloc(size, true);
+}
+
+void operator delete(void* p) noexcept {
+    dev::trackedFree(p);
+}
+
+void operator delete[](void* p) noexcept {
+    dev::trackedFree(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    dev::trackedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    dev::trackedFree(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* p, size_t) noexcept {
+    dev::trackedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    dev::trackedFree(p);
+}
+#endif
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * 内存分配跟踪（按子系统统计，采样分配位置）
+ * @file: AllocTracker.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Common.h"
+#include "Guards.h"
+
+namespace dev {
+
+/**
+ * 同步时内存超出预算，但是RLPStream::take，SnappyCompress，fromHex，RLP::toBytes等返回的Bytes到处都是，
+ * 看不出内存被谁占用了。
+ * 1. 编译时定义DEV_ALLOC_TRACKING（cmake -DWITH_ALLOC_TRACKING=ON）后替换全局的operator new/delete，
+ *    每块内存前面加16字节的头部，记录长度和分配时所在的子系统，释放时计入同一个子系统
+ * 2. 子系统由当前线程的ALLOC_SCOPE决定（RLP编解码，密码学，压缩，线程池），作用域之外的分配计入other，
+ *    Bytes只是普通的std::vector，在子系统之间传递，所以按分配时的作用域而不是按容器类型来归类
+ * 3. 每个线程每分配c_allocSampleBytes字节采样一次调用栈，按调用栈聚合，找出分配最多的位置
+ * 4. AllocReporter周期性地把统计写到日志和监控指标中（存活字节数，峰值，分配速率，分配最多的位置）
+ * 没有定义DEV_ALLOC_TRACKING时ALLOC_SCOPE展开为空，也不替换全局的operator new，所有统计都为0
+ */
+
+// 子系统
+enum class AllocTag : uint8_t {
+    Other = 0,
+    RLP,
+    Crypto,
+    Compression,
+    Pool
+};
+
+// 子系统个数
+constexpr size_t c_allocTagCount = 5;
+
+// 采样间隔（字节）
+constexpr size_t c_allocSampleBytes = 512 * 1024;
+
+// 采样的调用栈深度
+constexpr size_t c_allocSiteDepth = 6;
+
+// 子系统名称
+const char* allocTagName(AllocTag tag) noexcept;
+
+// 当前线程的子系统
+AllocTag currentAllocTag() noexcept;
+
+// 设置当前线程的子系统，返回之前的子系统
+AllocTag exchangeAllocTag(AllocTag tag) noexcept;
+
+// 一个子系统的统计
+struct AllocTagStats {
+    uint64_t allocations = 0;           // 分配次数
+    uint64_t frees = 0;                 // 释放次数
+    uint64_t allocatedBytes = 0;        // 累计分配的字节数
+    uint64_t freedBytes = 0;            // 累计释放的字节数
+    uint64_t peakBytes = 0;             // 存活字节数的峰值
+
+    // 存活字节数（其它子系统分配、本子系统释放的内存会使单个子系统出现负数）
+    int64_t liveBytes() const noexcept { return static_cast<int64_t>(allocatedBytes - freedBytes); }
+};
+
+// 所有子系统的统计
+struct AllocSnapshot {
+    std::array<AllocTagStats, c_allocTagCount> tags;    // 各个子系统
+    AllocTagStats total;                                // 合计
+    std::chrono::steady_clock::time_point time;         // 快照时间
+};
+
+// 一个分配位置（按采样的调用栈聚合）
+struct AllocSite {
+    std::vector<std::string> frames;    // 调用栈（由内到外）
+    uint64_t samples = 0;               // 采样次数（与分配的字节数成正比）
+    uint64_t bytes = 0;                 // 被采样的分配的字节数之和
+};
+
+// 分配跟踪接口
+class AllocTracker {
+public:
+    // 编译时是否启用
+    static bool enabled() noexcept;
+
+    // 当前统计
+    static AllocSnapshot snapshot() noexcept;
+
+    // 采样次数最多的n个分配位置
+    static std::vector<AllocSite> topSites(size_t n);
+
+    /**
+     * 导出为文本
+     * @param now 当前快照
+     * @param before 之前的快照（用来计算分配速率，可以为空）
+     * @param sites 分配位置
+     */
+    static std::string toText(const AllocSnapshot& now, const AllocSnapshot* before, const std::vector<AllocSite>& sites);
+
+    // 写入全局监控指标（memory_*{subsystem=...}），before为上次写入时的快照
+    static void publish(const AllocSnapshot& now, const AllocSnapshot& before);
+};
+
+// 设置当前线程的子系统（RAII）
+class AllocScope {
+public:
+    explicit AllocScope(AllocTag tag) noexcept : m_previous(exchangeAllocTag(tag)) {}
+    ~AllocScope() { exchangeAllocTag(m_previous); }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocTag m_previous;
+};
+
+// 周期性地输出统计到日志和监控指标（在后台线程中）
+class AllocReporter {
+public:
+    /**
+     * @param interval 输出间隔
+     * @param topSites 日志中输出的分配位置个数
+     */
+    explicit AllocReporter(std::chrono::milliseconds interval, size_t topSites = 5);
+
+    // 停止后台线程
+    ~AllocReporter();
+
+    AllocReporter(const AllocReporter&) = delete;
+    AllocReporter& operator=(const AllocReporter&) = delete;
+
+private:
+    std::chrono::milliseconds m_interval;
+    size_t m_topSites;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+#define ALLOC_CONCAT_IMPL(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_IMPL(a, b)
+
+// 当前作用域内的分配计入子系统tag（AllocTag的枚举值名称）
+#if defined(DEV_ALLOC_TRACKING)
+#define ALLOC_SCOPE(tag) ::dev::AllocScope ALLOC_CONCAT(allocScope, __LINE__)(::dev::AllocTag::tag)
+#else
+#define ALLOC_SCOPE(tag)
+#endif
+
+}   // namespace dev
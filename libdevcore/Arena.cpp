@@ -0,0 +1,136 @@
+/**
+ * 单调增长的内存池（处理区块期间的临时内存一次释放）
+ * @file: Arena.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "Arena.h"
+#include <algorithm>
+
+namespace dev {
+
+// 内存块头部（16字节，数据紧跟在头部之后，保持max_align_t对齐）
+struct alignas(16) Arena::Chunk {
+    Chunk* next;                // 链表中的下一块
+    size_t size;                // 数据长度
+
+    Byte* begin() noexcept { return reinterpret_cast<Byte*>(this + 1); }
+    Byte* end() noexcept { return begin() + size; }
+};
+
+Arena::Arena(size_t initialChunkSize) noexcept : m_nextChunkSize(std::max<size_t>(initialChunkSize, 64)) {}
+
+// 释放所有内存块
+Arena::~Arena() {
+    freeChunks(m_chunks);
+    freeChunks(m_large);
+    freeChunks(m_spare);
+}
+
+// 当前内存块不够时分配新的内存块
+void* Arena::allocateSlow(size_t size, size_t align) {
+    // 最坏情况下对齐需要align - 1字节的填充
+    if (size > std::numeric_limits<size_t>::max() - align - sizeof(Chunk)) {
+        throw std::bad_alloc();
+    }
+    size_t need = size + align - 1;
+
+    if (need > c_maxChunkSize) {
+        // 大对象单独分配，不影响当前内存块的剩余空间
+        Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + need));
+        chunk->size = need;
+        chunk->next = m_large;
+        m_large = chunk;
+        m_capacity += need;
+        m_used += size;
+        uintptr_t p = (reinterpret_cast<uintptr_t>(chunk->begin()) + align - 1) & ~(uintptr_t(align) - 1);
+        return reinterpret_cast<void*>(p);
+    }
+
+    // 当前内存块的剩余空间直接丢弃
+    Chunk* chunk = newChunk(need);
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+    m_ptr = chunk->begin();
+    m_end = chunk->end();
+    return allocate(size, align);
+}
+
+// 释放marker之后分配的内存
+void Arena::rewind(const Marker& marker) noexcept {
+    while (m_large != marker.large) {
+        Chunk* chunk = m_large;
+        m_large = chunk->next;
+        m_capacity -= chunk->size;
+        ::operator delete(chunk);
+    }
+
+    // marker之后的内存块放入保留链表，超出上限的还给系统
+    while (m_chunks != marker.chunk) {
+        Chunk* chunk = m_chunks;
+        m_chunks = chunk->next;
+        if (m_spareSize + chunk->size <= c_maxSpareSize) {
+            chunk->next = m_spare;
+            m_spare = chunk;
+            m_spareSize += chunk->size;
+        } else {
+            m_capacity -= chunk->size;
+            ::operator delete(chunk);
+        }
+    }
+
+    m_ptr = marker.ptr;
+    m_end = m_chunks ? m_chunks->end() : nullptr;
+    m_used = marker.used;
+}
+
+// 新的内存块（优先复用保留的内存块）
+Arena::Chunk* Arena::newChunk(size_t size) {
+    for (Chunk** link = &m_spare; *link; link = &(*link)->next) {
+        if ((*link)->size >= size) {
+            Chunk* chunk = *link;
+            *link = chunk->next;
+            m_spareSize -= chunk->size;
+            return chunk;
+        }
+    }
+
+    size_t chunkSize = std::max(m_nextChunkSize, size);
+    m_nextChunkSize = std::min(m_nextChunkSize * 2, c_maxChunkSize);
+    Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + chunkSize));
+    chunk->size = chunkSize;
+    m_capacity += chunkSize;
+    return chunk;
+}
+
+// 释放内存块链表
+void Arena::freeChunks(Chunk* chunk) noexcept {
+    while (chunk) {
+        Chunk* next = chunk->next;
+        ::operator delete(chunk);
+        chunk = next;
+    }
+}
+
+// 当前线程的Arena
+Arena& threadArena() {
+    static thread_local Arena t_arena;
+    return t_arena;
+}
+
+// 当前线程安装的Arena
+static thread_local Arena* t_currentArena = nullptr;
+
+ArenaScope::ArenaScope(Arena& arena) noexcept : m_previous(t_currentArena) {
+    t_currentArena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+    t_currentArena = m_previous;
+}
+
+Arena* ArenaScope::current() noexcept {
+    return t_currentArena;
+}
+
+}   // namespace dev
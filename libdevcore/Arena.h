@@ -0,0 +1,209 @@
+/**
+ * 单调增长的内存池（处理区块期间的临时内存一次释放）
+ * @file: Arena.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+#include "Common.h"
+
+namespace dev {
+
+/**
+ * 处理一个区块会创建成千上万个短生命周期的Bytes，std::vector<RLP>，std::string，区块处理完后一起销毁，
+ * 多个工作线程同时频繁地malloc/free会争用分配器的锁，长时间运行后还会产生内存碎片。
+ * 1. Arena从大块内存中顺序切分，分配只是移动指针，单个对象的释放什么都不做，reset()一次释放所有内存，
+ *    内存块保留下来供下次使用，稳定运行后不再向系统分配内存；超过1MB的对象单独分配一块内存
+ * 2. Arena不是线程安全的，每个线程使用自己的Arena（threadArena()），线程之间没有争用
+ * 3. ArenaAllocator是标准库兼容的分配器，默认构造时使用当前线程ArenaScope安装的Arena，
+ *    没有安装时退化为operator new/delete，所以ArenaBytes等类型在作用域外也可以正常使用
+ * 4. BlockArenaScope在当前线程的Arena上开启一个作用域，结束时释放作用域内分配的所有内存（支持嵌套）
+ * 注意：从Arena分配的对象不能活过它所在的作用域，需要保留的结果要复制到普通的Bytes中
+ * 与std::pmr::monotonic_buffer_resource相比，分配路径是内联的，也不需要经过虚函数
+ */
+class Arena {
+public:
+    // 第一块内存的默认长度
+    static constexpr size_t c_defaultChunkSize = 64 * 1024;
+
+    // 按倍数增长的内存块的最大长度（超过的分配单独使用一块内存）
+    static constexpr size_t c_maxChunkSize = 1024 * 1024;
+
+    // 回退后保留供复用的内存块的最大总长度（超出的还给系统）
+    static constexpr size_t c_maxSpareSize = 4 * c_maxChunkSize;
+
+    // 作用域起点（由mark()返回，rewind()回退到这里）
+    struct Marker {
+        const void* chunk;      // 当时正在使用的内存块
+        Byte* ptr;              // 当时的分配位置
+        const void* large;      // 当时最新的单独分配的内存块
+        size_t used;            // 当时已经分配的字节数
+    };
+
+    explicit Arena(size_t initialChunkSize = c_defaultChunkSize) noexcept;
+
+    // 释放所有内存块
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * 分配内存
+     * @param size 字节数
+     * @param align 对齐要求（2的幂）
+     * @throw 内存不足抛出std::bad_alloc异常
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(m_ptr) + align - 1) & ~(uintptr_t(align) - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(m_end);
+        if (m_ptr && p <= end && end - p >= size) {
+            m_used += p + size - reinterpret_cast<uintptr_t>(m_ptr);
+            m_ptr = reinterpret_cast<Byte*>(p + size);
+            return reinterpret_cast<void*>(p);
+        }
+        return allocateSlow(size, align);
+    }
+
+    // 释放所有分配的内存（内存块保留供复用，总长度不超过c_maxSpareSize）
+    void reset() noexcept { rewind(Marker{nullptr, nullptr, nullptr, 0}); }
+
+    // 当前分配位置
+    Marker mark() const noexcept { return Marker{m_chunks, m_ptr, m_large, m_used}; }
+
+    // 释放marker之后分配的内存（marker之后的内存块保留供复用）
+    void rewind(const Marker& marker) noexcept;
+
+    // 上次reset()之后分配的字节数（包括对齐的填充）
+    size_t used() const noexcept { return m_used; }
+
+    // 持有的内存块的总长度
+    size_t capacity() const noexcept { return m_capacity; }
+
+private:
+    struct Chunk;
+
+    // 当前内存块不够时分配新的内存块
+    void* allocateSlow(size_t size, size_t align);
+
+    // 新的内存块（优先复用保留的内存块）
+    Chunk* newChunk(size_t size);
+
+    // 释放内存块链表
+    void freeChunks(Chunk* chunk) noexcept;
+
+    Chunk* m_chunks = nullptr;          // 按倍数增长的内存块链表（最新的在前）
+    Chunk* m_large = nullptr;           // 单独分配的内存块链表（最新的在前）
+    Chunk* m_spare = nullptr;           // 保留供复用的内存块链表
+    size_t m_spareSize = 0;             // 保留供复用的内存块的总长度
+    Byte* m_ptr = nullptr;              // 当前内存块中的分配位置
+    Byte* m_end = nullptr;              // 当前内存块的结束位置
+    size_t m_nextChunkSize;             // 下一块内存的长度
+    size_t m_used = 0;                  // 已经分配的字节数
+    size_t m_capacity = 0;              // 持有的内存块的总长度
+};
+
+// 当前线程的Arena（线程退出时释放）
+Arena& threadArena();
+
+// 在当前线程上安装Arena，之后默认构造的ArenaAllocator都使用它（RAII，支持嵌套）
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) noexcept;
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    // 当前线程安装的Arena（没有时返回nullptr）
+    static Arena* current() noexcept;
+
+private:
+    Arena* m_previous;
+};
+
+// 处理一个区块期间的临时内存：在当前线程的Arena上开启作用域，结束时释放作用域内分配的所有内存
+class BlockArenaScope {
+public:
+    BlockArenaScope() noexcept : m_arena(threadArena()), m_marker(m_arena.mark()), m_scope(m_arena) {}
+    ~BlockArenaScope() { m_arena.rewind(m_marker); }
+
+    BlockArenaScope(const BlockArenaScope&) = delete;
+    BlockArenaScope& operator=(const BlockArenaScope&) = delete;
+
+    Arena& arena() noexcept { return m_arena; }
+
+private:
+    Arena& m_arena;
+    Arena::Marker m_marker;
+    ArenaScope m_scope;
+};
+
+/**
+ * 标准库兼容的分配器（没有Arena时使用operator new/delete）
+ * 与std::pmr::polymorphic_allocator一样，赋值和交换时分配器不随内容转移，
+ * 复制构造时使用当前线程安装的Arena，所以在作用域外复制一个容器就能把结果保留下来
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    // 使用当前线程安装的Arena
+    ArenaAllocator() noexcept : m_arena(ArenaScope::current()) {}
+
+    ArenaAllocator(Arena& arena) noexcept : m_arena(&arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if (m_arena) {
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        if (!m_arena) {
+            ::operator delete(p);
+        }
+    }
+
+    // 复制容器时使用当前线程安装的Arena
+    ArenaAllocator select_on_container_copy_construction() const noexcept { return ArenaAllocator(); }
+
+    // 使用的Arena（nullptr表示operator new/delete）
+    Arena* arena() const noexcept { return m_arena; }
+
+private:
+    Arena* m_arena;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() == b.arena(); }
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) noexcept { return a.arena() != b.arena(); }
+
+// 从Arena分配的字节数组
+using ArenaBytes = std::vector<Byte, ArenaAllocator<Byte>>;
+
+// 从Arena分配的字符串
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// 从Arena分配的数组
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}   // namespace dev
@@ -130,7 +130,7 @@ static std::string base64Encode(BytesConstRef src, const char* encodeMap, char p
     return dst;
 }
 
-static Bytes base64Decode(const std::string& src, const Byte* decodeMap, char paddingCh) {
+static Bytes base64Decode(std::string_view src, const Byte* decodeMap, char paddingCh) {
     // 提前分配内存
     size_t len = src.size();
     Bytes dst((len + 3) / 4 * 3);
@@ -226,7 +226,7 @@ std::string toBase64URL(BytesConstRef src) {
  * @return 对应的字节数组
  * @throw 遇到非法Base64字符抛出BadBase64Ch异常
  */
-Bytes fromBase64Std(const std::string& src) {
+Bytes fromBase64Std(std::string_view src) {
     // assert(checkDecodeMap(s_encodeMapStd, s_decodeMapStd));
 
     return base64Decode(src, s_decodeMapStd, s_paddingChStd);
@@ -238,7 +238,7 @@ Bytes fromBase64Std(const std::string& src) {
  * @return 对应的字节数组
  * @throw 遇到非法Base64字符抛出BadBase64Ch异常
  */
-Bytes fromBase64URL(const std::string& src) {
+Bytes fromBase64URL(std::string_view src) {
     // assert(checkDecodeMap(s_encodeMapURL, s_decodeMapURL));
 
     return base64Decode(src, s_decodeMapURL, s_paddingChURL);
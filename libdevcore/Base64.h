@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <string_view>
 #include "Common.h"
 
 namespace dev {
@@ -22,7 +23,7 @@ std::string toBase64URL(BytesConstRef src);
  * @return 对应的字节数组
  * @throw 遇到非法Base64字符抛出BadBase64Ch异常
  */
-Bytes fromBase64Std(const std::string& src);
+Bytes fromBase64Std(std::string_view src);
 
 /**
  * 将Base64编码的字符串转换为字节数组
@@ -30,6 +31,6 @@ Bytes fromBase64Std(const std::string& src);
  * @return 对应的字节数组
  * @throw 遇到非法Base64字符抛出BadBase64Ch异常
  */
-Bytes fromBase64URL(const std::string& src);
+Bytes fromBase64URL(std::string_view src);
 
 }   // namespace dev
\ No newline at end of file
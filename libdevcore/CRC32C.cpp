@@ -0,0 +1,86 @@
+/**
+ * CRC32C校验和（Castagnoli多项式）
+ * @file: CRC32C.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "CRC32C.h"
+#include <cstring>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace dev {
+
+#if defined(__SSE4_2__)
+
+// 计算CRC32C（SSE4.2硬件指令）
+uint32_t crc32c(BytesConstRef data, uint32_t crc) noexcept {
+    const Byte* p = data.data();
+    size_t n = data.size();
+    uint64_t c = ~crc;
+    while (n >= 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        n -= 8;
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    while (n-- > 0) {
+        c32 = _mm_crc32_u8(c32, *p++);
+    }
+    return ~c32;
+}
+
+#else
+
+// slicing-by-8查表（第k张表对应后面还有k个字节时的贡献）
+struct CRC32CTable {
+    uint32_t t[8][256];
+
+    CRC32CTable() noexcept {
+        // 反射形式的Castagnoli多项式
+        const uint32_t poly = 0x82f63b78;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c >> 1) ^ ((c & 1) ? poly : 0);
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+            }
+        }
+    }
+};
+
+static const CRC32CTable& crc32cTable() noexcept {
+    static const CRC32CTable s_table;
+    return s_table;
+}
+
+// 计算CRC32C（slicing-by-8查表）
+uint32_t crc32c(BytesConstRef data, uint32_t crc) noexcept {
+    auto& t = crc32cTable().t;
+    const Byte* p = data.data();
+    size_t n = data.size();
+    uint32_t c = ~crc;
+    while (n >= 8) {
+        uint32_t lo = c ^ (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24));
+        c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        n -= 8;
+    }
+    while (n-- > 0) {
+        c = (c >> 8) ^ t[0][(c ^ *p++) & 0xff];
+    }
+    return ~c;
+}
+
+#endif
+
+}   // namespace dev
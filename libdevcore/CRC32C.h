@@ -0,0 +1,23 @@
+/**
+ * CRC32C校验和（Castagnoli多项式）
+ * @file: CRC32C.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <cstdint>
+#include "Common.h"
+
+namespace dev {
+
+/**
+ * CRC32C的检错能力比CRC32更好，并且x86的SSE4.2有专门的crc32指令（每周期8字节），
+ * 编译时启用了SSE4.2（-msse4.2或-march=native）时使用硬件指令，否则用slicing-by-8查表实现
+ * @param data 数据
+ * @param crc 之前数据的CRC32C（分段计算时传入上一段的结果）
+ * @return 包含data在内的所有数据的CRC32C
+ */
+uint32_t crc32c(BytesConstRef data, uint32_t crc = 0) noexcept;
+
+}   // namespace dev
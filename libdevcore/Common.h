@@ -19,6 +19,17 @@
 #include "vector_ref.h"
 #include "Exceptions.h"
 
+// 热点函数按CPU特性生成多个版本，运行时根据CPU选择（cmake -DWITH_MULTIVERSIONING=ON，依赖glibc的ifunc）
+// 注意：多版本函数中不能抛出异常（GCC无法展开经过多版本函数的异常，会直接terminate）
+#if defined(DEV_MULTIVERSIONING) && defined(__x86_64__) && defined(__linux__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define DEV_TARGET_CLONES __attribute__((target_clones("arch=x86-64-v3", "default")))
+#endif
+#endif
+#if !defined(DEV_TARGET_CLONES)
+#define DEV_TARGET_CLONES
+#endif
+
 namespace dev {
 
 //------------------------------------类型定义------------------------------------//
@@ -151,6 +162,12 @@ public:
         return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
     }
 
+    // 流逝的时间（ns，用于测量微秒级的操作）
+    uint64_t elapsedNs() const noexcept {
+        auto duration = std::chrono::steady_clock::now() - m_start;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
     // 重新开始计时
     void restart() noexcept { m_start = std::chrono::steady_clock::now(); }
 
@@ -42,4 +42,14 @@ DEV_DERIVE_EXCEPTION(BadRLP, RLPExcept);
 DEV_DERIVE_EXCEPTION(RLPBadCast, RLPExcept);
 DEV_DERIVE_EXCEPTION(RLPUnsupportedCast, RLPExcept);
 
+// 存储异常
+DEV_SIMPLE_EXCEPTION(StorageExcept);
+DEV_DERIVE_EXCEPTION(StorageIOError, StorageExcept);
+DEV_DERIVE_EXCEPTION(StorageCorrupted, StorageExcept);
+
+// 监控指标异常
+DEV_SIMPLE_EXCEPTION(MetricsExcept);
+DEV_DERIVE_EXCEPTION(BadMetric, MetricsExcept);
+DEV_DERIVE_EXCEPTION(MetricsIOError, MetricsExcept);
+
 }   // namespace dev
\ No newline at end of file
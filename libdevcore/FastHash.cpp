@@ -0,0 +1,22 @@
+/**
+ * 非加密哈希函数（用于哈希表）
+ * @file: FastHash.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "FastHash.h"
+#include "SecureRandom.h"
+
+namespace dev {
+
+// 从操作系统获取64位种子
+static uint64_t generateHashSeed() {
+    uint64_t seed;
+    osRandom(BytesRef(reinterpret_cast<Byte*>(&seed), sizeof(seed)));
+    return seed;
+}
+
+// 进程级随机哈希种子（进程启动时生成，静态初始化阶段不要使用）
+const uint64_t c_hashSeed = generateHashSeed();
+
+}   // namespace dev
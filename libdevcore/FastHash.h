@@ -0,0 +1,138 @@
+/**
+ * 非加密哈希函数（用于哈希表）
+ * @file: FastHash.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "Common.h"
+
+namespace dev {
+
+/**
+ * 哈希表中的键大多是keccak256等密码学哈希的输出（交易哈希，账户地址等），本身已经均匀分布，
+ * 对这类键每16字节和随机种子混合一次即可（H256只需要两次乘法），不需要通用哈希函数的多轮处理，
+ * 但键的每个字（word）都要参与混合，否则攻击者可以构造只在未读取的字节上不同的键，在任何种子下都碰撞。
+ * 对于分布不均匀的键（比如布隆过滤器，大量前导0的数值），使用wyhash风格的通用哈希函数。
+ * 种子在进程启动时随机生成，防止攻击者构造大量碰撞的键来退化哈希表（hash flooding）。
+ */
+
+// 进程级随机哈希种子（进程启动时生成，静态初始化阶段不要使用）
+extern const uint64_t c_hashSeed;
+
+// wyhash使用的常量
+constexpr uint64_t c_hashSecret0 = 0xa0761d6478bd642full;
+constexpr uint64_t c_hashSecret1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t c_hashSecret2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t c_hashSecret3 = 0x589965cc75374cc3ull;
+
+// 读取8字节（小端序，允许不对齐）
+inline uint64_t hashRead64(const Byte* p) noexcept {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 读取4字节（小端序，允许不对齐）
+inline uint64_t hashRead32(const Byte* p) noexcept {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 64位乘法得到128位结果，再将高低64位异或，是wyhash的核心混合函数
+inline uint64_t hashMix(uint64_t a, uint64_t b) noexcept {
+    __uint128_t r = a;
+    r *= b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+/**
+ * 通用非加密哈希函数（wyhash风格），适合分布不均匀的键
+ * @param data 数据起始地址
+ * @param len 数据长度
+ * @param seed 哈希种子
+ * @return 64位哈希值
+ */
+inline uint64_t fastHash(const Byte* data, size_t len, uint64_t seed) noexcept {
+    const Byte* p = data;
+    seed ^= hashMix(seed ^ c_hashSecret0, c_hashSecret1);
+
+    uint64_t a, b;
+    if (len <= 16) {
+        if (len >= 4) {
+            // 4-16字节，用两次（可能重叠的）4字节读取覆盖所有数据
+            size_t off = (len >> 3) << 2;
+            a = (hashRead32(p) << 32) | hashRead32(p + off);
+            b = (hashRead32(p + len - 4) << 32) | hashRead32(p + len - 4 - off);
+        } else if (len > 0) {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            // 三路并行处理，提高指令级并行度
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = hashMix(hashRead64(p) ^ c_hashSecret1, hashRead64(p + 8) ^ seed);
+                see1 = hashMix(hashRead64(p + 16) ^ c_hashSecret2, hashRead64(p + 24) ^ see1);
+                see2 = hashMix(hashRead64(p + 32) ^ c_hashSecret3, hashRead64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = hashMix(hashRead64(p) ^ c_hashSecret1, hashRead64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        // 最后16字节（可能和前面重叠）
+        a = hashRead64(p + i - 16);
+        b = hashRead64(p + i - 8);
+    }
+
+    a ^= c_hashSecret1;
+    b ^= seed;
+    __uint128_t r = a;
+    r *= b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+    return hashMix(a ^ c_hashSecret0 ^ len, b ^ c_hashSecret1);
+}
+
+// 通用非加密哈希函数（使用进程级随机种子）
+inline uint64_t fastHash(BytesConstRef data) noexcept {
+    return fastHash(data.data(), data.size(), c_hashSeed);
+}
+
+/**
+ * 针对已经均匀分布的键（密码学哈希的输出）的哈希函数，每次混合16字节，覆盖所有字节（末尾的读取可以重叠）
+ * 混合的两个操作数都与依赖种子的中间状态异或，攻击者不知道种子就无法构造使乘积为0的字
+ * @param data 数据起始地址
+ * @param len 数据长度（不能小于8）
+ * @param seed 哈希种子
+ * @return 64位哈希值
+ */
+inline uint64_t uniformHash(const Byte* data, size_t len, uint64_t seed) noexcept {
+    uint64_t h = seed;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        h = hashMix(hashRead64(data + i) ^ h, hashRead64(data + i + 8) ^ h ^ c_hashSecret1);
+    }
+    if (i < len) {
+        // 剩余不足16字节（例如H160的最后4字节），最后一个字与前面的数据重叠
+        uint64_t a = len - i > 8 ? hashRead64(data + i) : 0;
+        h = hashMix(a ^ h, hashRead64(data + len - 8) ^ h ^ c_hashSecret1);
+    }
+    return h;
+}
+
+}   // namespace dev
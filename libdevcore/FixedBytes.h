@@ -13,17 +13,16 @@
 #include <array>
 #include <vector>
 #include <string>
-#include <random>
+#include <string_view>
 #include <cstring>
-#include <boost/functional/hash.hpp>
 #include "Common.h"
 #include "Hex.h"
+#include "SmallBytes.h"
+#include "FastHash.h"
+#include "SecureRandom.h"
 
 namespace dev {
 
-// 真随机数生成引擎，linux上通过读取/dev/urandom设备实现
-extern thread_local std::random_device t_randomEngine;
-
 // 对齐选项
 struct Align {
     static constexpr unsigned c_right = 0;
@@ -83,11 +82,20 @@ public:
         }
     }
 
-    // 通过16进制字符串构造
+    // 通过16进制字符串构造（长度正好为N字节时直接解码到m_data，否则经过SmallBytes，都不分配堆内存）
+    FixedBytes(std::string_view hexStr, unsigned align = Align::c_failIfTooSmall | Align::c_failIfTooBig) {
+        if (N == hexDecodedSize(hexStr)) {
+            fromHex(hexStr, ref());
+        } else {
+            SmallBytes bs;
+            fromHex(hexStr, bs);
+            *this = FixedBytes(bs.ref(), align);
+        }
+    }
     FixedBytes(const std::string& hexStr, unsigned align = Align::c_failIfTooSmall | Align::c_failIfTooBig)
-    : FixedBytes(fromHex(hexStr), align) {}
+    : FixedBytes(std::string_view(hexStr), align) {}
     FixedBytes(const char* hexStr, unsigned align = Align::c_failIfTooSmall | Align::c_failIfTooBig)
-    : FixedBytes(fromHex(hexStr), align) {}
+    : FixedBytes(std::string_view(hexStr), align) {}
 
     // 通过算术类型构造
     explicit FixedBytes(const Arith& arith) noexcept { toBigEndian(arith, m_data); }
@@ -118,12 +126,15 @@ public:
     FixedBytes& operator^=(const FixedBytes& c) noexcept { for (size_t i = 0; i < N; ++i) m_data[i] ^= c.m_data[i]; return *this; }
     FixedBytes operator^(const FixedBytes& c) const noexcept { return FixedBytes(*this) ^= c; }
 
-    // 求定长的哈希值，用于存放到基于hash table的标准容器中（std::unordered_xxx）
-    // 标准库并没有为自定义类型提供哈希函数，这里引用boost中的哈希函数，散列性比较好
+    // 求定长字节数组的哈希值，用于存放到基于hash table的标准容器中（std::unordered_xxx）
+    // 默认使用通用哈希函数，对于密码学哈希输出的类型（H160/H256/H512）特化为每16字节混合一次的uniformHash，见下方特化
     struct hash {
-        size_t operator()(const FixedBytes& value) const {
-            return boost::hash_range(value.begin(), value.end());
+        hash() noexcept : m_seed(c_hashSeed) {}
+        explicit hash(uint64_t seed) noexcept : m_seed(seed) {}
+        size_t operator()(const FixedBytes& value) const noexcept {
+            return fastHash(value.data(), N, m_seed);
         }
+        uint64_t m_seed;
     };
 
     // 获取指针
@@ -151,13 +162,9 @@ public:
     // 将该定长字节数组转换为缩减版的16进制字符串（小写，不带前缀0x，最多只显示前8个字符）
     std::string abridged() const { return toHex(ref().cropped(0, 4)) + "..."; }
 
-    // 用真随机数填充每一个字节
-    FixedBytes& randomize() {
-        // 0-255均匀分布
-        std::uniform_int_distribution<int> dis(0, 255);
-        for (auto& b : m_data) {
-            b = dis(t_randomEngine);
-        }
+    // 用密码学安全的随机数填充（可以用于生成私钥）
+    FixedBytes& randomize() noexcept {
+        secureRandom(m_data);
         return *this;
     }
 
@@ -196,25 +203,19 @@ inline bool H256::operator==(const H256& rhs) const noexcept {
 }
 
 // 优化hash运算性能
+// 地址，交易哈希，公钥都是均匀分布的，每16字节和种子混合一次即可（所有字节都参与混合）
+// H2048（布隆过滤器）大部分位为0，使用通用哈希函数
 template <>
-inline size_t H160::hash::operator()(const H160& value) const {
-    auto data = reinterpret_cast<const uint32_t*>(value.data());
-    return boost::hash_range(data, data + 5);
-}
-template <>
-inline size_t H256::hash::operator()(const H256& value) const {
-    auto data = reinterpret_cast<const uint64_t*>(value.data());
-    return boost::hash_range(data, data + 4);
+inline size_t H160::hash::operator()(const H160& value) const noexcept {
+    return uniformHash(value.data(), 20, m_seed);
 }
 template <>
-inline size_t H512::hash::operator()(const H512& value) const {
-    auto data = reinterpret_cast<const uint64_t*>(value.data());
-    return boost::hash_range(data, data + 8);
+inline size_t H256::hash::operator()(const H256& value) const noexcept {
+    return uniformHash(value.data(), 32, m_seed);
 }
 template <>
-inline size_t H2048::hash::operator()(const H2048& value) const {
-    auto data = reinterpret_cast<const uint64_t*>(value.data());
-    return boost::hash_range(data, data + 32);
+inline size_t H512::hash::operator()(const H512& value) const noexcept {
+    return uniformHash(value.data(), 64, m_seed);
 }
 
 // Stream I/O for the FixedBytes<N> class.
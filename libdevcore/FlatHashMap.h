@@ -0,0 +1,675 @@
+/**
+ * 开放寻址哈希表（Swiss table风格），专门用于以定长字节数组（H160，H256）为键的场景
+ * @file: FlatHashMap.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <array>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "Common.h"
+#include "FixedBytes.h"
+#include "Guards.h"
+
+namespace dev {
+
+/**
+ * std::unordered_map每个元素单独分配一个节点，查找时需要多次指针跳转，内存开销也比较大
+ * Swiss table将所有元素平铺存放在一个数组中（开放寻址），并为每个槽位额外维护一个控制字节：
+ * - 最高位为1：表示槽位为空（c_ctrlEmpty）或已删除（c_ctrlDeleted）
+ * - 最高位为0：表示槽位已被占用，低7位存放哈希值的低7位（H2）
+ * 查找时用哈希值的剩余部分（H1）定位到一组（16个）控制字节，通过SIMD指令一次比较16个控制字节，
+ * 只有H2匹配的槽位才需要真正比较键，绝大多数查找只需要访问一个缓存行的控制字节和一个槽位。
+ */
+
+// 控制字节
+using CtrlByte = int8_t;
+constexpr CtrlByte c_ctrlEmpty = -128;      // 空槽位
+constexpr CtrlByte c_ctrlDeleted = -2;      // 已删除的槽位（墓碑）
+constexpr size_t c_ctrlGroupWidth = 16;     // 一次探测的控制字节数
+
+// 一组控制字节，匹配结果以位掩码返回（第i位为1表示第i个控制字节匹配）
+class CtrlGroup {
+public:
+    explicit CtrlGroup(const CtrlByte* pos) noexcept
+#if defined(__SSE2__)
+    : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+#else
+    : m_ctrl(pos) {}
+#endif
+
+#if defined(__SSE2__)
+    // 匹配指定的控制字节
+    uint32_t match(CtrlByte h) const noexcept {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), m_ctrl)));
+    }
+
+    // 匹配空槽位或已删除的槽位（最高位为1）
+    uint32_t matchEmptyOrDeleted() const noexcept {
+        return static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl));
+    }
+#else
+    // 匹配指定的控制字节
+    uint32_t match(CtrlByte h) const noexcept {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < c_ctrlGroupWidth; ++i) {
+            mask |= static_cast<uint32_t>(m_ctrl[i] == h) << i;
+        }
+        return mask;
+    }
+
+    // 匹配空槽位或已删除的槽位（最高位为1）
+    uint32_t matchEmptyOrDeleted() const noexcept {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < c_ctrlGroupWidth; ++i) {
+            mask |= static_cast<uint32_t>(m_ctrl[i] < 0) << i;
+        }
+        return mask;
+    }
+#endif
+
+    // 匹配空槽位
+    uint32_t matchEmpty() const noexcept { return match(c_ctrlEmpty); }
+
+private:
+#if defined(__SSE2__)
+    __m128i m_ctrl;
+#else
+    const CtrlByte* m_ctrl;
+#endif
+};
+
+/**
+ * 开放寻址哈希表的通用实现，FlatHashMap和FlatHashSet的公共基类
+ * @tparam Policy 描述槽位类型以及如何从槽位中取出键
+ * @tparam Hash 哈希函数
+ */
+template <typename Policy, typename Hash>
+class FlatHashTable {
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using hasher = Hash;
+    using size_type = size_t;
+
+    // 迭代器（单向）
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+        using reference = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+        Iterator() = default;
+        Iterator(const CtrlByte* ctrl, const CtrlByte* ctrlEnd, pointer slot) noexcept
+        : m_ctrl(ctrl), m_ctrlEnd(ctrlEnd), m_slot(slot) { skipEmpty(); }
+
+        // 非常量迭代器可以转换为常量迭代器
+        template <bool C = IsConst, typename std::enable_if<C, int>::type = 0>
+        Iterator(const Iterator<false>& it) noexcept : m_ctrl(it.m_ctrl), m_ctrlEnd(it.m_ctrlEnd), m_slot(it.m_slot) {}
+
+        reference operator*() const noexcept { return *m_slot; }
+        pointer operator->() const noexcept { return m_slot; }
+
+        Iterator& operator++() noexcept { ++m_ctrl; ++m_slot; skipEmpty(); return *this; }
+        Iterator operator++(int) noexcept { Iterator ret = *this; ++*this; return ret; }
+
+        bool operator==(const Iterator& rhs) const noexcept { return m_ctrl == rhs.m_ctrl; }
+        bool operator!=(const Iterator& rhs) const noexcept { return m_ctrl != rhs.m_ctrl; }
+
+    private:
+        template <typename, typename> friend class FlatHashTable;
+        template <bool> friend class Iterator;
+
+        // 跳过空槽位和已删除的槽位
+        void skipEmpty() noexcept {
+            while (m_ctrl != m_ctrlEnd && *m_ctrl < 0) {
+                ++m_ctrl;
+                ++m_slot;
+            }
+        }
+
+        const CtrlByte* m_ctrl = nullptr;
+        const CtrlByte* m_ctrlEnd = nullptr;
+        pointer m_slot = nullptr;
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // 构造空哈希表（不分配内存）
+    FlatHashTable() = default;
+    explicit FlatHashTable(size_t n, const Hash& hash = Hash()) : m_hash(hash) { reserve(n); }
+
+    // 拷贝构造/赋值
+    FlatHashTable(const FlatHashTable& other) : m_hash(other.m_hash) {
+        reserve(other.m_size);
+        for (const auto& slot : other) {
+            insertUnique(slot);
+        }
+    }
+    FlatHashTable& operator=(const FlatHashTable& other) {
+        if (this != &other) {
+            FlatHashTable tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 移动构造/赋值
+    FlatHashTable(FlatHashTable&& other) noexcept { swap(other); }
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept { swap(other); return *this; }
+
+    ~FlatHashTable() { destroy(); }
+
+    // 交换两个哈希表
+    void swap(FlatHashTable& other) noexcept {
+        std::swap(m_ctrl, other.m_ctrl);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growthLeft, other.m_growthLeft);
+        std::swap(m_hash, other.m_hash);
+    }
+
+    // 元素个数
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return 0 == m_size; }
+
+    // 槽位个数
+    size_t capacity() const noexcept { return m_capacity; }
+
+    // 获取迭代器
+    iterator begin() noexcept { return iterator(m_ctrl, m_ctrl + m_capacity, m_slots); }
+    iterator end() noexcept { return iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+    const_iterator begin() const noexcept { return const_iterator(m_ctrl, m_ctrl + m_capacity, m_slots); }
+    const_iterator end() const noexcept { return const_iterator(m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity); }
+
+    // 清空所有元素（保留已分配的内存）
+    void clear() noexcept {
+        if (0 == m_capacity) {
+            return;
+        }
+        destroySlots();
+        std::fill(m_ctrl, m_ctrl + m_capacity + c_ctrlGroupWidth, c_ctrlEmpty);
+        m_size = 0;
+        m_growthLeft = capacityToGrowth(m_capacity);
+    }
+
+    // 预留至少能存放n个元素的空间
+    void reserve(size_t n) {
+        if (n > m_size + m_growthLeft || (n > 0 && 0 == m_capacity)) {
+            rehash(growthToCapacity(n));
+        }
+    }
+
+    // 重建哈希表，槽位个数至少为n（同时会清理掉所有墓碑）
+    void rehash(size_t n) {
+        size_t newCap = std::max(n, growthToCapacity(m_size));
+        resize(normalizeCapacity(newCap));
+    }
+
+    // 查找元素
+    iterator find(const key_type& key) noexcept {
+        size_t idx = findIndex(key, m_hash(key));
+        return idx == c_npos ? end() : iteratorAt(idx);
+    }
+    const_iterator find(const key_type& key) const noexcept {
+        size_t idx = findIndex(key, m_hash(key));
+        return idx == c_npos ? end() : const_iterator(iteratorAt(idx));
+    }
+
+    // 异构查找：直接用字节数组查找，长度不等于键长度时查找失败
+    iterator find(BytesConstRef key) noexcept {
+        return key.size() == c_keySize ? find(key_type(key)) : end();
+    }
+    const_iterator find(BytesConstRef key) const noexcept {
+        return key.size() == c_keySize ? find(key_type(key)) : end();
+    }
+
+    // 判断元素是否存在
+    size_t count(const key_type& key) const noexcept { return find(key) != end() ? 1 : 0; }
+    size_t count(BytesConstRef key) const noexcept { return find(key) != end() ? 1 : 0; }
+    bool contains(const key_type& key) const noexcept { return find(key) != end(); }
+    bool contains(BytesConstRef key) const noexcept { return find(key) != end(); }
+
+    // 删除元素，返回删除的个数
+    size_t erase(const key_type& key) {
+        size_t idx = findIndex(key, m_hash(key));
+        if (idx == c_npos) {
+            return 0;
+        }
+        eraseAt(idx);
+        return 1;
+    }
+
+    // 删除迭代器指向的元素
+    void erase(const_iterator it) { eraseAt(static_cast<size_t>(it.m_ctrl - m_ctrl)); }
+    void erase(iterator it) { eraseAt(static_cast<size_t>(it.m_ctrl - m_ctrl)); }
+
+protected:
+    // 键的长度
+    static constexpr size_t c_keySize = sizeof(key_type);
+
+    // 表示不存在的下标
+    static constexpr size_t c_npos = static_cast<size_t>(-1);
+
+    // 最大负载因子为7/8
+    static size_t capacityToGrowth(size_t cap) noexcept { return cap - cap / 8; }
+    static size_t growthToCapacity(size_t growth) noexcept { return growth + (growth + 6) / 7; }
+
+    // 槽位个数为2的幂，并且不小于一组控制字节的长度
+    static size_t normalizeCapacity(size_t n) noexcept {
+        size_t cap = c_ctrlGroupWidth;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    // 哈希值拆分为H1（定位探测起点）和H2（存放在控制字节中）
+    static size_t H1(size_t hash) noexcept { return hash >> 7; }
+    static CtrlByte H2(size_t hash) noexcept { return static_cast<CtrlByte>(hash & 0x7f); }
+
+    // 根据下标构造迭代器
+    iterator iteratorAt(size_t idx) noexcept { return iterator(m_ctrl + idx, m_ctrl + m_capacity, m_slots + idx); }
+    const_iterator iteratorAt(size_t idx) const noexcept {
+        return const_iterator(m_ctrl + idx, m_ctrl + m_capacity, m_slots + idx);
+    }
+
+    // 设置控制字节，前c_ctrlGroupWidth个控制字节在末尾有一份镜像，使得任意位置都可以一次读出一组控制字节
+    void setCtrl(size_t idx, CtrlByte h) noexcept {
+        m_ctrl[idx] = h;
+        if (idx < c_ctrlGroupWidth) {
+            m_ctrl[m_capacity + idx] = h;
+        }
+    }
+
+    // 查找键所在的下标，不存在返回c_npos
+    size_t findIndex(const key_type& key, size_t hash) const noexcept {
+        if (0 == m_capacity) {
+            return c_npos;
+        }
+        size_t mask = m_capacity - 1;
+        size_t pos = H1(hash) & mask;
+        CtrlByte h2 = H2(hash);
+        // 以组为单位做三角探测（步长依次为1，2，3...组），槽位个数为2的幂时可以遍历所有组
+        for (size_t step = c_ctrlGroupWidth; ; step += c_ctrlGroupWidth) {
+            CtrlGroup g(m_ctrl + pos);
+            for (uint32_t m = g.match(h2); m; m &= m - 1) {
+                size_t idx = (pos + __builtin_ctz(m)) & mask;
+                if (Policy::key(m_slots[idx]) == key) {
+                    return idx;
+                }
+            }
+            if (g.matchEmpty()) {
+                return c_npos;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // 在探测序列中找到第一个空槽位或已删除的槽位
+    size_t findFirstNonFull(size_t hash) const noexcept {
+        size_t mask = m_capacity - 1;
+        size_t pos = H1(hash) & mask;
+        for (size_t step = c_ctrlGroupWidth; ; step += c_ctrlGroupWidth) {
+            CtrlGroup g(m_ctrl + pos);
+            uint32_t m = g.matchEmptyOrDeleted();
+            if (m) {
+                return (pos + __builtin_ctz(m)) & mask;
+            }
+            pos = (pos + step) & mask;
+        }
+    }
+
+    /**
+     * 为新元素准备一个槽位（调用者保证键不存在）
+     * @param hash 新元素的哈希值
+     * @return 可以直接构造新元素的槽位下标
+     */
+    size_t prepareInsert(size_t hash) {
+        if (0 == m_growthLeft) {
+            // 墓碑较多时原地重建，否则扩容
+            if (m_capacity > 0 && m_size * 2 <= capacityToGrowth(m_capacity)) {
+                resize(m_capacity);
+            } else {
+                resize(normalizeCapacity(m_capacity * 2));
+            }
+        }
+        size_t idx = findFirstNonFull(hash);
+        if (c_ctrlEmpty == m_ctrl[idx]) {
+            --m_growthLeft;
+        }
+        setCtrl(idx, H2(hash));
+        ++m_size;
+        return idx;
+    }
+
+    // 插入新元素（调用者保证键不存在）
+    template <typename... Args>
+    size_t insertUnique(Args&&... args) {
+        value_type tmp(std::forward<Args>(args)...);
+        size_t idx = prepareInsert(m_hash(Policy::key(tmp)));
+        new (m_slots + idx) value_type(std::move(tmp));
+        return idx;
+    }
+
+    // 查找键，不存在则用args构造新元素，返回元素下标和是否插入了新元素
+    template <typename K, typename... Args>
+    std::pair<size_t, bool> findOrEmplace(const K& key, Args&&... args) {
+        size_t hash = m_hash(key);
+        size_t idx = findIndex(key, hash);
+        if (idx != c_npos) {
+            return std::make_pair(idx, false);
+        }
+        idx = prepareInsert(hash);
+        try {
+            new (m_slots + idx) value_type(std::forward<Args>(args)...);
+        } catch (...) {
+            setCtrl(idx, c_ctrlDeleted);
+            --m_size;
+            throw;
+        }
+        return std::make_pair(idx, true);
+    }
+
+    // 删除指定下标的元素，留下墓碑
+    void eraseAt(size_t idx) noexcept {
+        m_slots[idx].~value_type();
+        setCtrl(idx, c_ctrlDeleted);
+        --m_size;
+    }
+
+    // 调整槽位个数，重新插入所有元素
+    void resize(size_t newCap) {
+        CtrlByte* oldCtrl = m_ctrl;
+        value_type* oldSlots = m_slots;
+        size_t oldCap = m_capacity;
+
+        m_ctrl = new CtrlByte[newCap + c_ctrlGroupWidth];
+        try {
+            m_slots = SlotAlloc().allocate(newCap);
+        } catch (...) {
+            delete[] m_ctrl;
+            m_ctrl = oldCtrl;
+            throw;
+        }
+        std::fill(m_ctrl, m_ctrl + newCap + c_ctrlGroupWidth, c_ctrlEmpty);
+        m_capacity = newCap;
+        m_growthLeft = capacityToGrowth(newCap) - m_size;
+
+        // 重新插入，新表中不存在墓碑和重复的键
+        for (size_t i = 0; i < oldCap; ++i) {
+            if (oldCtrl[i] >= 0) {
+                size_t hash = m_hash(Policy::key(oldSlots[i]));
+                size_t idx = findFirstNonFull(hash);
+                setCtrl(idx, H2(hash));
+                new (m_slots + idx) value_type(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+            }
+        }
+
+        if (oldCap) {
+            delete[] oldCtrl;
+            SlotAlloc().deallocate(oldSlots, oldCap);
+        }
+    }
+
+    // 析构所有元素
+    void destroySlots() noexcept {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_ctrl[i] >= 0) {
+                m_slots[i].~value_type();
+            }
+        }
+    }
+
+    // 释放所有内存
+    void destroy() noexcept {
+        if (0 == m_capacity) {
+            return;
+        }
+        destroySlots();
+        delete[] m_ctrl;
+        SlotAlloc().deallocate(m_slots, m_capacity);
+        m_ctrl = nullptr;
+        m_slots = nullptr;
+        m_capacity = m_size = m_growthLeft = 0;
+    }
+
+    using SlotAlloc = std::allocator<value_type>;
+
+    CtrlByte* m_ctrl = nullptr;         // 控制字节（m_capacity + c_ctrlGroupWidth个）
+    value_type* m_slots = nullptr;      // 槽位
+    size_t m_capacity = 0;              // 槽位个数
+    size_t m_size = 0;                  // 元素个数
+    size_t m_growthLeft = 0;            // 还能占用多少个空槽位（墓碑不能算作空槽位）
+    Hash m_hash;                        // 哈希函数
+};
+
+// FlatHashMap的槽位策略
+template <size_t N, typename V>
+struct FlatMapPolicy {
+    using key_type = FixedBytes<N>;
+    using value_type = std::pair<const FixedBytes<N>, V>;
+    static const key_type& key(const value_type& slot) noexcept { return slot.first; }
+};
+
+// FlatHashSet的槽位策略
+template <size_t N>
+struct FlatSetPolicy {
+    using key_type = FixedBytes<N>;
+    using value_type = FixedBytes<N>;
+    static const key_type& key(const value_type& slot) noexcept { return slot; }
+};
+
+/**
+ * 以定长字节数组为键的开放寻址哈希表
+ * 注意：插入和rehash会使迭代器和元素引用失效
+ */
+template <size_t N, typename V, typename Hash = typename FixedBytes<N>::hash>
+class FlatHashMap : public FlatHashTable<FlatMapPolicy<N, V>, Hash> {
+public:
+    using Base = FlatHashTable<FlatMapPolicy<N, V>, Hash>;
+    using key_type = typename Base::key_type;
+    using mapped_type = V;
+    using value_type = typename Base::value_type;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    using Base::Base;
+
+    // 插入元素，键已存在时不做任何事
+    std::pair<iterator, bool> insert(const value_type& value) {
+        auto ret = this->findOrEmplace(value.first, value);
+        return std::make_pair(this->iteratorAt(ret.first), ret.second);
+    }
+
+    // 键不存在时用args构造值，键已存在时不做任何事
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const key_type& key, Args&&... args) {
+        auto ret = this->findOrEmplace(key, std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return std::make_pair(this->iteratorAt(ret.first), ret.second);
+    }
+
+    // 插入或覆盖元素
+    template <typename M>
+    std::pair<iterator, bool> insertOrAssign(const key_type& key, M&& value) {
+        auto ret = emplace(key, std::forward<M>(value));
+        if (!ret.second) {
+            ret.first->second = std::forward<M>(value);
+        }
+        return ret;
+    }
+
+    // 获取值的引用，键不存在时插入默认值
+    V& operator[](const key_type& key) { return emplace(key).first->second; }
+
+    /**
+     * 获取值的引用
+     * @throw 键不存在抛出OutOfRange异常
+     */
+    V& at(const key_type& key) {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw OutOfRange();
+        }
+        return it->second;
+    }
+    const V& at(const key_type& key) const {
+        auto it = this->find(key);
+        if (it == this->end()) {
+            throw OutOfRange();
+        }
+        return it->second;
+    }
+};
+
+// 以定长字节数组为元素的开放寻址哈希集合
+template <size_t N, typename Hash = typename FixedBytes<N>::hash>
+class FlatHashSet : public FlatHashTable<FlatSetPolicy<N>, Hash> {
+public:
+    using Base = FlatHashTable<FlatSetPolicy<N>, Hash>;
+    using key_type = typename Base::key_type;
+    using value_type = typename Base::value_type;
+    using iterator = typename Base::iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    using Base::Base;
+
+    // 插入元素，元素已存在时不做任何事
+    std::pair<iterator, bool> insert(const key_type& key) {
+        auto ret = this->findOrEmplace(key, key);
+        return std::make_pair(this->iteratorAt(ret.first), ret.second);
+    }
+};
+
+/**
+ * 分片加锁的并发哈希表，按键的哈希值高位分到不同的分片，每个分片一把锁，减少锁竞争
+ * 不提供迭代器和引用（其它线程随时可能修改），通过拷贝或回调访问值
+ */
+template <size_t N, typename V, size_t ShardBits = 4, typename Hash = typename FixedBytes<N>::hash>
+class ConcurrentFlatHashMap {
+public:
+    using key_type = FixedBytes<N>;
+    using mapped_type = V;
+
+    // 分片个数
+    static constexpr size_t c_shardCount = size_t(1) << ShardBits;
+
+    ConcurrentFlatHashMap() = default;
+
+    // 插入元素，键已存在时返回false
+    bool insert(const key_type& key, const V& value) {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        return shard.map.emplace(key, value).second;
+    }
+
+    // 插入或覆盖元素，插入了新元素返回true
+    bool insertOrAssign(const key_type& key, const V& value) {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        return shard.map.insertOrAssign(key, value).second;
+    }
+
+    // 拷贝出值，键不存在返回false
+    bool tryGet(const key_type& key, V& out) const {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    // 判断键是否存在
+    bool contains(const key_type& key) const {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        return shard.map.contains(key);
+    }
+
+    // 在持有分片锁的情况下修改值（键不存在时先插入默认值），f的签名为void(V&)
+    template <typename F>
+    void update(const key_type& key, F&& f) {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        f(shard.map[key]);
+    }
+
+    // 删除元素，键不存在返回false
+    bool erase(const key_type& key) {
+        auto& shard = shardOf(key);
+        Guard guard(shard.mutex);
+        return shard.map.erase(key) > 0;
+    }
+
+    // 元素个数（各分片依次加锁统计，并发修改时只是近似值）
+    size_t size() const {
+        size_t ret = 0;
+        for (auto& shard : m_shards) {
+            Guard guard(shard.mutex);
+            ret += shard.map.size();
+        }
+        return ret;
+    }
+
+    // 预留空间（平均分配到各分片）
+    void reserve(size_t n) {
+        for (auto& shard : m_shards) {
+            Guard guard(shard.mutex);
+            shard.map.reserve((n + c_shardCount - 1) / c_shardCount);
+        }
+    }
+
+    // 清空所有元素
+    void clear() {
+        for (auto& shard : m_shards) {
+            Guard guard(shard.mutex);
+            shard.map.clear();
+        }
+    }
+
+    // 依次锁住每个分片并遍历其中的元素，f的签名为void(const key_type&, const V&)
+    template <typename F>
+    void forEach(F&& f) const {
+        for (auto& shard : m_shards) {
+            Guard guard(shard.mutex);
+            for (const auto& kv : shard.map) {
+                f(kv.first, kv.second);
+            }
+        }
+    }
+
+private:
+    // 分片（按缓存行对齐，避免伪共享）
+    struct alignas(64) Shard {
+        mutable Mutex mutex;
+        FlatHashMap<N, V, Hash> map;
+    };
+
+    // 用哈希值的最高几位选择分片（分片内的哈希表用的是低位）
+    Shard& shardOf(const key_type& key) { return m_shards[Hash()(key) >> (64 - ShardBits)]; }
+    const Shard& shardOf(const key_type& key) const { return m_shards[Hash()(key) >> (64 - ShardBits)]; }
+
+    std::array<Shard, c_shardCount> m_shards;
+};
+
+}   // namespace dev
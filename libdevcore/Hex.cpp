@@ -57,11 +57,8 @@ static const Byte s_decodeMap[] = {
 //     return true;
 // }
 
-// 将字节数组转换为16进制字符串（小写，不带前缀0x）
-std::string toHex(BytesConstRef src) {
-    // 提前分配好内存
-    std::string dst(src.size() * 2, '\0');
-
+// 将字节数组编码为16进制字符写入dst（dst至少有src.size() * 2字节）
+DEV_TARGET_CLONES static void hexEncode(BytesConstRef src, char* dst) noexcept {
     // 每一个字节转换为两个字符
     size_t dstIdx = 0;
     for (auto b : src) {
@@ -69,7 +66,13 @@ std::string toHex(BytesConstRef src) {
         dst[dstIdx + 1] = s_encodeMap[b & 0x0f];
         dstIdx += 2;
     }
+}
 
+// 将字节数组转换为16进制字符串（小写，不带前缀0x）
+std::string toHex(BytesConstRef src) {
+    // 提前分配好内存
+    std::string dst(src.size() * 2, '\0');
+    hexEncode(src, &dst[0]);
     return dst;
 }
 
@@ -78,40 +81,34 @@ std::string toHex0x(BytesConstRef src) {
     // 提前分配好内存
     std::string dst = "0x";
     dst.resize(src.size() * 2 + 2);
+    hexEncode(src, &dst[2]);
+    return dst;
+}
 
-    // 每一个字节转换为两个字符
-    size_t dstIdx = 2;
-    for (auto b : src) {
-        dst[dstIdx + 0] = s_encodeMap[(b >> 4) & 0x0f];
-        dst[dstIdx + 1] = s_encodeMap[b & 0x0f];
-        dstIdx += 2;
-    }
+// 16进制字符串跳过前缀0x后的起始下标
+static size_t hexStart(std::string_view src) noexcept {
+    return src.size() >= 2 && src[0] == '0' && tolower(src[1]) == 'x' ? 2 : 0;
+}
 
-    return dst;
+// 16进制字符串解码后的字节数
+size_t hexDecodedSize(std::string_view src) noexcept {
+    return (src.size() - hexStart(src) + 1) / 2;
 }
 
-/**
- * 将16进制字符串转换为字节数组
- * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
- * @return 对应的字节数组
- * @throw 遇到非法16进制字符抛出BadHexCh异常
- */
-Bytes fromHex(const std::string& src) {
+// 将16进制字符串解码到dst中（dst至少有hexDecodedSize(src)字节），遇到非法16进制字符返回false（由调用方抛出异常）
+DEV_TARGET_CLONES static bool hexDecodeKernel(std::string_view src, Byte* dst) noexcept {
     // assert(checkDecodeMap(s_encodeMap, s_decodeMap));
 
     // 跳过0x开头
     size_t srcLen = src.size();
-    size_t srcIdx = srcLen >= 2 && src[0] == '0' && tolower(src[1]) == 'x' ? 2 : 0;
-
-    // 提前分配好内存
-    Bytes dst((srcLen - srcIdx + 1) / 2);
+    size_t srcIdx = hexStart(src);
     size_t dstIdx = 0;
 
     // 奇数个字符，先处理一个
     if (srcLen % 2) {
         Byte l = s_decodeMap[(Byte)src[srcIdx++]];
         if (l == 0xff) {
-            throw BadHexCh();
+            return false;
         }
         dst[dstIdx++] = l;
     }
@@ -121,12 +118,57 @@ Bytes fromHex(const std::string& src) {
         Byte h = s_decodeMap[(Byte)src[srcIdx++]];
         Byte l = s_decodeMap[(Byte)src[srcIdx++]];
         if (h == 0xff || l == 0xff) {
-            throw BadHexCh();
+            return false;
         }
         dst[dstIdx++] = h << 4 | l;
     }
+    return true;
+}
 
+// 将16进制字符串解码到dst中（dst至少有hexDecodedSize(src)字节）
+static void hexDecode(std::string_view src, Byte* dst) {
+    if (!hexDecodeKernel(src, dst)) {
+        throw BadHexCh();
+    }
+}
+
+/**
+ * 将16进制字符串转换为字节数组
+ * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
+ * @return 对应的字节数组
+ * @throw 遇到非法16进制字符抛出BadHexCh异常
+ */
+Bytes fromHex(std::string_view src) {
+    // 提前分配好内存
+    Bytes dst(hexDecodedSize(src));
+    hexDecode(src, dst.data());
     return dst;
 }
 
+/**
+ * 将16进制字符串转换为字节数组（结果不超过64字节时不需要分配堆内存）
+ * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
+ * @param dst 输出的字节数组
+ * @throw 遇到非法16进制字符抛出BadHexCh异常
+ */
+void fromHex(std::string_view src, SmallBytes& dst) {
+    dst.clear();
+    dst.resize(hexDecodedSize(src));
+    hexDecode(src, dst.mutableData());
+}
+
+/**
+ * 将16进制字符串解码到调用方提供的内存中（不分配内存）
+ * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
+ * @param dst 输出的字节数组，长度必须等于hexDecodedSize(src)
+ * @throw 遇到非法16进制字符抛出BadHexCh异常
+ * @throw dst长度不符抛出OutOfRange异常
+ */
+void fromHex(std::string_view src, BytesRef dst) {
+    if (dst.size() != hexDecodedSize(src)) {
+        throw OutOfRange();
+    }
+    hexDecode(src, dst.data());
+}
+
 }   // namespace dev
\ No newline at end of file
@@ -6,7 +6,9 @@
  */
 #pragma once
 
+#include <string_view>
 #include "Common.h"
+#include "SmallBytes.h"
 
 namespace dev {
 
@@ -22,6 +24,26 @@ std::string toHex0x(BytesConstRef src);
  * @return 对应的字节数组
  * @throw 遇到非法16进制字符抛出BadHexCh异常
  */
-Bytes fromHex(const std::string& src);
+Bytes fromHex(std::string_view src);
+
+/**
+ * 将16进制字符串转换为字节数组（结果不超过64字节时不需要分配堆内存）
+ * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
+ * @param dst 输出的字节数组
+ * @throw 遇到非法16进制字符抛出BadHexCh异常
+ */
+void fromHex(std::string_view src, SmallBytes& dst);
+
+/**
+ * 将16进制字符串解码到调用方提供的内存中（不分配内存）
+ * @param src 16进制字符串（允许前缀0x或0X，不允许空白符）
+ * @param dst 输出的字节数组，长度必须等于hexDecodedSize(src)
+ * @throw 遇到非法16进制字符抛出BadHexCh异常
+ * @throw dst长度不符抛出OutOfRange异常
+ */
+void fromHex(std::string_view src, BytesRef dst);
+
+// 16进制字符串解码后的字节数
+size_t hexDecodedSize(std::string_view src) noexcept;
 
 }   // namespace dev
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+ * 键值存储抽象层
+ * @file: KVStore.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "KVStore.h"
+#include "SnappyCompress.h"
+
+namespace dev {
+
+// 遍历时每次在锁内取出的键值个数
+static const size_t c_forEachBatchSize = 256;
+
+// key是否以prefix开头
+static bool hasPrefix(const SmallBytes& key, BytesConstRef prefix) noexcept {
+    return key.size() >= prefix.size() && (prefix.empty() || 0 == memcmp(key.data(), prefix.data(), prefix.size()));
+}
+
+// 内存存储的快照（持有创建时的索引）
+class MemoryKVStore::Snapshot : public KVSnapshot {
+public:
+    explicit Snapshot(std::shared_ptr<const Index> index) : m_index(std::move(index)) {}
+
+    bool get(BytesConstRef key, Bytes& value) const override {
+        return MemoryKVStore::get(*m_index, key, value);
+    }
+
+    void forEach(BytesConstRef prefix, const KVVisitor& visitor) const override {
+        MemoryKVStore::forEach(*m_index, prefix, visitor);
+    }
+
+private:
+    std::shared_ptr<const Index> m_index;
+};
+
+MemoryKVStore::MemoryKVStore(const KVOptions& options)
+: m_options(options), m_index(std::make_shared<Index>()) {}
+
+// 读取键对应的值，不存在返回false
+bool MemoryKVStore::get(BytesConstRef key, Bytes& value) const {
+    Value stored;
+    {
+        // 锁内只拷贝（共享存储只增加引用计数），解压在锁外进行
+        Guard l(m_mutex);
+        auto it = m_index->find(SmallBytes(key));
+        if (it == m_index->end()) {
+            return false;
+        }
+        stored = it->second;
+    }
+    load(stored, value);
+    return true;
+}
+
+// 原子地写入一批操作
+void MemoryKVStore::write(const WriteBatch& batch, bool) {
+    // 压缩在锁外进行
+    std::vector<Value> values(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& op = batch.ops()[i];
+        if (op.remove) {
+            continue;
+        }
+        if (m_options.compress && op.value.size() > m_options.compressThreshold) {
+            SnappyCompress::compress(op.value.ref(), values[i].data);
+            values[i].compressed = true;
+        } else {
+            values[i].data = op.value;
+            values[i].compressed = false;
+        }
+    }
+
+    Guard l(m_mutex);
+    if (m_index.use_count() > 1) {
+        // 索引被快照引用，写时复制
+        m_index = std::make_shared<Index>(*m_index);
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& op = batch.ops()[i];
+        if (op.remove) {
+            m_index->erase(op.key);
+        } else {
+            (*m_index)[op.key] = std::move(values[i]);
+        }
+    }
+}
+
+/**
+ * 按键的顺序遍历所有以prefix开头的键值
+ * 不在快照上遍历（持有快照时的写入会复制整个索引），而是分批在锁内拷贝键值（值只增加引用计数），
+ * 在锁外解压并回调，下一批从上一批最后一个键之后继续
+ */
+void MemoryKVStore::forEach(BytesConstRef prefix, const KVVisitor& visitor) const {
+    std::vector<std::pair<SmallBytes, Value>> batch;
+    batch.reserve(c_forEachBatchSize);
+    SmallBytes cursor(prefix);
+    Bytes uncompressed;
+    for (bool first = true;; first = false) {
+        batch.clear();
+        {
+            Guard l(m_mutex);
+            auto it = first ? m_index->lower_bound(cursor) : m_index->upper_bound(cursor);
+            for (; it != m_index->end() && batch.size() < c_forEachBatchSize && hasPrefix(it->first, prefix); ++it) {
+                batch.emplace_back(*it);
+            }
+        }
+        for (auto& kv : batch) {
+            BytesConstRef value = kv.second.data.ref();
+            if (kv.second.compressed) {
+                uncompressed = SnappyCompress::uncompress(value);
+                value = uncompressed;
+            }
+            if (!visitor(kv.first.ref(), value)) {
+                return;
+            }
+        }
+        if (batch.size() < c_forEachBatchSize) {
+            return;
+        }
+        cursor = std::move(batch.back().first);
+    }
+}
+
+// 创建快照
+KVSnapshot::Ptr MemoryKVStore::snapshot() const {
+    Guard l(m_mutex);
+    return std::make_shared<Snapshot>(m_index);
+}
+
+// 键值对个数
+size_t MemoryKVStore::size() const {
+    Guard l(m_mutex);
+    return m_index->size();
+}
+
+// 在索引中读取
+bool MemoryKVStore::get(const Index& index, BytesConstRef key, Bytes& value) {
+    auto it = index.find(SmallBytes(key));
+    if (it == index.end()) {
+        return false;
+    }
+    load(it->second, value);
+    return true;
+}
+
+// 在索引中按前缀遍历
+void MemoryKVStore::forEach(const Index& index, BytesConstRef prefix, const KVVisitor& visitor) {
+    Bytes uncompressed;
+    for (auto it = index.lower_bound(SmallBytes(prefix)); it != index.end(); ++it) {
+        auto& key = it->first;
+        if (!hasPrefix(key, prefix)) {
+            break;
+        }
+        BytesConstRef value = it->second.data.ref();
+        if (it->second.compressed) {
+            uncompressed = SnappyCompress::uncompress(value);
+            value = uncompressed;
+        }
+        if (!visitor(key.ref(), value)) {
+            break;
+        }
+    }
+}
+
+// 取出存储的值（需要时解压）
+void MemoryKVStore::load(const Value& stored, Bytes& value) {
+    if (stored.compressed) {
+        value = SnappyCompress::uncompress(stored.data.ref());
+    } else {
+        value.assign(stored.data.begin(), stored.data.end());
+    }
+}
+
+}   // namespace dev
@@ -0,0 +1,191 @@
+/**
+ * 键值存储抽象层
+ * @file: KVStore.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include "Common.h"
+#include "Guards.h"
+#include "SmallBytes.h"
+
+namespace dev {
+
+/**
+ * 状态树节点，区块，交易回执等都需要持久化，KVStore是它们共用的存储接口：
+ * 1. 单个键值的读写删除，以及WriteBatch批量原子写入（一次提交只需要一次fsync）
+ * 2. 按前缀有序遍历（键按字节序排序）
+ * 3. 快照：创建之后的写入对快照不可见，用于在写入新区块的同时读取旧状态
+ * 后端有内存存储（MemoryKVStore）和日志结构的磁盘存储（LogKVStore）两种，
+ * 较大的值可以选择用snappy压缩后再存储
+ */
+
+// 键的比较（按字节序）
+struct SmallBytesLess {
+    bool operator()(const SmallBytes& lhs, const SmallBytes& rhs) const noexcept {
+        size_t n = std::min(lhs.size(), rhs.size());
+        int c = n > 0 ? memcmp(lhs.data(), rhs.data(), n) : 0;
+        return c < 0 || (0 == c && lhs.size() < rhs.size());
+    }
+};
+
+// 存储选项
+struct KVOptions {
+    bool compress = false;              // 是否用snappy压缩较大的值
+    size_t compressThreshold = 256;     // 长度超过此值才压缩
+};
+
+// 批量写入（作为一个整体原子地写入存储）
+class WriteBatch {
+public:
+    // 一次写操作
+    struct Op {
+        bool remove;                    // 是否为删除
+        SmallBytes key;                 // 键
+        SmallBytes value;               // 值（删除时为空）
+    };
+
+    // 写入键值（值为空也是合法的）
+    void put(BytesConstRef key, BytesConstRef value) {
+        m_ops.push_back(Op{false, SmallBytes(key), SmallBytes(value)});
+        m_byteSize += key.size() + value.size();
+    }
+
+    // 删除键
+    void remove(BytesConstRef key) {
+        m_ops.push_back(Op{true, SmallBytes(key), SmallBytes()});
+        m_byteSize += key.size();
+    }
+
+    // 清空
+    void clear() noexcept {
+        m_ops.clear();
+        m_byteSize = 0;
+    }
+
+    // 操作个数
+    size_t size() const noexcept { return m_ops.size(); }
+    bool empty() const noexcept { return m_ops.empty(); }
+
+    // 键值的总长度
+    size_t byteSize() const noexcept { return m_byteSize; }
+
+    // 按添加顺序的所有操作（同一个键的多次操作以最后一次为准）
+    const std::vector<Op>& ops() const noexcept { return m_ops; }
+
+private:
+    std::vector<Op> m_ops;
+    size_t m_byteSize = 0;
+};
+
+// 遍历回调，返回false停止遍历
+using KVVisitor = std::function<bool(BytesConstRef key, BytesConstRef value)>;
+
+// 只读快照
+class KVSnapshot {
+public:
+    using Ptr = std::shared_ptr<const KVSnapshot>;
+
+    virtual ~KVSnapshot() = default;
+
+    // 读取键对应的值，不存在返回false
+    virtual bool get(BytesConstRef key, Bytes& value) const = 0;
+
+    // 按键的顺序遍历所有以prefix开头的键值（prefix为空时遍历全部）
+    virtual void forEach(BytesConstRef prefix, const KVVisitor& visitor) const = 0;
+};
+
+// 键值存储接口（线程安全）
+class KVStore {
+public:
+    using Ptr = std::shared_ptr<KVStore>;
+
+    virtual ~KVStore() = default;
+
+    // 读取键对应的值，不存在返回false
+    virtual bool get(BytesConstRef key, Bytes& value) const = 0;
+
+    // 是否存在
+    bool contains(BytesConstRef key) const {
+        Bytes value;
+        return get(key, value);
+    }
+
+    /**
+     * 原子地写入一批操作
+     * @param batch 批量操作
+     * @param sync 是否等待数据落盘后再返回（内存存储忽略）
+     */
+    virtual void write(const WriteBatch& batch, bool sync = false) = 0;
+
+    // 写入单个键值
+    void put(BytesConstRef key, BytesConstRef value, bool sync = false) {
+        WriteBatch batch;
+        batch.put(key, value);
+        write(batch, sync);
+    }
+
+    // 删除单个键
+    void remove(BytesConstRef key, bool sync = false) {
+        WriteBatch batch;
+        batch.remove(key);
+        write(batch, sync);
+    }
+
+    /**
+     * 按键的顺序遍历所有以prefix开头的键值
+     * 回调中可以写入存储，遍历期间的写入对尚未访问到的键可能可见，需要一致的视图时在snapshot()上遍历
+     */
+    virtual void forEach(BytesConstRef prefix, const KVVisitor& visitor) const = 0;
+
+    // 创建快照
+    virtual KVSnapshot::Ptr snapshot() const = 0;
+};
+
+/**
+ * 内存存储（有序map）
+ * 索引用写时复制的方式共享给快照：持有快照时的第一次写入会复制整个索引（值本身只增加引用计数），
+ * 因此快照应该只在短时间内持有
+ */
+class MemoryKVStore : public KVStore {
+public:
+    explicit MemoryKVStore(const KVOptions& options = KVOptions());
+
+    bool get(BytesConstRef key, Bytes& value) const override;
+    void write(const WriteBatch& batch, bool sync = false) override;
+    void forEach(BytesConstRef prefix, const KVVisitor& visitor) const override;
+    KVSnapshot::Ptr snapshot() const override;
+
+    // 键值对个数
+    size_t size() const;
+
+private:
+    // 存储的值
+    struct Value {
+        SmallBytes data;                // 值（可能是压缩过的）
+        bool compressed;                // 是否经过压缩
+    };
+    using Index = std::map<SmallBytes, Value, SmallBytesLess>;
+
+    class Snapshot;
+
+    // 取出存储的值（需要时解压）
+    static void load(const Value& stored, Bytes& value);
+
+    // 在索引中读取/遍历
+    static bool get(const Index& index, BytesConstRef key, Bytes& value);
+    static void forEach(const Index& index, BytesConstRef prefix, const KVVisitor& visitor);
+
+    KVOptions m_options;
+    mutable Mutex m_mutex;
+    std::shared_ptr<Index> m_index;     // 当前索引（被快照引用时写入前先复制）
+};
+
+}   // namespace dev
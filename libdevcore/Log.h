@@ -53,7 +53,7 @@ extern LogLevel g_fileLogLevel;
 #define LOG(level)                                   \
     if (dev::LogLevel::level >= dev::g_fileLogLevel) \
     BOOST_LOG_SEV(dev::g_fileLoggerHandler,          \
-        (boost::log::v2s_mt_posix::trivial::severity_level)(dev::LogLevel::level))
+        (boost::log::trivial::severity_level)(dev::LogLevel::level))
 
 // BCOS log format
 #define LOG_BADGE(_NAME) "[" << (_NAME) << "]"
@@ -0,0 +1,547 @@
+/**
+ * 日志结构的磁盘键值存储
+ * @file: LogKVStore.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "LogKVStore.h"
+#include "CRC32C.h"
+#include "SnappyCompress.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace dev {
+
+// 帧头长度：4字节负载长度 + 4字节负载的CRC32C
+static const size_t c_frameHeaderSize = 8;
+
+// 压缩时每帧的目标长度
+static const size_t c_compactFrameSize = 1 << 20;
+
+// 遍历时每次在锁内取出的键值个数
+static const size_t c_forEachBatchSize = 256;
+
+// 记录类型
+enum RecordType : Byte {
+    c_recordPut = 0,                    // 写入
+    c_recordPutCompressed = 1,          // 写入（值经过压缩）
+    c_recordRemove = 2                  // 删除
+};
+
+// 小端序读写
+static void putU32(Byte* p, uint32_t v) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<Byte>(v >> (i * 8));
+    }
+}
+
+static uint32_t getU32(const Byte* p) noexcept {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+// key是否以prefix开头
+static bool hasPrefix(const SmallBytes& key, BytesConstRef prefix) noexcept {
+    return key.size() >= prefix.size() && (prefix.empty() || 0 == memcmp(key.data(), prefix.data(), prefix.size()));
+}
+
+// 带errno描述的IO异常
+static StorageIOError ioError(const std::string& what) {
+    return StorageIOError(what + ": " + strerror(errno));
+}
+
+/**
+ * 追加一条记录到帧中
+ * @return 值在帧中的偏移
+ */
+static size_t appendRecord(Bytes& frame, RecordType type, BytesConstRef key, BytesConstRef value) {
+    size_t pos = frame.size();
+    frame.resize(pos + 1 + 4 + key.size() + (c_recordRemove == type ? 0 : 4 + value.size()));
+    Byte* p = frame.data() + pos;
+    *p++ = type;
+    putU32(p, static_cast<uint32_t>(key.size()));
+    p += 4;
+    if (!key.empty()) {
+        memcpy(p, key.data(), key.size());
+    }
+    p += key.size();
+    if (c_recordRemove == type) {
+        return 0;
+    }
+    putU32(p, static_cast<uint32_t>(value.size()));
+    p += 4;
+    if (!value.empty()) {
+        memcpy(p, value.data(), value.size());
+    }
+    return p - frame.data();
+}
+
+// 完整写入，返回是否成功
+static bool pwriteAll(int fd, const Byte* data, size_t size, uint64_t offset) noexcept {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+    return true;
+}
+
+// 完整读取，返回实际读到的长度（小于size表示到达文件末尾）
+static size_t preadAll(int fd, Byte* data, size_t size, uint64_t offset) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = pread(fd, data + total, size - total, offset + total);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            throw ioError("pread failed");
+        }
+        if (0 == n) {
+            break;
+        }
+        total += n;
+    }
+    return total;
+}
+
+// 目录落盘（新建和删除段文件后调用）
+static void syncDir(const std::string& dir) {
+    int fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// 段文件
+struct LogKVStore::Segment {
+    uint64_t id = 0;                    // 编号
+    std::string path;                   // 文件路径
+    int fd = -1;                        // 文件描述符
+    uint64_t size = 0;                  // 有效数据的长度
+
+    ~Segment() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+// 段文件路径
+static std::string segmentPath(const std::string& dir, uint64_t id) {
+    char name[32];
+    snprintf(name, sizeof(name), "%06llu.log", static_cast<unsigned long long>(id));
+    return dir + "/" + name;
+}
+
+// 磁盘存储的快照（持有创建时的索引）
+class LogKVStore::Snapshot : public KVSnapshot {
+public:
+    explicit Snapshot(std::shared_ptr<const Index> index) : m_index(std::move(index)) {}
+
+    bool get(BytesConstRef key, Bytes& value) const override {
+        return LogKVStore::get(*m_index, key, value);
+    }
+
+    void forEach(BytesConstRef prefix, const KVVisitor& visitor) const override {
+        LogKVStore::forEach(*m_index, prefix, visitor);
+    }
+
+private:
+    std::shared_ptr<const Index> m_index;
+};
+
+// 打开数据目录（不存在时创建），回放段文件重建索引
+LogKVStore::LogKVStore(const std::string& dir, const LogKVOptions& options)
+: m_dir(dir), m_options(options), m_index(std::make_shared<Index>()) {
+    if (mkdir(m_dir.c_str(), 0755) < 0 && EEXIST != errno) {
+        throw ioError("mkdir " + m_dir + " failed");
+    }
+
+    // 收集段文件编号
+    DIR* d = opendir(m_dir.c_str());
+    if (!d) {
+        throw ioError("opendir " + m_dir + " failed");
+    }
+    std::vector<uint64_t> ids;
+    while (dirent* entry = readdir(d)) {
+        char* end = nullptr;
+        unsigned long long id = strtoull(entry->d_name, &end, 10);
+        if (end != entry->d_name && 0 == strcmp(end, ".log")) {
+            ids.push_back(id);
+        }
+    }
+    closedir(d);
+    std::sort(ids.begin(), ids.end());
+
+    // 按顺序回放
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto segment = std::make_shared<Segment>();
+        segment->id = ids[i];
+        segment->path = segmentPath(m_dir, ids[i]);
+        segment->fd = open(segment->path.c_str(), O_RDWR | O_CLOEXEC);
+        if (segment->fd < 0) {
+            throw ioError("open " + segment->path + " failed");
+        }
+        segment->size = replay(segment, i + 1 == ids.size());
+        m_segments.push_back(segment);
+        m_nextSegmentId = ids[i] + 1;
+    }
+
+    if (m_segments.empty()) {
+        rotate();
+    }
+}
+
+LogKVStore::~LogKVStore() = default;
+
+// 读取键对应的值，不存在返回false
+bool LogKVStore::get(BytesConstRef key, Bytes& value) const {
+    Location loc;
+    {
+        // 锁内只拷贝位置，读文件在锁外进行
+        Guard l(m_mutex);
+        auto it = m_index->find(SmallBytes(key));
+        if (it == m_index->end()) {
+            return false;
+        }
+        loc = it->second;
+    }
+    load(loc, value);
+    return true;
+}
+
+// 原子地写入一批操作
+void LogKVStore::write(const WriteBatch& batch, bool sync) {
+    if (batch.empty()) {
+        return;
+    }
+
+    // 编码（以及压缩）在锁外进行
+    Bytes frame(c_frameHeaderSize);
+    frame.reserve(c_frameHeaderSize + batch.byteSize() + batch.size() * 9);
+    std::vector<std::pair<size_t, bool>> offsets(batch.size());
+    SmallBytes compressed;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& op = batch.ops()[i];
+        if (op.remove) {
+            appendRecord(frame, c_recordRemove, op.key.ref(), BytesConstRef());
+        } else if (m_options.compress && op.value.size() > m_options.compressThreshold) {
+            SnappyCompress::compress(op.value.ref(), compressed);
+            offsets[i] = std::make_pair(appendRecord(frame, c_recordPutCompressed, op.key.ref(), compressed.ref()), true);
+        } else {
+            offsets[i] = std::make_pair(appendRecord(frame, c_recordPut, op.key.ref(), op.value.ref()), false);
+        }
+    }
+
+    Guard l(m_mutex);
+    uint64_t base = append(frame, sync);
+    auto& segment = m_segments.back();
+    if (m_index.use_count() > 1) {
+        // 索引被快照引用，写时复制
+        m_index = std::make_shared<Index>(*m_index);
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& op = batch.ops()[i];
+        if (op.remove) {
+            m_index->erase(op.key);
+        } else {
+            // 压缩后的长度从帧中读回
+            uint32_t size = getU32(frame.data() + offsets[i].first - 4);
+            (*m_index)[op.key] = Location{segment, base + offsets[i].first, size, offsets[i].second};
+        }
+    }
+}
+
+/**
+ * 按键的顺序遍历所有以prefix开头的键值
+ * 不在快照上遍历（持有快照时的写入会复制整个索引），而是分批在锁内拷贝键和位置，
+ * 在锁外读取值并回调，下一批从上一批最后一个键之后继续
+ */
+void LogKVStore::forEach(BytesConstRef prefix, const KVVisitor& visitor) const {
+    std::vector<std::pair<SmallBytes, Location>> batch;
+    batch.reserve(c_forEachBatchSize);
+    SmallBytes cursor(prefix);
+    Bytes value;
+    for (bool first = true;; first = false) {
+        batch.clear();
+        {
+            Guard l(m_mutex);
+            auto it = first ? m_index->lower_bound(cursor) : m_index->upper_bound(cursor);
+            for (; it != m_index->end() && batch.size() < c_forEachBatchSize && hasPrefix(it->first, prefix); ++it) {
+                batch.emplace_back(*it);
+            }
+        }
+        for (auto& kv : batch) {
+            load(kv.second, value);
+            if (!visitor(kv.first.ref(), value)) {
+                return;
+            }
+        }
+        if (batch.size() < c_forEachBatchSize) {
+            return;
+        }
+        cursor = std::move(batch.back().first);
+    }
+}
+
+// 创建快照
+KVSnapshot::Ptr LogKVStore::snapshot() const {
+    Guard l(m_mutex);
+    return std::make_shared<Snapshot>(m_index);
+}
+
+/**
+ * 把存活的键值重写到新的段文件，删除旧的段文件
+ * 旧的段文件按编号从小到大删除，中途宕机时剩下的旧段文件是一个后缀，
+ * 回放结果与压缩前相同（被删除的键的删除记录一定在剩下的段文件中，或者该键的所有写入记录都已被删除）
+ */
+void LogKVStore::compact() {
+    Guard l(m_mutex);
+    auto oldSegments = std::move(m_segments);
+    m_segments.clear();
+    rotate();
+
+    auto index = std::make_shared<Index>();
+    Bytes frame(c_frameHeaderSize);
+    std::vector<std::pair<Index::const_iterator, size_t>> pending;
+    Bytes raw;
+
+    // 把一帧写入新的段文件，更新新索引
+    auto flush = [&]() {
+        uint64_t base = append(frame, false);
+        auto& segment = m_segments.back();
+        for (auto& p : pending) {
+            auto& loc = p.first->second;
+            index->emplace_hint(index->end(), p.first->first,
+                Location{segment, base + p.second, loc.size, loc.compressed});
+        }
+        frame.resize(c_frameHeaderSize);
+        pending.clear();
+    };
+
+    for (auto it = m_index->cbegin(); it != m_index->cend(); ++it) {
+        loadRaw(it->second, raw);
+        RecordType type = it->second.compressed ? c_recordPutCompressed : c_recordPut;
+        pending.emplace_back(it, appendRecord(frame, type, it->first.ref(), raw));
+        if (frame.size() >= c_compactFrameSize) {
+            flush();
+        }
+    }
+    if (!pending.empty()) {
+        flush();
+    }
+    if (fdatasync(m_segments.back()->fd) < 0) {
+        throw ioError("fdatasync " + m_segments.back()->path + " failed");
+    }
+    m_index = index;
+
+    // 删除旧的段文件（快照仍持有的段文件在快照释放后关闭）
+    for (auto& segment : oldSegments) {
+        unlink(segment->path.c_str());
+    }
+    syncDir(m_dir);
+}
+
+// 键值对个数
+size_t LogKVStore::size() const {
+    Guard l(m_mutex);
+    return m_index->size();
+}
+
+// 段文件个数
+size_t LogKVStore::segmentCount() const {
+    Guard l(m_mutex);
+    return m_segments.size();
+}
+
+// 所有段文件的总长度
+uint64_t LogKVStore::diskSize() const {
+    Guard l(m_mutex);
+    uint64_t total = 0;
+    for (auto& segment : m_segments) {
+        total += segment->size;
+    }
+    return total;
+}
+
+// 回放段文件，返回有效数据的长度
+uint64_t LogKVStore::replay(const SegmentPtr& segment, bool last) {
+    struct stat st;
+    if (fstat(segment->fd, &st) < 0) {
+        throw ioError("fstat " + segment->path + " failed");
+    }
+    Bytes data(st.st_size);
+    data.resize(preadAll(segment->fd, data.data(), data.size(), 0));
+
+    uint64_t pos = 0;
+    while (pos < data.size()) {
+        // 检查帧是否完整
+        bool valid = data.size() - pos >= c_frameHeaderSize;
+        uint32_t payloadSize = 0;
+        if (valid) {
+            payloadSize = getU32(&data[pos]);
+            valid = data.size() - pos - c_frameHeaderSize >= payloadSize &&
+                getU32(&data[pos + 4]) == crc32c(BytesConstRef(&data[pos + c_frameHeaderSize], payloadSize));
+        }
+        if (!valid) {
+            if (!last) {
+                throw StorageCorrupted("corrupted frame in " + segment->path);
+            }
+            // 最后一个段文件末尾的不完整帧是写入时宕机留下的，截掉
+            if (ftruncate(segment->fd, pos) < 0) {
+                throw ioError("ftruncate " + segment->path + " failed");
+            }
+            break;
+        }
+
+        // 解析记录
+        const Byte* p = &data[pos + c_frameHeaderSize];
+        const Byte* end = p + payloadSize;
+        while (p < end) {
+            if (end - p < 5 || *p > c_recordRemove) {
+                throw StorageCorrupted("bad record in " + segment->path);
+            }
+            RecordType type = static_cast<RecordType>(*p);
+            uint32_t keySize = getU32(p + 1);
+            p += 5;
+            if (static_cast<size_t>(end - p) < keySize) {
+                throw StorageCorrupted("bad record in " + segment->path);
+            }
+            SmallBytes key(BytesConstRef(p, keySize));
+            p += keySize;
+            if (c_recordRemove == type) {
+                m_index->erase(key);
+                continue;
+            }
+            if (end - p < 4 || static_cast<size_t>(end - p - 4) < getU32(p)) {
+                throw StorageCorrupted("bad record in " + segment->path);
+            }
+            uint32_t valueSize = getU32(p);
+            p += 4;
+            (*m_index)[key] = Location{segment, static_cast<uint64_t>(p - data.data()), valueSize,
+                c_recordPutCompressed == type};
+            p += valueSize;
+        }
+        pos += c_frameHeaderSize + payloadSize;
+    }
+    return pos;
+}
+
+// 创建新的段文件作为当前写入的段文件（之前的段文件先截掉有效数据之后的内容并落盘）
+void LogKVStore::rotate() {
+    if (!m_segments.empty()) {
+        auto& last = m_segments.back();
+        if (ftruncate(last->fd, last->size) < 0) {
+            throw ioError("ftruncate " + last->path + " failed");
+        }
+        if (fdatasync(last->fd) < 0) {
+            throw ioError("fdatasync " + last->path + " failed");
+        }
+    }
+    auto segment = std::make_shared<Segment>();
+    segment->id = m_nextSegmentId;
+    segment->path = segmentPath(m_dir, segment->id);
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (segment->fd < 0) {
+        throw ioError("open " + segment->path + " failed");
+    }
+    syncDir(m_dir);
+    ++m_nextSegmentId;
+    m_segments.push_back(segment);
+}
+
+// 填写帧头，追加到当前段文件（当前段文件写满时先切换），返回帧在段文件中的偏移
+uint64_t LogKVStore::append(Bytes& frame, bool sync) {
+    size_t payloadSize = frame.size() - c_frameHeaderSize;
+    if (payloadSize > std::numeric_limits<uint32_t>::max()) {
+        throw OutOfRange("write batch too large");
+    }
+    putU32(frame.data(), static_cast<uint32_t>(payloadSize));
+    putU32(frame.data() + 4, crc32c(BytesConstRef(frame.data() + c_frameHeaderSize, payloadSize)));
+
+    if (m_segments.back()->size > 0 && m_segments.back()->size + frame.size() > m_options.maxSegmentSize) {
+        rotate();
+    }
+    auto& segment = m_segments.back();
+    // 写入失败时不移动写入位置，并截掉写了一部分的数据，否则切换段文件后它会留在非最后一个段文件的末尾，
+    // 下次打开时被当作损坏（这里截断失败时切换段文件前还会再截断一次）
+    if (!pwriteAll(segment->fd, frame.data(), frame.size(), segment->size)) {
+        auto e = ioError("write " + segment->path + " failed");
+        if (ftruncate(segment->fd, segment->size) < 0) {
+            e = ioError("write " + segment->path + " failed, ftruncate failed");
+        }
+        throw e;
+    }
+    if (sync && fdatasync(segment->fd) < 0) {
+        throw ioError("fdatasync " + segment->path + " failed");
+    }
+    uint64_t offset = segment->size;
+    segment->size += frame.size();
+    return offset;
+}
+
+// 读取存储的原始数据
+void LogKVStore::loadRaw(const Location& loc, Bytes& raw) {
+    raw.resize(loc.size);
+    if (preadAll(loc.segment->fd, raw.data(), raw.size(), loc.offset) != raw.size()) {
+        throw StorageCorrupted("value out of range in " + loc.segment->path);
+    }
+}
+
+// 读取值（需要时解压）
+void LogKVStore::load(const Location& loc, Bytes& value) {
+    if (loc.compressed) {
+        Bytes raw;
+        loadRaw(loc, raw);
+        value = SnappyCompress::uncompress(raw);
+    } else {
+        loadRaw(loc, value);
+    }
+}
+
+// 在索引中读取
+bool LogKVStore::get(const Index& index, BytesConstRef key, Bytes& value) {
+    auto it = index.find(SmallBytes(key));
+    if (it == index.end()) {
+        return false;
+    }
+    load(it->second, value);
+    return true;
+}
+
+// 在索引中按前缀遍历
+void LogKVStore::forEach(const Index& index, BytesConstRef prefix, const KVVisitor& visitor) {
+    Bytes value;
+    for (auto it = index.lower_bound(SmallBytes(prefix)); it != index.end(); ++it) {
+        auto& key = it->first;
+        if (!hasPrefix(key, prefix)) {
+            break;
+        }
+        load(it->second, value);
+        if (!visitor(key.ref(), value)) {
+            break;
+        }
+    }
+}
+
+}   // namespace dev
@@ -0,0 +1,102 @@
+/**
+ * 日志结构的磁盘键值存储
+ * @file: LogKVStore.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <string>
+#include "KVStore.h"
+
+namespace dev {
+
+// 磁盘存储选项
+struct LogKVOptions : public KVOptions {
+    uint64_t maxSegmentSize = 64 << 20;     // 单个段文件的最大长度，超过后切换到新的段文件
+};
+
+/**
+ * 日志结构的磁盘存储（类似Bitcask）：
+ * 1. 数据目录中有若干个编号递增的段文件（000001.log, ...），只有最后一个段文件可以追加写入
+ * 2. 每个WriteBatch编码为一帧：[4字节长度][4字节CRC32C][记录...]，一次pwrite写入，
+ *    sync为true时再调用一次fdatasync，批量提交时fsync的开销被整批数据分摊
+ * 3. 内存中的有序索引记录每个键的值所在的段文件和偏移，读取只需要一次pread
+ * 4. 打开时按顺序回放所有段文件重建索引，最后一个段文件末尾不完整或校验失败的帧
+ *    （写入过程中宕机）会被截掉，因此一个WriteBatch要么全部生效，要么全部不生效
+ * 5. 覆盖和删除的旧数据仍然占用磁盘空间，compact()把存活的键值重写到新的段文件并删除旧的段文件
+ * 快照持有创建时的索引，引用的段文件在快照释放前不会被关闭
+ */
+class LogKVStore : public KVStore {
+public:
+    /**
+     * 打开数据目录（不存在时创建），回放段文件重建索引
+     * @param dir 数据目录
+     * @param options 存储选项
+     * @throw 无法读写文件抛出StorageIOError异常，段文件损坏抛出StorageCorrupted异常
+     */
+    explicit LogKVStore(const std::string& dir, const LogKVOptions& options = LogKVOptions());
+
+    ~LogKVStore();
+
+    LogKVStore(const LogKVStore&) = delete;
+    LogKVStore& operator=(const LogKVStore&) = delete;
+
+    bool get(BytesConstRef key, Bytes& value) const override;
+    void write(const WriteBatch& batch, bool sync = false) override;
+    void forEach(BytesConstRef prefix, const KVVisitor& visitor) const override;
+    KVSnapshot::Ptr snapshot() const override;
+
+    // 把存活的键值重写到新的段文件，删除旧的段文件
+    void compact();
+
+    // 键值对个数
+    size_t size() const;
+
+    // 段文件个数
+    size_t segmentCount() const;
+
+    // 所有段文件的总长度
+    uint64_t diskSize() const;
+
+private:
+    struct Segment;
+    using SegmentPtr = std::shared_ptr<Segment>;
+
+    // 值在段文件中的位置
+    struct Location {
+        SegmentPtr segment;             // 所在的段文件
+        uint64_t offset;                // 偏移
+        uint32_t size;                  // 长度
+        bool compressed;                // 是否经过压缩
+    };
+    using Index = std::map<SmallBytes, Location, SmallBytesLess>;
+
+    class Snapshot;
+
+    // 回放段文件，返回有效数据的长度
+    uint64_t replay(const SegmentPtr& segment, bool last);
+
+    // 创建新的段文件作为当前写入的段文件（之前的段文件先截掉有效数据之后的内容并落盘）
+    void rotate();
+
+    // 填写帧头，追加到当前段文件（当前段文件写满时先切换），返回帧在段文件中的偏移
+    uint64_t append(Bytes& frame, bool sync);
+
+    // 读取存储的原始数据/值（需要时解压）
+    static void loadRaw(const Location& loc, Bytes& raw);
+    static void load(const Location& loc, Bytes& value);
+
+    // 在索引中读取/遍历
+    static bool get(const Index& index, BytesConstRef key, Bytes& value);
+    static void forEach(const Index& index, BytesConstRef prefix, const KVVisitor& visitor);
+
+    std::string m_dir;                  // 数据目录
+    LogKVOptions m_options;
+    mutable Mutex m_mutex;
+    std::shared_ptr<Index> m_index;     // 当前索引（被快照引用时写入前先复制）
+    std::vector<SegmentPtr> m_segments; // 所有段文件（按编号递增，最后一个是当前写入的段文件）
+    uint64_t m_nextSegmentId = 1;       // 下一个段文件的编号
+};
+
+}   // namespace dev
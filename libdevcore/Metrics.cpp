@@ -0,0 +1,276 @@
+/**
+ * 监控指标（计数器，仪表，直方图），导出为Prometheus文本格式
+ * @file: Metrics.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace dev {
+
+// 缓存行能容纳的计数个数
+static const size_t c_cellsPerLine = 64 / sizeof(std::atomic<uint64_t>);
+
+// 当前线程使用的分片
+size_t metricShard() noexcept {
+    static std::atomic<size_t> s_nextShard{0};
+    static thread_local size_t t_shard = s_nextShard.fetch_add(1, std::memory_order_relaxed) % c_metricShards;
+    return t_shard;
+}
+
+MetricCells::MetricCells(size_t perShard)
+: m_stride((perShard + c_cellsPerLine - 1) / c_cellsPerLine * c_cellsPerLine),
+  // 多分配一个缓存行用于对齐，值初始化保证所有计数为0
+  m_storage(new std::atomic<uint64_t>[c_metricShards * m_stride + c_cellsPerLine]()) {
+    uintptr_t p = reinterpret_cast<uintptr_t>(m_storage.get());
+    m_base = reinterpret_cast<std::atomic<uint64_t>*>((p + 63) & ~uintptr_t(63));
+}
+
+// 所有分片中第i个计数的和
+uint64_t MetricCells::sum(size_t i) const noexcept {
+    uint64_t total = 0;
+    for (size_t shard = 0; shard < c_metricShards; ++shard) {
+        total += at(shard, i).load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// 格式化浮点数（使用能精确还原的最短表示）
+static std::string formatDouble(double v) {
+    if (std::isnan(v)) {
+        return "NaN";
+    }
+    if (std::isinf(v)) {
+        return v > 0 ? "+Inf" : "-Inf";
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.15g", v);
+    if (strtod(buf, nullptr) != v) {
+        snprintf(buf, sizeof(buf), "%.17g", v);
+    }
+    return buf;
+}
+
+// 输出一行样本：name{labels} value
+static void appendSample(std::string& out, const std::string& name, const std::string& labels, const std::string& value) {
+    out += name;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+void Counter::expose(std::string& out, const std::string& name, const std::string& labels) const {
+    appendSample(out, name, labels, std::to_string(value()));
+}
+
+void Gauge::expose(std::string& out, const std::string& name, const std::string& labels) const {
+    appendSample(out, name, labels, std::to_string(value()));
+}
+
+Histogram::Histogram(const std::vector<double>& bounds) : m_bounds(bounds), m_cells(bounds.size() + 2) {
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        if (std::isnan(m_bounds[i]) || (i > 0 && m_bounds[i] <= m_bounds[i - 1])) {
+            throw BadMetric("histogram bounds must be strictly increasing");
+        }
+    }
+}
+
+// 记录一个值
+void Histogram::observe(double v) noexcept {
+    // 第一个上界不小于v的桶，都小于v时落在+Inf桶
+    size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), v) - m_bounds.begin();
+    m_cells.local(bucket).fetch_add(1, std::memory_order_relaxed);
+
+    // 和以double的位模式保存在分片的最后一个计数中，分片基本只有本线程写，CAS几乎不会失败
+    std::atomic<uint64_t>& cell = m_cells.local(m_bounds.size() + 1);
+    uint64_t expected = cell.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+        double sum;
+        memcpy(&sum, &expected, sizeof(sum));
+        sum += v;
+        memcpy(&desired, &sum, sizeof(sum));
+    } while (!cell.compare_exchange_weak(expected, desired, std::memory_order_relaxed));
+}
+
+// 记录次数
+uint64_t Histogram::count() const noexcept {
+    uint64_t total = 0;
+    for (size_t i = 0; i <= m_bounds.size(); ++i) {
+        total += m_cells.sum(i);
+    }
+    return total;
+}
+
+// 所有值的和
+double Histogram::sum() const noexcept {
+    double total = 0;
+    for (size_t shard = 0; shard < c_metricShards; ++shard) {
+        uint64_t bits = m_cells.at(shard, m_bounds.size() + 1).load(std::memory_order_relaxed);
+        double v;
+        memcpy(&v, &bits, sizeof(v));
+        total += v;
+    }
+    return total;
+}
+
+void Histogram::expose(std::string& out, const std::string& name, const std::string& labels) const {
+    std::string prefix = labels.empty() ? "" : labels + ",";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= m_bounds.size(); ++i) {
+        cumulative += m_cells.sum(i);
+        std::string le = i < m_bounds.size() ? formatDouble(m_bounds[i]) : "+Inf";
+        appendSample(out, name + "_bucket", prefix + "le=\"" + le + "\"", std::to_string(cumulative));
+    }
+    appendSample(out, name + "_sum", labels, formatDouble(sum()));
+    appendSample(out, name + "_count", labels, std::to_string(cumulative));
+}
+
+// 指数增长的桶上界
+std::vector<double> Histogram::exponentialBuckets(double start, double factor, size_t count) {
+    if (start <= 0 || factor <= 1) {
+        throw BadMetric("exponential buckets need start > 0 and factor > 1");
+    }
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (size_t i = 0; i < count; ++i, start *= factor) {
+        bounds.push_back(start);
+    }
+    return bounds;
+}
+
+// 默认的延迟桶（秒）：10us到10s，每个数量级1，2.5，5三档
+const std::vector<double>& Histogram::latencyBuckets() {
+    static const std::vector<double> s_bounds = {
+        0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+        0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10
+    };
+    return s_bounds;
+}
+
+// 进程内的全局注册表
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry* s_registry = new MetricsRegistry();
+    return *s_registry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::string formatted;
+    Guard l(m_mutex);
+    auto& metric = family(name, help, Type::Counter, labels, formatted).metrics[formatted];
+    if (!metric) {
+        metric.reset(new Counter());
+    }
+    return static_cast<Counter&>(*metric);
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::string formatted;
+    Guard l(m_mutex);
+    auto& metric = family(name, help, Type::Gauge, labels, formatted).metrics[formatted];
+    if (!metric) {
+        metric.reset(new Gauge());
+    }
+    return static_cast<Gauge&>(*metric);
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+    const std::vector<double>& bounds, const MetricLabels& labels) {
+    std::string formatted;
+    Guard l(m_mutex);
+    auto& metric = family(name, help, Type::Histogram, labels, formatted).metrics[formatted];
+    if (!metric) {
+        metric.reset(new Histogram(bounds));
+    }
+    return static_cast<Histogram&>(*metric);
+}
+
+// 名称是否合法（allowColon为false时是标签名）
+static bool validName(const std::string& name, bool allowColon) {
+    if (name.empty()) {
+        return false;
+    }
+    for (size_t i = 0; i < name.size(); ++i) {
+        char c = name[i];
+        bool ok = ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || '_' == c || (allowColon && ':' == c)
+            || (i > 0 && '0' <= c && c <= '9');
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 转义说明（反斜杠和换行）或标签值（另外还有双引号）
+static std::string escape(const std::string& s, bool quote) {
+    std::string ret;
+    ret.reserve(s.size());
+    for (char c : s) {
+        if ('\\' == c) {
+            ret += "\\\\";
+        } else if ('\n' == c) {
+            ret += "\\n";
+        } else if (quote && '"' == c) {
+            ret += "\\\"";
+        } else {
+            ret += c;
+        }
+    }
+    return ret;
+}
+
+// 查找或创建族，返回格式化后的标签（按标签名排序）
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help, Type type,
+    const MetricLabels& labels, std::string& formatted) {
+    if (!validName(name, true)) {
+        throw BadMetric("invalid metric name: " + name);
+    }
+    MetricLabels sorted(labels);
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        auto& label = sorted[i].first;
+        if (!validName(label, false) || 0 == label.compare(0, 2, "__")
+            || (Type::Histogram == type && "le" == label) || (i > 0 && label == sorted[i - 1].first)) {
+            throw BadMetric("invalid label name of " + name + ": " + label);
+        }
+        formatted += (i > 0 ? "," : "") + label + "=\"" + escape(sorted[i].second, true) + "\"";
+    }
+
+    auto it = m_families.find(name);
+    if (it == m_families.end()) {
+        it = m_families.emplace(name, Family()).first;
+        it->second.type = type;
+        it->second.help = help;
+    } else if (it->second.type != type) {
+        throw BadMetric("metric " + name + " registered with another type");
+    }
+    return it->second;
+}
+
+// 导出为Prometheus文本格式
+std::string MetricsRegistry::toPrometheus() const {
+    static const char* const c_typeNames[] = {"counter", "gauge", "histogram"};
+    std::string out;
+    Guard l(m_mutex);
+    for (auto& entry : m_families) {
+        auto& family = entry.second;
+        out += "# HELP " + entry.first + " " + escape(family.help, false) + "\n";
+        out += "# TYPE " + entry.first + " " + c_typeNames[static_cast<int>(family.type)] + "\n";
+        for (auto& metric : family.metrics) {
+            metric.second->expose(out, entry.first, metric.first);
+        }
+    }
+    return out;
+}
+
+}   // namespace dev
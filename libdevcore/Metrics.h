@@ -0,0 +1,206 @@
+/**
+ * 监控指标（计数器，仪表，直方图），导出为Prometheus文本格式
+ * @file: Metrics.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Common.h"
+#include "Guards.h"
+
+namespace dev {
+
+/**
+ * 哈希，签名，RLP，压缩，线程池等子系统在热点路径上更新指标，运维通过Prometheus采集吞吐和延迟。
+ * 1. 更新不加锁：计数器和直方图的值分散在c_metricShards个按缓存行对齐的分片中，
+ *    每个线程固定使用一个分片（按线程创建顺序轮流分配，近似于每个CPU一个分片），
+ *    relaxed原子加，不同线程之间基本没有缓存行争用；读取时把所有分片加起来
+ * 2. 仪表需要支持set()，只有一个原子变量
+ * 3. 注册和导出需要加锁，注册的指标永远不会被删除，返回的引用一直有效，
+ *    热点路径上应该用函数内的静态引用缓存注册结果
+ * 4. 同名的指标组成一族，族内按标签区分，名称和类型不能冲突
+ */
+
+// 指标标签（名称，值）
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// 分片个数
+constexpr size_t c_metricShards = 16;
+
+// 当前线程使用的分片
+size_t metricShard() noexcept;
+
+// 分片存储的原子计数（每个分片的起始地址按缓存行对齐）
+class MetricCells {
+public:
+    explicit MetricCells(size_t perShard);
+
+    MetricCells(const MetricCells&) = delete;
+    MetricCells& operator=(const MetricCells&) = delete;
+
+    // 当前线程的分片中的第i个计数
+    std::atomic<uint64_t>& local(size_t i) noexcept { return m_base[metricShard() * m_stride + i]; }
+
+    // 第shard个分片中的第i个计数
+    const std::atomic<uint64_t>& at(size_t shard, size_t i) const noexcept { return m_base[shard * m_stride + i]; }
+
+    // 所有分片中第i个计数的和
+    uint64_t sum(size_t i) const noexcept;
+
+private:
+    size_t m_stride;                                    // 每个分片占用的计数个数（缓存行的整数倍）
+    std::unique_ptr<std::atomic<uint64_t>[]> m_storage;
+    std::atomic<uint64_t>* m_base;                      // 对齐后的起始地址
+};
+
+// 指标（注册表内部使用的基类）
+class Metric {
+public:
+    virtual ~Metric() = default;
+
+    // 以Prometheus文本格式输出样本
+    virtual void expose(std::string& out, const std::string& name, const std::string& labels) const = 0;
+};
+
+// 单调递增的计数器
+class Counter : public Metric {
+public:
+    Counter() : m_cells(1) {}
+
+    // 增加n
+    void inc(uint64_t n = 1) noexcept { m_cells.local(0).fetch_add(n, std::memory_order_relaxed); }
+
+    // 当前值
+    uint64_t value() const noexcept { return m_cells.sum(0); }
+
+    void expose(std::string& out, const std::string& name, const std::string& labels) const override;
+
+private:
+    MetricCells m_cells;
+};
+
+// 可增可减的仪表
+class Gauge : public Metric {
+public:
+    // 设置为v
+    void set(int64_t v) noexcept { m_value.store(v, std::memory_order_relaxed); }
+
+    // 增加n（n可以为负数）
+    void add(int64_t n) noexcept { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+    // 当前值
+    int64_t value() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+    void expose(std::string& out, const std::string& name, const std::string& labels) const override;
+
+private:
+    std::atomic<int64_t> m_value{0};
+};
+
+// 直方图（每个桶只统计落在该桶内的次数，导出时再累加为Prometheus的le桶）
+class Histogram : public Metric {
+public:
+    /**
+     * @param bounds 各个桶的上界（包含，严格递增，最后隐含一个+Inf桶）
+     * @throw bounds不是严格递增抛出BadMetric异常
+     */
+    explicit Histogram(const std::vector<double>& bounds);
+
+    // 记录一个值
+    void observe(double v) noexcept;
+
+    // 各个桶的上界
+    const std::vector<double>& bounds() const noexcept { return m_bounds; }
+
+    // 落在第i个桶内的次数（i == bounds().size()表示+Inf桶）
+    uint64_t bucketCount(size_t i) const noexcept { return m_cells.sum(i); }
+
+    // 记录次数
+    uint64_t count() const noexcept;
+
+    // 所有值的和
+    double sum() const noexcept;
+
+    void expose(std::string& out, const std::string& name, const std::string& labels) const override;
+
+    // 指数增长的桶上界：start, start * factor, ...（共count个）
+    static std::vector<double> exponentialBuckets(double start, double factor, size_t count);
+
+    // 默认的延迟桶（秒）：10us到10s
+    static const std::vector<double>& latencyBuckets();
+
+private:
+    std::vector<double> m_bounds;
+    MetricCells m_cells;                // 每个分片：各个桶的计数 + 和（double的位模式）
+};
+
+// 记录作用域耗时（秒）到直方图
+class HistogramTimer {
+public:
+    explicit HistogramTimer(Histogram& histogram) noexcept
+    : m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+
+    ~HistogramTimer() {
+        m_histogram.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    HistogramTimer(const HistogramTimer&) = delete;
+    HistogramTimer& operator=(const HistogramTimer&) = delete;
+
+private:
+    Histogram& m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// 指标注册表
+class MetricsRegistry {
+public:
+    // 进程内的全局注册表（永不析构，其它静态对象析构时也可以安全地更新指标）
+    static MetricsRegistry& instance();
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * 注册（或获取已经注册的）指标，名称和标签都相同时返回同一个对象
+     * @param name 指标名称（[a-zA-Z_:][a-zA-Z0-9_:]*）
+     * @param help 说明（以第一次注册的为准）
+     * @param labels 标签
+     * @throw 名称或标签名不合法，或者同名指标的类型不同抛出BadMetric异常
+     */
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = MetricLabels());
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = MetricLabels());
+    Histogram& histogram(const std::string& name, const std::string& help,
+        const std::vector<double>& bounds = Histogram::latencyBuckets(), const MetricLabels& labels = MetricLabels());
+
+    // 导出为Prometheus文本格式（0.0.4）
+    std::string toPrometheus() const;
+
+private:
+    enum class Type { Counter, Gauge, Histogram };
+
+    // 同名的一族指标
+    struct Family {
+        Type type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Metric>> metrics;     // 格式化后的标签 => 指标
+    };
+
+    // 查找或创建族，返回格式化后的标签
+    Family& family(const std::string& name, const std::string& help, Type type,
+        const MetricLabels& labels, std::string& formatted);
+
+    mutable Mutex m_mutex;
+    std::map<std::string, Family> m_families;
+};
+
+}   // namespace dev
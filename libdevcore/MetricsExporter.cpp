@@ -0,0 +1,228 @@
+/**
+ * 监控指标导出（内置HTTP端点，node_exporter文本文件）
+ * @file: MetricsExporter.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "MetricsExporter.h"
+#include "Log.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+namespace dev {
+
+// 请求头的最大长度
+static const size_t c_maxRequestSize = 8192;
+
+// 单个连接的读写超时
+static const int c_connectionTimeoutMs = 2000;
+
+// 后台线程检查停止标志的间隔
+static const int c_pollIntervalMs = 200;
+
+// 带errno描述的IO异常
+static MetricsIOError ioError(const std::string& what) {
+    return MetricsIOError(what + ": " + strerror(errno));
+}
+
+// 完整写入（忽略对端关闭等错误）
+static void writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        size -= n;
+    }
+}
+
+// 把注册表以Prometheus文本格式写入文件
+void writeMetricsTextfile(const std::string& path, const MetricsRegistry& registry) {
+    std::string text = registry.toPrometheus();
+    std::string tmp = path + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw ioError("open " + tmp + " failed");
+    }
+    const char* p = text.data();
+    size_t left = text.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            auto e = ioError("write " + tmp + " failed");
+            close(fd);
+            unlink(tmp.c_str());
+            throw e;
+        }
+        p += n;
+        left -= n;
+    }
+    close(fd);
+    if (rename(tmp.c_str(), path.c_str()) < 0) {
+        auto e = ioError("rename " + tmp + " failed");
+        unlink(tmp.c_str());
+        throw e;
+    }
+}
+
+// 监听地址并启动后台线程
+MetricsHTTPServer::MetricsHTTPServer(const std::string& address, uint16_t port, const MetricsRegistry& registry)
+: m_registry(registry) {
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        throw MetricsIOError("invalid metrics address: " + address);
+    }
+
+    m_listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        throw ioError("socket failed");
+    }
+    int on = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    socklen_t len = sizeof(addr);
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0
+        || listen(m_listenFd, 16) < 0
+        || getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+        auto e = ioError("listen on " + address + ":" + std::to_string(port) + " failed");
+        close(m_listenFd);
+        throw e;
+    }
+    m_port = ntohs(addr.sin_port);
+    m_thread = std::thread([this] { run(); });
+}
+
+// 停止后台线程并关闭监听
+MetricsHTTPServer::~MetricsHTTPServer() {
+    m_stop = true;
+    m_thread.join();
+    close(m_listenFd);
+}
+
+// 后台线程：等待连接（定期检查停止标志）
+void MetricsHTTPServer::run() {
+    while (!m_stop) {
+        pollfd pfd;
+        pfd.fd = m_listenFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, c_pollIntervalMs) <= 0) {
+            continue;
+        }
+        int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        serve(fd);
+        close(fd);
+    }
+}
+
+// 处理一个连接
+void MetricsHTTPServer::serve(int fd) {
+    timeval timeout;
+    timeout.tv_sec = c_connectionTimeoutMs / 1000;
+    timeout.tv_usec = c_connectionTimeoutMs % 1000 * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // 读取到请求头结束（不支持请求体）
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < c_maxRequestSize) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && EINTR == errno) {
+            continue;
+        }
+        if (n <= 0) {
+            return;
+        }
+        request.append(buf, n);
+    }
+
+    // 请求行：METHOD SP PATH SP VERSION，忽略查询参数
+    std::string line = request.substr(0, request.find("\r\n"));
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : line.find(' ', sp1 + 1);
+    std::string method = line.substr(0, sp1);
+    std::string path = sp2 == std::string::npos ? "" : line.substr(sp1 + 1, sp2 - sp1 - 1);
+    path = path.substr(0, path.find('?'));
+
+    std::string status;
+    std::string contentType = "text/plain; charset=utf-8";
+    std::string body;
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+        body = "method not allowed\n";
+    } else if (path != "/metrics") {
+        status = "404 Not Found";
+        body = "not found\n";
+    } else {
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = m_registry.toPrometheus();
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: " + contentType + "\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n";
+    if (method != "HEAD") {
+        response += body;
+    }
+    writeAll(fd, response.data(), response.size());
+}
+
+// 启动后台线程
+MetricsTextfileWriter::MetricsTextfileWriter(const std::string& path, std::chrono::milliseconds interval,
+    const MetricsRegistry& registry)
+: m_path(path), m_interval(interval), m_registry(registry) {
+    m_thread = std::thread([this] {
+        write();
+        UniqueLock l(m_mutex);
+        while (!m_cv.wait_for(l, m_interval, [this] { return m_stop; })) {
+            l.unlock();
+            write();
+            l.lock();
+        }
+    });
+}
+
+// 停止后台线程（停止前再写一次）
+MetricsTextfileWriter::~MetricsTextfileWriter() {
+    {
+        Guard l(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+    write();
+}
+
+// 写入一次（忽略错误）
+void MetricsTextfileWriter::write() noexcept {
+    try {
+        writeMetricsTextfile(m_path, m_registry);
+    } catch (const std::exception& e) {
+        LOG(Warning) << LOG_BADGE("Metrics") << LOG_DESC("write textfile failed") << LOG_KV("error", e.what());
+    }
+}
+
+}   // namespace dev
@@ -0,0 +1,94 @@
+/**
+ * 监控指标导出（内置HTTP端点，node_exporter文本文件）
+ * @file: MetricsExporter.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include "Guards.h"
+#include "Metrics.h"
+
+namespace dev {
+
+/**
+ * 把注册表以Prometheus文本格式写入文件（供node_exporter的textfile collector采集）
+ * 先写临时文件再rename，采集方不会读到写了一半的文件
+ * @throw 写文件失败抛出MetricsIOError异常
+ */
+void writeMetricsTextfile(const std::string& path, const MetricsRegistry& registry = MetricsRegistry::instance());
+
+/**
+ * 最简单的HTTP端点：GET /metrics返回Prometheus文本格式，其它路径返回404
+ * 只有一个后台线程，逐个处理连接，每个连接只处理一个请求（Prometheus每次采集都新建连接）
+ */
+class MetricsHTTPServer {
+public:
+    /**
+     * 监听地址并启动后台线程
+     * @param address 监听的IPv4地址（如127.0.0.1，0.0.0.0）
+     * @param port 监听端口（0表示由系统分配）
+     * @throw 地址不合法或者监听失败抛出MetricsIOError异常
+     */
+    MetricsHTTPServer(const std::string& address, uint16_t port,
+        const MetricsRegistry& registry = MetricsRegistry::instance());
+
+    // 停止后台线程并关闭监听
+    ~MetricsHTTPServer();
+
+    MetricsHTTPServer(const MetricsHTTPServer&) = delete;
+    MetricsHTTPServer& operator=(const MetricsHTTPServer&) = delete;
+
+    // 实际监听的端口
+    uint16_t port() const noexcept { return m_port; }
+
+private:
+    // 后台线程
+    void run();
+
+    // 处理一个连接
+    void serve(int fd);
+
+    const MetricsRegistry& m_registry;
+    int m_listenFd = -1;
+    uint16_t m_port = 0;
+    std::atomic<bool> m_stop{false};
+    std::thread m_thread;
+};
+
+// 周期性地把注册表写入文件
+class MetricsTextfileWriter {
+public:
+    /**
+     * 启动后台线程，立即写一次，之后每隔interval写一次（写失败时跳过，下次重试）
+     * @param path 输出文件路径
+     * @param interval 写入间隔
+     */
+    MetricsTextfileWriter(const std::string& path, std::chrono::milliseconds interval,
+        const MetricsRegistry& registry = MetricsRegistry::instance());
+
+    // 停止后台线程（停止前再写一次）
+    ~MetricsTextfileWriter();
+
+    MetricsTextfileWriter(const MetricsTextfileWriter&) = delete;
+    MetricsTextfileWriter& operator=(const MetricsTextfileWriter&) = delete;
+
+private:
+    // 写入一次（忽略错误）
+    void write() noexcept;
+
+    std::string m_path;
+    std::chrono::milliseconds m_interval;
+    const MetricsRegistry& m_registry;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+}   // namespace dev
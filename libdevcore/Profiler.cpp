@@ -0,0 +1,383 @@
+/**
+ * 热点路径性能剖析（纳秒级作用域计时，按线程聚合）
+ * @file: Profiler.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <json/json.h>
+#include <unistd.h>
+
+namespace dev {
+
+constexpr unsigned LatencyHistogram::c_subBucketBits;
+constexpr unsigned LatencyHistogram::c_subBuckets;
+constexpr unsigned LatencyHistogram::c_bucketCount;
+constexpr size_t Profiler::c_maxScopes;
+constexpr size_t Profiler::c_traceCapacity;
+
+// 合并另一个直方图
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    for (unsigned i = 0; i < c_bucketCount; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+// 百分位数（返回所在桶的上界，不超过最大值）
+uint64_t LatencyHistogram::percentile(double p) const noexcept {
+    if (0 == count) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * count + 0.5);
+    rank = std::max<uint64_t>(1, std::min(rank, count));
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < c_bucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::max(min, std::min(max, bucketUpper(i)));
+        }
+    }
+    return max;
+}
+
+namespace {
+
+// 单个线程中一个作用域的直方图（只有所属线程写，其它线程只读，用relaxed的load/store即可）
+struct ThreadHistogram {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[LatencyHistogram::c_bucketCount];
+
+    ThreadHistogram() noexcept : count(0), sum(0), min(std::numeric_limits<uint64_t>::max()), max(0) {
+        for (auto& b : buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 单写者的自增（不需要带lock前缀的原子读改写）
+    static void add(std::atomic<uint64_t>& a, uint64_t v) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t ns) noexcept {
+        add(count, 1);
+        add(sum, ns);
+        if (ns < min.load(std::memory_order_relaxed)) {
+            min.store(ns, std::memory_order_relaxed);
+        }
+        if (ns > max.load(std::memory_order_relaxed)) {
+            max.store(ns, std::memory_order_relaxed);
+        }
+        add(buckets[LatencyHistogram::bucketOf(ns)], 1);
+    }
+
+    // 累加到快照中的直方图
+    void mergeInto(LatencyHistogram& h) const noexcept {
+        h.count += count.load(std::memory_order_relaxed);
+        h.sum += sum.load(std::memory_order_relaxed);
+        h.min = std::min(h.min, min.load(std::memory_order_relaxed));
+        h.max = std::max(h.max, max.load(std::memory_order_relaxed));
+        for (unsigned i = 0; i < LatencyHistogram::c_bucketCount; ++i) {
+            h.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// 一次调用的追踪事件
+struct TraceEvent {
+    uint32_t scope;                     // 作用域编号
+    uint64_t start;                     // 开始时间（ns）
+    uint64_t duration;                  // 耗时（ns）
+};
+
+// 单个线程的剖析数据（线程退出后仍然保留在注册表中）
+struct ThreadProfile {
+    uint64_t tid;                                                   // 线程序号
+    std::atomic<ThreadHistogram*> scopes[Profiler::c_maxScopes];    // 各个作用域的直方图（按需分配）
+    std::atomic<TraceEvent*> events;                                // 追踪事件环形缓冲区（按需分配）
+    std::atomic<uint64_t> eventCount;                               // 记录过的追踪事件总数
+
+    explicit ThreadProfile(uint64_t id) noexcept : tid(id), events(nullptr), eventCount(0) {
+        for (auto& scope : scopes) {
+            scope.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadProfile() {
+        for (auto& scope : scopes) {
+            delete scope.load(std::memory_order_relaxed);
+        }
+        delete[] events.load(std::memory_order_relaxed);
+    }
+};
+
+// 全局注册表（故意不释放，保证线程局部变量析构时仍然可用）
+struct ProfileRegistry {
+    Mutex mutex;
+    std::map<std::string, size_t> ids;                      // 名称到编号
+    std::vector<std::string> names;                         // 编号到名称
+    std::vector<std::shared_ptr<ThreadProfile>> threads;    // 所有线程
+    std::atomic<bool> tracing{false};                       // 是否记录追踪事件
+};
+
+ProfileRegistry& registry() {
+    static ProfileRegistry* s_registry = new ProfileRegistry();
+    return *s_registry;
+}
+
+// 当前线程的剖析数据
+ThreadProfile& threadProfile() {
+    static thread_local std::shared_ptr<ThreadProfile> t_profile;
+    if (!t_profile) {
+        auto& r = registry();
+        Guard l(r.mutex);
+        t_profile = std::make_shared<ThreadProfile>(r.threads.size() + 1);
+        r.threads.push_back(t_profile);
+    }
+    return *t_profile;
+}
+
+}   // namespace
+
+// 注册作用域，同名的作用域返回相同的编号
+size_t Profiler::registerScope(const std::string& name) {
+    auto& r = registry();
+    Guard l(r.mutex);
+    auto it = r.ids.find(name);
+    if (it != r.ids.end()) {
+        return it->second;
+    }
+    if (r.names.size() >= c_maxScopes) {
+        return c_maxScopes;
+    }
+    r.names.push_back(name);
+    r.ids[name] = r.names.size() - 1;
+    return r.names.size() - 1;
+}
+
+// 记录一次耗时
+void Profiler::record(size_t scope, uint64_t start, uint64_t ns) noexcept {
+    if (scope >= c_maxScopes) {
+        return;
+    }
+    auto& profile = threadProfile();
+    ThreadHistogram* h = profile.scopes[scope].load(std::memory_order_relaxed);
+    if (!h) {
+        h = new ThreadHistogram();
+        profile.scopes[scope].store(h, std::memory_order_release);
+    }
+    h->record(ns);
+
+    if (registry().tracing.load(std::memory_order_relaxed)) {
+        TraceEvent* events = profile.events.load(std::memory_order_relaxed);
+        if (!events) {
+            events = new TraceEvent[c_traceCapacity];
+            profile.events.store(events, std::memory_order_release);
+        }
+        uint64_t idx = profile.eventCount.load(std::memory_order_relaxed);
+        events[idx % c_traceCapacity] = TraceEvent{static_cast<uint32_t>(scope), start, ns};
+        profile.eventCount.store(idx + 1, std::memory_order_release);
+    }
+}
+
+// 合并所有线程的统计
+ProfileSnapshot Profiler::snapshot() {
+    auto& r = registry();
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<ThreadProfile>> threads;
+    {
+        Guard l(r.mutex);
+        names = r.names;
+        threads = r.threads;
+    }
+
+    ProfileSnapshot ret;
+    for (size_t scope = 0; scope < names.size(); ++scope) {
+        ScopeStats stats;
+        for (auto& thread : threads) {
+            auto h = thread->scopes[scope].load(std::memory_order_acquire);
+            if (h) {
+                h->mergeInto(stats.histogram);
+            }
+        }
+        if (stats.histogram.count > 0) {
+            stats.name = names[scope];
+            ret.push_back(std::move(stats));
+        }
+    }
+    std::sort(ret.begin(), ret.end(), [](const ScopeStats& a, const ScopeStats& b) { return a.name < b.name; });
+    return ret;
+}
+
+// 两次快照之间的增量
+ProfileSnapshot Profiler::diff(const ProfileSnapshot& now, const ProfileSnapshot& before) {
+    ProfileSnapshot ret;
+    auto prev = before.begin();
+    for (auto& stats : now) {
+        while (prev != before.end() && prev->name < stats.name) {
+            ++prev;
+        }
+        ScopeStats delta;
+        delta.name = stats.name;
+        auto& h = delta.histogram;
+        h.count = stats.histogram.count;
+        h.sum = stats.histogram.sum;
+        h.buckets = stats.histogram.buckets;
+        if (prev != before.end() && prev->name == stats.name) {
+            h.count -= prev->histogram.count;
+            h.sum -= prev->histogram.sum;
+            for (unsigned i = 0; i < LatencyHistogram::c_bucketCount; ++i) {
+                h.buckets[i] -= prev->histogram.buckets[i];
+            }
+        }
+        if (0 == h.count) {
+            continue;
+        }
+
+        // 增量的最小值和最大值只能由非空桶的边界估计
+        for (unsigned i = 0; i < LatencyHistogram::c_bucketCount; ++i) {
+            if (h.buckets[i]) {
+                h.min = std::max(stats.histogram.min, LatencyHistogram::bucketLower(i));
+                break;
+            }
+        }
+        for (unsigned i = LatencyHistogram::c_bucketCount; i > 0; --i) {
+            if (h.buckets[i - 1]) {
+                h.max = std::min(stats.histogram.max, LatencyHistogram::bucketUpper(i - 1));
+                break;
+            }
+        }
+        ret.push_back(std::move(delta));
+    }
+    return ret;
+}
+
+// 开启/关闭追踪事件记录
+void Profiler::setTracing(bool enable) noexcept {
+    registry().tracing.store(enable, std::memory_order_relaxed);
+}
+
+bool Profiler::tracing() noexcept {
+    return registry().tracing.load(std::memory_order_relaxed);
+}
+
+// 导出为文本表格（时间单位为微秒）
+std::string Profiler::toText(const ProfileSnapshot& snapshot) {
+    std::string ret;
+    char line[256];
+    snprintf(line, sizeof(line), "%-32s %12s %12s %12s %12s %12s %12s\n",
+        "scope", "count", "mean(us)", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+    ret += line;
+    for (auto& stats : snapshot) {
+        auto& h = stats.histogram;
+        snprintf(line, sizeof(line), "%-32s %12llu %12.3f %12.3f %12.3f %12.3f %12.3f\n",
+            stats.name.c_str(), static_cast<unsigned long long>(h.count), h.mean() / 1e3,
+            h.percentile(0.5) / 1e3, h.percentile(0.9) / 1e3, h.percentile(0.99) / 1e3, h.max / 1e3);
+        ret += line;
+    }
+    return ret;
+}
+
+// 导出为JSON（时间单位为纳秒）
+std::string Profiler::toJSON(const ProfileSnapshot& snapshot) {
+    Json::Value root(Json::arrayValue);
+    for (auto& stats : snapshot) {
+        auto& h = stats.histogram;
+        Json::Value item;
+        item["name"] = stats.name;
+        item["count"] = Json::UInt64(h.count);
+        item["sum"] = Json::UInt64(h.sum);
+        item["min"] = Json::UInt64(h.min);
+        item["max"] = Json::UInt64(h.max);
+        item["mean"] = h.mean();
+        item["p50"] = Json::UInt64(h.percentile(0.5));
+        item["p90"] = Json::UInt64(h.percentile(0.9));
+        item["p99"] = Json::UInt64(h.percentile(0.99));
+        root.append(item);
+    }
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, root);
+}
+
+// 导出追踪事件为Chrome trace-event格式（ts和dur的单位为微秒）
+std::string Profiler::toChromeTrace() {
+    auto& r = registry();
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<ThreadProfile>> threads;
+    {
+        Guard l(r.mutex);
+        names = r.names;
+        threads = r.threads;
+    }
+
+    Json::Value events(Json::arrayValue);
+    Json::Int pid = static_cast<Json::Int>(getpid());
+    for (auto& thread : threads) {
+        const TraceEvent* buffer = thread->events.load(std::memory_order_acquire);
+        if (!buffer) {
+            continue;
+        }
+        uint64_t end = thread->eventCount.load(std::memory_order_acquire);
+        uint64_t begin = end > c_traceCapacity ? end - c_traceCapacity : 0;
+        for (uint64_t i = begin; i < end; ++i) {
+            const TraceEvent& e = buffer[i % c_traceCapacity];
+            if (e.scope >= names.size()) {
+                continue;
+            }
+            Json::Value event;
+            event["name"] = names[e.scope];
+            event["cat"] = "profile";
+            event["ph"] = "X";
+            event["ts"] = e.start / 1e3;
+            event["dur"] = e.duration / 1e3;
+            event["pid"] = pid;
+            event["tid"] = Json::UInt64(thread->tid);
+            events.append(event);
+        }
+    }
+
+    Json::Value root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ns";
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, root);
+}
+
+ProfileReporter::ProfileReporter(std::chrono::milliseconds interval, Callback callback)
+: m_interval(interval), m_callback(std::move(callback)) {
+    m_thread = std::thread([this] {
+        ProfileSnapshot before = Profiler::snapshot();
+        UniqueLock l(m_mutex);
+        while (!m_cv.wait_for(l, m_interval, [this] { return m_stop; })) {
+            l.unlock();
+            ProfileSnapshot now = Profiler::snapshot();
+            m_callback(Profiler::diff(now, before));
+            before = std::move(now);
+            l.lock();
+        }
+    });
+}
+
+// 停止后台线程
+ProfileReporter::~ProfileReporter() {
+    {
+        Guard l(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+}   // namespace dev
@@ -0,0 +1,193 @@
+/**
+ * 热点路径性能剖析（纳秒级作用域计时，按线程聚合）
+ * @file: Profiler.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Common.h"
+#include "Guards.h"
+
+namespace dev {
+
+/**
+ * recover，keccak256，RLP解码等操作都是微秒级的，Timer::elapsed()只有毫秒精度，每次都打日志开销又太大。
+ * 用法：在需要测量的作用域开头写PROFILE_SCOPE("rlp.decode");
+ * 1. 作用域结束时把耗时（ns）记录到当前线程自己的直方图中，只有本线程写，不需要加锁和原子读改写
+ * 2. 直方图是对数线性的：每个2的幂区间再等分为8个桶，相对误差不超过12.5%，固定496个桶覆盖所有64位整数
+ * 3. snapshot()合并所有线程的直方图，ProfileReporter周期性地生成两次快照之间的增量
+ * 4. 可以导出为文本，JSON，或者Chrome追踪事件格式（需要先setTracing(true)记录每次调用的起止时间，
+ *    在chrome://tracing或Perfetto中打开）
+ * 编译时没有定义DEV_PROFILING（cmake -DWITH_PROFILING=ON）时PROFILE_SCOPE展开为空，没有任何开销
+ */
+
+// 单调时钟（ns）
+inline uint64_t profileNow() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 对数线性直方图（快照中使用的普通值类型）
+class LatencyHistogram {
+public:
+    static constexpr unsigned c_subBucketBits = 3;                      // 每个2的幂区间等分的位数
+    static constexpr unsigned c_subBuckets = 1 << c_subBucketBits;      // 每个2的幂区间等分的桶数
+    static constexpr unsigned c_bucketCount = (64 - c_subBucketBits + 1) * c_subBuckets;
+
+    // 值所在的桶
+    static unsigned bucketOf(uint64_t v) noexcept {
+        if (v < c_subBuckets) {
+            return static_cast<unsigned>(v);
+        }
+        unsigned k = 63 - __builtin_clzll(v);
+        unsigned sub = static_cast<unsigned>(v >> (k - c_subBucketBits)) & (c_subBuckets - 1);
+        return (k - c_subBucketBits + 1) * c_subBuckets + sub;
+    }
+
+    // 桶的下界（包含）
+    static uint64_t bucketLower(unsigned b) noexcept {
+        if (b < c_subBuckets) {
+            return b;
+        }
+        unsigned k = b / c_subBuckets + c_subBucketBits - 1;
+        return static_cast<uint64_t>(c_subBuckets + b % c_subBuckets) << (k - c_subBucketBits);
+    }
+
+    // 桶的上界（包含）
+    static uint64_t bucketUpper(unsigned b) noexcept {
+        return b + 1 < c_bucketCount ? bucketLower(b + 1) - 1 : std::numeric_limits<uint64_t>::max();
+    }
+
+    LatencyHistogram() : buckets(c_bucketCount, 0) {}
+
+    // 记录一个值
+    void record(uint64_t v) noexcept {
+        ++count;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+        ++buckets[bucketOf(v)];
+    }
+
+    // 合并另一个直方图
+    void merge(const LatencyHistogram& other) noexcept;
+
+    // 平均值
+    double mean() const noexcept { return count ? static_cast<double>(sum) / count : 0; }
+
+    // 百分位数（p为0到1之间，返回所在桶的上界，不超过最大值）
+    uint64_t percentile(double p) const noexcept;
+
+    uint64_t count = 0;                                     // 记录次数
+    uint64_t sum = 0;                                       // 总和
+    uint64_t min = std::numeric_limits<uint64_t>::max();    // 最小值
+    uint64_t max = 0;                                       // 最大值
+    std::vector<uint64_t> buckets;                          // 各个桶的计数
+};
+
+// 一个作用域的统计
+struct ScopeStats {
+    std::string name;                   // 作用域名称
+    LatencyHistogram histogram;         // 耗时（ns）
+};
+
+// 所有作用域的统计（按名称排序，只包含有记录的作用域）
+using ProfileSnapshot = std::vector<ScopeStats>;
+
+// 性能剖析接口
+class Profiler {
+public:
+    // 最多支持的作用域个数（超出的作用域不记录）
+    static constexpr size_t c_maxScopes = 1024;
+
+    // 每个线程保留的追踪事件个数（环形缓冲区，超出时覆盖最旧的事件）
+    static constexpr size_t c_traceCapacity = 1 << 16;
+
+    // 注册作用域，同名的作用域返回相同的编号
+    static size_t registerScope(const std::string& name);
+
+    /**
+     * 记录一次耗时（由ScopeTimer调用）
+     * @param scope 作用域编号
+     * @param start 开始时间（profileNow()）
+     * @param ns 耗时
+     */
+    static void record(size_t scope, uint64_t start, uint64_t ns) noexcept;
+
+    // 合并所有线程（包括已经退出的线程）的统计
+    static ProfileSnapshot snapshot();
+
+    // 两次快照之间的增量（最小值和最大值由桶的边界估计）
+    static ProfileSnapshot diff(const ProfileSnapshot& now, const ProfileSnapshot& before);
+
+    // 开启/关闭追踪事件记录
+    static void setTracing(bool enable) noexcept;
+    static bool tracing() noexcept;
+
+    // 导出为文本表格
+    static std::string toText(const ProfileSnapshot& snapshot);
+
+    // 导出为JSON
+    static std::string toJSON(const ProfileSnapshot& snapshot);
+
+    // 导出追踪事件为Chrome trace-event格式（导出时最好先关闭追踪，否则正在被覆盖的事件可能不一致）
+    static std::string toChromeTrace();
+};
+
+// 作用域计时器（RAII）
+class ScopeTimer {
+public:
+    explicit ScopeTimer(size_t scope) noexcept : m_scope(scope), m_start(profileNow()) {}
+    ~ScopeTimer() { Profiler::record(m_scope, m_start, profileNow() - m_start); }
+
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    size_t m_scope;
+    uint64_t m_start;
+};
+
+// 周期性生成快照增量（在后台线程中调用回调）
+class ProfileReporter {
+public:
+    using Callback = std::function<void(const ProfileSnapshot& delta)>;
+
+    ProfileReporter(std::chrono::milliseconds interval, Callback callback);
+
+    // 停止后台线程
+    ~ProfileReporter();
+
+    ProfileReporter(const ProfileReporter&) = delete;
+    ProfileReporter& operator=(const ProfileReporter&) = delete;
+
+private:
+    std::chrono::milliseconds m_interval;
+    Callback m_callback;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+// 测量当前作用域的耗时
+#if defined(DEV_PROFILING)
+#define PROFILE_SCOPE(name)                                                                           \
+    static const size_t PROFILE_CONCAT(s_profileScope, __LINE__) = ::dev::Profiler::registerScope(name); \
+    ::dev::ScopeTimer PROFILE_CONCAT(profileTimer, __LINE__)(PROFILE_CONCAT(s_profileScope, __LINE__))
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+}   // namespace dev
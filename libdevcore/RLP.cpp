@@ -9,11 +9,24 @@
  * @date: 2021-01-30
  */
 #include "RLP.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <cassert>
 
 namespace dev {
 
+// 依次解析payload中的各个数据项
+template <class Container>
+static void splitItems(BytesConstRef payload, Container& items) {
+    while (payload.size() != 0) {
+        RLP item = RLP(payload, false);
+        payload = payload.cropped(item.actualSize());
+        items.push_back(item);
+    }
+}
+
 /**
  * 将字节数组看作一个RLP数据项
  * @param bs 字节数组
@@ -40,17 +53,143 @@ std::vector<RLP> RLP::splitList() const {
         throw RLPBadCast();
     }
 
+    static Counter& s_lists = MetricsRegistry::instance().counter("rlp_decoded_lists_total", "RLP lists split into items");
+    static Counter& s_items = MetricsRegistry::instance().counter("rlp_decoded_items_total", "RLP items split from lists");
+
+    ALLOC_SCOPE(RLP);
     std::vector<RLP> ret;
-    BytesConstRef leftItems = payload();
-    while (leftItems.size() != 0) {
-        RLP item = RLP(leftItems, false);
-        leftItems = leftItems.cropped(item.actualSize());
-        ret.push_back(item);
+    splitItems(payload(), ret);
+    s_lists.inc();
+    s_items.inc(ret.size());
+
+    return ret;
+}
+
+// 将RLP列表拆分成多个RLP数据项（数组从arena分配）
+ArenaVector<RLP> RLP::splitList(Arena& arena) const {
+    if (!isList()) {
+        throw RLPBadCast();
+    }
+
+    ArenaVector<RLP> ret{ArenaAllocator<RLP>(arena)};
+    splitItems(payload(), ret);
+    return ret;
+}
+
+/**
+ * 分解列表
+ * @return 列表包含的所有RLP数据项（共享底层内存）
+ * @throw 若当前RLP不是列表则抛出RLPBadCast异常
+ * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常
+ */
+std::vector<SharedRLP> SharedRLP::splitList() const {
+    std::vector<RLP> items = m_rlp.splitList();
+
+    ALLOC_SCOPE(RLP);
+    std::vector<SharedRLP> ret;
+    ret.reserve(items.size());
+    for (const auto& item : items) {
+        ret.push_back(SharedRLP(m_buffer, item));
     }
 
     return ret;
 }
 
+/**
+ * 按前缀分类的短数据项长度（前缀+载荷），长度单独编码的数据项为0（需要完整解析）
+ * 0x81后面的字节决定编码是否合法，也按0处理
+ */
+static constexpr std::array<uint8_t, 256> makeShortItemSizes() noexcept {
+    std::array<uint8_t, 256> sizes{};
+    for (unsigned b = 0; b < 256; ++b) {
+        if (b < c_rlpDataImmLenStart) {
+            sizes[b] = 1;
+        } else if (b <= c_rlpDataIndLenZero && b != c_rlpDataImmLenStart + 1) {
+            sizes[b] = 1 + b - c_rlpDataImmLenStart;
+        } else if (b >= c_rlpListStart && b <= c_rlpListIndLenZero) {
+            sizes[b] = 1 + b - c_rlpListStart;
+        }
+    }
+    return sizes;
+}
+static constexpr std::array<uint8_t, 256> c_shortItemSizes = makeShortItemSizes();
+
+/**
+ * 获取列表包含的数据项数目
+ * @throw 若当前RLP不是列表则抛出RLPBadCast异常
+ * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常
+ */
+size_t RLP::itemCount() const {
+    if (!isList()) {
+        throw RLPBadCast();
+    }
+
+    BytesConstRef rest = payload();
+    size_t count = 0;
+    while (!rest.empty()) {
+        // 短数据项查表得到长度，其它的完整解析
+        size_t size = c_shortItemSizes[rest[0]];
+        if (0 == size) {
+            size = RLP(rest, false).actualSize();
+        } else if (size > rest.size()) {
+            throw BadRLP();
+        }
+        rest = rest.cropped(size);
+        ++count;
+    }
+    return count;
+}
+
+// 比较data中每隔stride字节的前缀是否都是prefix（每次比较一块数据项，块内不分支）
+DEV_TARGET_CLONES static bool stridePrefixesMatch(const Byte* data, size_t count, size_t stride, Byte prefix) noexcept {
+    constexpr size_t c_block = 8;
+    size_t i = 0;
+    for (; i + c_block <= count; i += c_block) {
+        unsigned diff = 0;
+        for (size_t k = 0; k < c_block; ++k) {
+            diff |= data[(i + k) * stride] ^ prefix;
+        }
+        if (0 != diff) {
+            return false;
+        }
+    }
+    for (; i < count; ++i) {
+        if (data[i * stride] != prefix) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 判断当前RLP是否是每个数据项都是长度为size的字符串的列表
+ * @throw 若当前列表的前缀不合法抛出BadRLP异常
+ */
+bool RLP::isFixedStrideList(size_t size) const {
+    // 长度为1的字符串需要检查内容才能确定编码是否合法
+    if (!isList() || size < 2 || size >= c_rlpDataImmLenCount) {
+        return false;
+    }
+
+    BytesConstRef p = payload();
+    size_t stride = size + 1;
+    if (0 != p.size() % stride) {
+        return false;
+    }
+    return stridePrefixesMatch(p.data(), p.size() / stride, stride, static_cast<Byte>(c_rlpDataImmLenStart + size));
+}
+
+// 不是由定长字符串组成的列表时抛出异常
+void RLP::throwNotFixedStrideList() const {
+    if (!isList()) {
+        throw RLPBadCast();
+    }
+    // 逐个解析所有数据项，编码不合法时抛出BadRLP异常，否则说明有数据项的类型或长度不符
+    for (iterator it = begin(), e = end(); it != e; ++it) {
+    }
+    throw RLPBadCast();
+}
+
 // 获取当前RLP数据项前缀长度（前缀+长度编码所占字节数）
 unsigned RLP::prefixSize() const noexcept {
     // 当前RLP数据项为空或单字节RLP编码
@@ -107,7 +246,7 @@ size_t RLP::payloadSize() const {
             throw BadRLP();
         }
         return dataSize;
-    } else if (m_data[0] < c_rlpListIndLenZero) {       // 长度编码到前缀的列表
+    } else if (m_data[0] <= c_rlpListIndLenZero) {      // 长度编码到前缀的列表
         // 长度为[0, 55]的列表，长度编码到前缀中
         size_t len = m_data[0] - c_rlpListStart;
         if (len >= m_data.size()) {
@@ -134,18 +273,109 @@ size_t RLP::payloadSize() const {
     }
 }
 
+/**
+ * 校验输入是否恰好是一个合法的RLP数据项（包括所有嵌套的数据项）
+ * @param data 输入数据
+ * @param limits 校验限制
+ * @return 校验结果（遇到的第一个错误）
+ */
+RLPValidity validateRLP(BytesConstRef data, const RLPLimits& limits) noexcept {
+    if (data.size() > limits.maxSize) {
+        return RLPValidity::c_tooLarge;
+    }
+    if (data.empty()) {
+        return RLPValidity::c_truncated;
+    }
+
+    // 各层未结束的列表的结束位置
+    size_t ends[RLPLimits::c_maxDepth];
+    size_t maxDepth = std::min(limits.maxDepth, RLPLimits::c_maxDepth);
+    size_t depth = 0;
+    size_t items = 0;
+    size_t pos = 0;
+    const Byte* p = data.data();
+
+    do {
+        // 当前数据项所在的列表（或整个输入）的结束位置，pos < limit
+        size_t limit = depth ? ends[depth - 1] : data.size();
+        if (++items > limits.maxItems) {
+            return RLPValidity::c_tooManyItems;
+        }
+
+        unsigned prefix = p[pos];
+        bool isList = prefix >= c_rlpListStart;
+        size_t headerSize = 0;
+        uint64_t payloadSize = 1;
+        if (prefix < c_rlpDataImmLenStart) {
+            // 单字节字符串
+        } else if (prefix <= c_rlpDataIndLenZero || (isList && prefix <= c_rlpListIndLenZero)) {
+            // 长度编码到前缀
+            headerSize = 1;
+            payloadSize = prefix - (isList ? c_rlpListStart : c_rlpDataImmLenStart);
+        } else {
+            // 长度单独编码
+            size_t lenSize = prefix - (isList ? c_rlpListIndLenZero : c_rlpDataIndLenZero);
+            headerSize = 1 + lenSize;
+            if (headerSize > limit - pos) {
+                return RLPValidity::c_truncated;
+            }
+            if (0 == p[pos + 1]) {
+                return RLPValidity::c_nonCanonical;
+            }
+            payloadSize = 0;
+            for (size_t i = 1; i <= lenSize; ++i) {
+                payloadSize = (payloadSize << 8) | p[pos + i];
+            }
+            if (payloadSize < c_rlpDataImmLenCount) {
+                return RLPValidity::c_nonCanonical;
+            }
+        }
+
+        if (headerSize > limit - pos || payloadSize > limit - pos - headerSize) {
+            return RLPValidity::c_truncated;
+        }
+        if (c_rlpDataImmLenStart + 1 == prefix && p[pos + 1] < c_rlpDataImmLenStart) {
+            // 长度为1的字符串，但其实应该编码为单字节RLP编码
+            return RLPValidity::c_nonCanonical;
+        }
+
+        if (isList) {
+            if (depth == maxDepth) {
+                return RLPValidity::c_tooDeep;
+            }
+            if (0 != payloadSize) {
+                // 进入列表，接着校验列表中的第一个数据项
+                ends[depth++] = pos + headerSize + payloadSize;
+                pos += headerSize;
+                continue;
+            }
+        }
+        pos += headerSize + payloadSize;
+
+        // 退出所有已经结束的列表
+        while (depth > 0 && pos == ends[depth - 1]) {
+            --depth;
+        }
+    } while (depth > 0);
+
+    return pos == data.size() ? RLPValidity::c_valid : RLPValidity::c_trailingBytes;
+}
+
 /**
  * 开启新的列表追加流程
  * @param itemCount 新列表包含的数据项数目（若为0，直接完成空列表编码）
  * @return RLP编码流对象的引用
  */
-RLPStream& RLPStream::appendList(size_t itemCount) {
+template <class Alloc>
+BasicRLPStream<Alloc>& BasicRLPStream<Alloc>::appendList(size_t itemCount) {
+    ALLOC_SCOPE(RLP);
     if (0 != itemCount) {
         // 将新列表包含的RLP数据项数目，和当前RLP编码流长度压入栈
         m_listStack.push_back(std::make_pair(itemCount, m_out.size()));
     } else {
         // 直接完成空列表的追加
         m_out.push_back(c_rlpListStart);
+        noteAppended();
     }
 
     return *this;
@@ -158,7 +388,9 @@ RLPStream& RLPStream::appendList(size_t itemCount) {
  * @return RLP编码流对象的引用
  * @throw 若长度编码大于8抛出RLPItemTooLarge异常
  */
-RLPStream& RLPStream::append(BytesConstRef bs, bool ignoreLeading0s) {
+template <class Alloc>
+BasicRLPStream<Alloc>& BasicRLPStream<Alloc>::append(BytesConstRef bs, bool ignoreLeading0s) {
+    ALLOC_SCOPE(RLP);
     auto size = bs.size();
     auto data = bs.data();
     if (ignoreLeading0s) {
@@ -193,7 +425,8 @@ RLPStream& RLPStream::append(BytesConstRef bs, bool ignoreLeading0s) {
  * @return 当前编码结果的常量引用
  * @throw 若当前还有列表未完成编码抛出RLPIncompleteList异常
  */
-const Bytes& RLPStream::peek() {
+template <class Alloc>
+const typename BasicRLPStream<Alloc>::Buffer& BasicRLPStream<Alloc>::peek() {
     if (!m_listStack.empty()) {
         throw RLPIncompleteList();
     }
@@ -207,11 +440,17 @@ const Bytes& RLPStream::peek() {
  * @return 当前编码结果
  * @throw 若当前还有列表未完成编码抛出RLPIncompleteList异常
  */
-Bytes RLPStream::take() {
+template <class Alloc>
+typename BasicRLPStream<Alloc>::Buffer BasicRLPStream<Alloc>::take() {
     if (!m_listStack.empty()) {
         throw RLPIncompleteList();
     }
 
+    static Counter& s_streams = MetricsRegistry::instance().counter("rlp_encoded_total", "RLP streams taken");
+    static Counter& s_bytes = MetricsRegistry::instance().counter("rlp_encoded_bytes_total", "Bytes of RLP streams taken");
+    s_streams.inc();
+    s_bytes.inc(m_out.size());
+
     // 取走编码结果
     return std::move(m_out);
 }
@@ -222,7 +461,9 @@ Bytes RLPStream::take() {
  * @return RLP编码流对象的引用
  * @throw 若造成当前列表长度编码大于8字节抛出RLPItemTooLarge异常
  */
-RLPStream& RLPStream::appendRaw(BytesConstRef rawItem) {
+template <class Alloc>
+BasicRLPStream<Alloc>& BasicRLPStream<Alloc>::appendRaw(BytesConstRef rawItem) {
+    ALLOC_SCOPE(RLP);
     // 直接追加数据
     m_out.insert(m_out.end(), rawItem.begin(), rawItem.end());
 
@@ -236,7 +477,9 @@ RLPStream& RLPStream::appendRaw(BytesConstRef rawItem) {
  * 通知追加了新的数据项（以便列表出栈）
  * @throw 若造成当前列表长度编码大于8字节抛出RLPItemTooLarge异常
  */
-void RLPStream::noteAppended() {
+template <class Alloc>
+void BasicRLPStream<Alloc>::noteAppended() {
+    ALLOC_SCOPE(RLP);
     // 进行列表出栈操作
     while (!m_listStack.empty()) {
         // 当前列表
@@ -288,7 +531,8 @@ void RLPStream::noteAppended() {
  * @param offset 前缀起始偏移值
  * @throw 若长度编码大于8抛出RLPItemTooLarge异常
  */
-void RLPStream::pushCount(size_t count, unsigned offset) {
+template <class Alloc>
+void BasicRLPStream<Alloc>::pushCount(size_t count, unsigned offset) {
     // count和offset必须满足编码规范
     assert(
         (c_rlpDataIndLenZero == offset && count >= c_rlpDataImmLenCount) ||
@@ -310,6 +554,9 @@ void RLPStream::pushCount(size_t count, unsigned offset) {
     toBigEndian(count, BytesRef(&m_out[oldSize], br));
 }
 
+template class BasicRLPStream<std::allocator<Byte>>;
+template class BasicRLPStream<ArenaAllocator<Byte>>;
+
 // 空字符串rlp编码
 const Bytes c_rlpEmptyData = rlpData("");;
 
@@ -12,10 +12,20 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <memory>
+#include "AllocTracker.h"
+#include "Arena.h"
 #include "Common.h"
 #include "FixedBytes.h"
+#include "SmallBytes.h"
+#include "SharedBytes.h"
 #include "Exceptions.h"
 
 namespace dev {
@@ -51,6 +61,13 @@ constexpr unsigned c_rlpListIndLenZero = 0xf7;      // 列表将长度单独编
 constexpr unsigned c_rlpDataImmLenCount = 56;       // 字符串可以将长度编码到前缀的范围[0, 55]
 constexpr unsigned c_rlpListImmLenCount = 56;       // 列表可以将长度编码到前缀的范围[0, 55]
 
+// 是否为RLP支持的无符号整型（内置无符号整型，U160，U256，U512，不包括bool）
+template <typename T>
+struct isRLPUnsignedImpl : std::integral_constant<bool,
+    std::numeric_limits<T>::is_integer && !std::numeric_limits<T>::is_signed && !std::is_same<T, bool>::value> {};
+template <typename T>
+struct isRLPUnsigned : std::conjunction<std::disjunction<std::is_integral<T>, std::is_class<T>>, isRLPUnsignedImpl<T>> {};
+
 // 整型类型的长度
 template <typename T>
 struct intTraits {
@@ -69,6 +86,9 @@ struct intTraits<U512> {
     static constexpr unsigned c_maxSize = 64;
 };
 
+template <size_t N>
+class RLPFixedBytesView;
+
 // RLP负责反序列化，一个RLP对象表示一个RLP数据项
 class RLP {
 public:
@@ -133,10 +153,36 @@ public:
         }
 
         // 获取字符串本身
+        ALLOC_SCOPE(RLP);
         auto p = payload();
         return Bytes(p.data(), p.data() + p.size());
     }
 
+    /**
+     * 将当前RLP数据项转换为从arena分配的字节数组
+     * @throw 若当前RLP数据项不是字符串抛出RLPBadCast异常
+     */
+    ArenaBytes toBytes(Arena& arena) const {
+        if (!isData()) {
+            throw RLPBadCast();
+        }
+        auto p = payload();
+        return ArenaBytes(p.data(), p.data() + p.size(), arena);
+    }
+
+    /**
+     * 将当前RLP数据项转换为字节数组（不超过64字节时不需要分配堆内存）
+     * @return 对应的字节数组
+     * @throw 若当前RLP数据项不是字符串抛出RLPBadCast异常
+     */
+    SmallBytes toSmallBytes() const {
+        if (!isData()) {
+            throw RLPBadCast();
+        }
+
+        return SmallBytes(payload());
+    }
+
     /**
      * 将当前RLP数据项转换为定长字节数组
      * @param align 对齐方式
@@ -166,6 +212,19 @@ public:
         return payload().toString();
     }
 
+    /**
+     * 将当前RLP数据项转换为字符串视图（引用原始数据，不复制）
+     * @return 对应的字符串视图
+     * @throw 若当前RLP数据项不是字符串抛出RLPBadCast异常
+     */
+    std::string_view toStringView() const {
+        if (!isData()) {
+            throw RLPBadCast();
+        }
+
+        return payload().toStringView();
+    }
+
     // 转换为对应类型（对不支持的类型直接抛出RLPUnsupportedCast异常）
     template <typename T>
     T convert() const { throw RLPUnsupportedCast(); }
@@ -185,7 +244,53 @@ public:
      */
     std::vector<RLP> splitList() const;
 
+    /**
+     * 分解列表，结果从arena分配
+     * @throw 同splitList()
+     */
+    ArenaVector<RLP> splitList(Arena& arena) const;
+
+    // 列表迭代器（逐个解析列表中的数据项，不分配内存）
+    class iterator;
+
+    /**
+     * 获取列表迭代器
+     * @throw 若当前RLP不是列表则抛出RLPBadCast异常
+     * @throw 若第一个数据项不合法抛出BadRLP异常
+     */
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+     * 获取列表包含的数据项数目（按前缀跳过各数据项，不构造RLP对象）
+     * @throw 若当前RLP不是列表则抛出RLPBadCast异常
+     * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常
+     */
+    size_t itemCount() const;
+
+    /**
+     * 判断当前RLP是否是每个数据项都是长度为size的字符串的列表（例如哈希列表，每个数据项都是0xa0+32字节）
+     * 这样的列表中数据项按固定步长排列，只需要比较各步长位置的前缀，不需要逐个解析
+     * 只支持[2, 55]字节的字符串（前缀为单字节），其它长度总是返回false
+     * @throw 若当前列表的前缀不合法抛出BadRLP异常
+     */
+    bool isFixedStrideList(size_t size) const;
+
+    /**
+     * 获取由N字节字符串组成的列表的视图（引用原始数据，不复制）
+     * @throw 若当前RLP不是列表，或列表中有数据项不是N字节的字符串抛出RLPBadCast异常
+     * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常
+     */
+    template <size_t N>
+    RLPFixedBytesView<N> toFixedBytesView() const;
+
 private:
+    /**
+     * 不是由定长字符串组成的列表时抛出异常
+     * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常，否则抛出RLPBadCast异常
+     */
+    [[noreturn]] void throwNotFixedStrideList() const;
+
     // 获取当前RLP数据项前缀长度（前缀+长度编码所占字节数）
     unsigned prefixSize() const noexcept;
 
@@ -199,6 +304,116 @@ private:
     BytesConstRef m_data;
 };
 
+// 列表迭代器（逐个解析列表中的数据项，不分配内存）
+class RLP::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = RLP;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const RLP*;
+    using reference = const RLP&;
+
+    /**
+     * 解析下一个数据项
+     * @throw 若数据项不合法抛出BadRLP异常
+     */
+    iterator& operator++() {
+        m_rest = m_rest.cropped(m_current.actualSize());
+        m_current = RLP(m_rest, false);
+        return *this;
+    }
+
+    const RLP& operator*() const noexcept { return m_current; }
+    const RLP* operator->() const noexcept { return &m_current; }
+
+    bool operator==(const iterator& rhs) const noexcept { return m_rest.data() == rhs.m_rest.data(); }
+    bool operator!=(const iterator& rhs) const noexcept { return !(*this == rhs); }
+
+private:
+    friend class RLP;
+
+    // 从剩余数据的开头解析当前数据项
+    explicit iterator(BytesConstRef rest) : m_rest(rest), m_current(rest, false) {}
+
+    BytesConstRef m_rest;   // 剩余数据（以当前数据项开头）
+    RLP m_current;          // 当前数据项
+};
+
+// 获取列表迭代器
+inline RLP::iterator RLP::begin() const {
+    if (!isList()) {
+        throw RLPBadCast();
+    }
+    return iterator(payload());
+}
+inline RLP::iterator RLP::end() const {
+    if (!isList()) {
+        throw RLPBadCast();
+    }
+    BytesConstRef p = payload();
+    return iterator(BytesConstRef(p.data() + p.size(), 0));
+}
+
+/**
+ * 由N字节字符串组成的列表的视图（例如哈希列表）
+ * 数据项按固定步长N + 1排列，直接按下标定位，不需要逐个解析前缀
+ */
+template <size_t N>
+class RLPFixedBytesView {
+public:
+    static_assert(N >= 2 && N < c_rlpDataImmLenCount, "only strings with single byte prefix supported");
+
+    // 相邻数据项的间隔（前缀+字符串）
+    static constexpr size_t c_stride = N + 1;
+
+    // 由列表的载荷构造（调用者保证载荷中的数据项都是N字节的字符串）
+    explicit RLPFixedBytesView(BytesConstRef payload) noexcept : m_payload(payload) {}
+
+    size_t size() const noexcept { return m_payload.size() / c_stride; }
+    bool empty() const noexcept { return m_payload.empty(); }
+
+    // 第i个数据项的字符串（引用原始数据）
+    BytesConstRef ref(size_t i) const noexcept { return m_payload.cropped(i * c_stride + 1, N); }
+
+    // 第i个数据项转换为定长字节数组
+    FixedBytes<N> operator[](size_t i) const noexcept {
+        FixedBytes<N> ret;
+        memcpy(ret.data(), m_payload.data() + i * c_stride + 1, N);
+        return ret;
+    }
+
+    // 转换为定长字节数组的数组
+    std::vector<FixedBytes<N>> toVector() const {
+        std::vector<FixedBytes<N>> ret(size());
+        const Byte* p = m_payload.data() + 1;
+        for (auto& h : ret) {
+            memcpy(h.data(), p, N);
+            p += c_stride;
+        }
+        return ret;
+    }
+
+private:
+    BytesConstRef m_payload;    // 列表的载荷
+};
+
+// 是否为可以按固定步长解码的定长字节数组（H160，H256等长度在[2, 55]字节的FixedBytes）
+template <typename T>
+struct isFixedStrideBytes : std::false_type {};
+template <size_t N>
+struct isFixedStrideBytes<FixedBytes<N>> : std::integral_constant<bool, N >= 2 && N < c_rlpDataImmLenCount> {
+    static constexpr size_t c_size = N;
+};
+
+// 获取由N字节字符串组成的列表的视图
+template <size_t N>
+RLPFixedBytesView<N> RLP::toFixedBytesView() const {
+    if (!isFixedStrideList(N)) {
+        throwNotFixedStrideList();
+    }
+    return RLPFixedBytesView<N>(payload());
+}
+
 template <>
 inline uint32_t RLP::convert() const { return toInt<uint32_t>(); }  // 转换为uint32_t类型
 template <>
@@ -218,28 +433,145 @@ inline H512 RLP::convert() const { return toFixedBytes<H512>(); }   // 转换为
 template <>
 inline H2048 RLP::convert() const { return toFixedBytes<H2048>(); } // 转换为H2048类型
 template <>
+inline H160s RLP::convert() const { return toFixedBytesView<20>().toVector(); }    // 转换为H160s类型
+template <>
+inline H256s RLP::convert() const { return toFixedBytesView<32>().toVector(); }    // 转换为H256s类型
+template <>
 inline Bytes RLP::convert() const { return toBytes(); }             // 转换为Bytes类型
 template <>
+inline SmallBytes RLP::convert() const { return toSmallBytes(); }   // 转换为SmallBytes类型
+template <>
 inline std::string RLP::convert() const { return toString(); }      // 转换为std::string类型
 
-// RLPStream类负责序列化
-class RLPStream {
+// RLP校验结果
+enum class RLPValidity {
+    c_valid,            // 合法
+    c_truncated,        // 数据项不完整（长度超出所在列表或输入的范围）
+    c_nonCanonical,     // 不是最短编码（单字节字符串加了前缀，长度编码有前导0，单独编码的长度不超过55）
+    c_tooDeep,          // 列表嵌套层数超过限制
+    c_tooManyItems,     // 数据项总数超过限制
+    c_tooLarge,         // 输入长度超过限制
+    c_trailingBytes     // 数据项之后还有多余的数据
+};
+
+// RLP校验限制
+struct RLPLimits {
+    // 列表嵌套层数的上限（校验时用栈上的定长数组记录各层列表的结束位置，maxDepth不能超过它）
+    static constexpr size_t c_maxDepth = 256;
+
+    size_t maxDepth = 64;                                       // 列表最大嵌套层数（最外层列表为第1层）
+    size_t maxItems = std::numeric_limits<size_t>::max();       // 最大数据项总数（包括列表本身）
+    size_t maxSize = std::numeric_limits<size_t>::max();        // 输入的最大字节数
+};
+
+/**
+ * 校验输入是否恰好是一个合法的RLP数据项（包括所有嵌套的数据项）
+ * RLP对象只在访问时检查当前数据项，嵌套的列表要等调用者逐层splitList()才会检查，
+ * 从网络收到的数据应该先用validateRLP()一次性检查完，再交给RLP解析：
+ * 1. 迭代而不是递归，只扫描各数据项的前缀，字符串载荷直接跳过，时间与输入长度成线性关系
+ * 2. 不分配内存，嵌套层数、数据项总数和输入长度都有上限，构造的深层嵌套数据在达到上限时立即被拒绝
+ * 3. 与RLP的解析规则一致，校验通过的数据用RLP解析不会抛出BadRLP异常
+ * @param data 输入数据
+ * @param limits 校验限制
+ * @return 校验结果（遇到的第一个错误）
+ */
+RLPValidity validateRLP(BytesConstRef data, const RLPLimits& limits = RLPLimits()) noexcept;
+
+/**
+ * 持有底层内存的RLP数据项
+ * RLP只保存数据的引用，需要调用者保证被引用数据的生命周期，
+ * SharedRLP同时持有底层内存（SharedBytes），分解出来的子数据项和载荷都共享同一块内存，
+ * 可以不拷贝地交给其它线程处理，最后一个引用释放时底层内存才会释放。
+ * SharedRLP不是RLP（不能当作RLP传给只保存引用的接口），需要完整的解析接口时用rlp()取得视图
+ */
+class SharedRLP {
 public:
+    /**
+     * 将共享字节数组看作一个RLP数据项
+     * @param bs 共享字节数组
+     * @param failIfTooBig 当输入长度大于RLP数据项本身的长度时，是否抛出异常
+     * @throw 若当前RLP数据项不合法抛出BadRLP异常
+     * @throw failIfTooBig为true，输入长度大于RLP数据项本身的长度时，抛出BadRLP异常
+     */
+    explicit SharedRLP(SharedBytes bs, bool failIfTooBig = true)
+    : m_buffer(std::move(bs)), m_rlp(m_buffer.ref(), failIfTooBig) {}
+
+    // 获取RLP视图（有效期不超过当前对象或其拷贝的生命周期）
+    const RLP& rlp() const noexcept { return m_rlp; }
+
+    // 数据项类型
+    bool isNull() const noexcept { return m_rlp.isNull(); }
+    bool isEmpty() const noexcept { return m_rlp.isEmpty(); }
+    bool isData() const noexcept { return m_rlp.isData(); }
+    bool isList() const noexcept { return m_rlp.isList(); }
+
+    // 列表包含的数据项个数
+    size_t itemCount() const { return m_rlp.itemCount(); }
+
+    // 转换为指定类型（拷贝）
+    template <class T>
+    T convert() const { return m_rlp.convert<T>(); }
+
+    // 获取底层内存
+    const SharedBytes& buffer() const noexcept { return m_buffer; }
+
+    // 获取当前RLP数据项的实际数据（前缀+长度编码+载荷），共享底层内存
+    SharedBytes sharedActualData() const { return m_buffer.slice(m_rlp.actualData()); }
+
+    // 获取当前RLP数据项的数据载荷，共享底层内存
+    SharedBytes sharedPayload() const { return m_buffer.slice(m_rlp.payload()); }
+
+    /**
+     * 分解列表
+     * @return 列表包含的所有RLP数据项（共享底层内存）
+     * @throw 若当前RLP不是列表则抛出RLPBadCast异常
+     * @throw 若列表中包含的任何RLP数据项不合法抛出BadRLP异常
+     */
+    std::vector<SharedRLP> splitList() const;
+
+private:
+    // 用底层内存中的一个RLP数据项构造
+    SharedRLP(const SharedBytes& buffer, const RLP& item) : m_buffer(buffer), m_rlp(item) {}
+
+    SharedBytes m_buffer;               // 底层内存
+    RLP m_rlp;                          // 指向底层内存的视图
+};
+
+/**
+ * RLPStream类负责序列化
+ * Alloc是编码结果使用的分配器，RLPStream使用std::allocator，ArenaRLPStream从Arena分配
+ * （成员函数在RLP.cpp中实现，只对这两种分配器显式实例化）
+ */
+template <class Alloc = std::allocator<Byte>>
+class BasicRLPStream {
+public:
+    // 编码结果的类型
+    using Buffer = std::vector<Byte, Alloc>;
+
     // 默认构造空的RLP编码流
-    RLPStream() = default;
+    BasicRLPStream() = default;
+
+    // 使用指定的分配器构造空的RLP编码流
+    explicit BasicRLPStream(const Alloc& alloc) : m_out(alloc), m_listStack(alloc) {}
 
     /**
      * 开启新的列表追加流程
      * @param itemCount 新列表包含的数据项数目（若为0，直接完成空列表编码）
+     * @param alloc 分配器
      */
-    RLPStream(size_t itemCount) { appendList(itemCount); }
+    BasicRLPStream(size_t itemCount, const Alloc& alloc = Alloc()) : m_out(alloc), m_listStack(alloc) {
+        appendList(itemCount);
+    }
 
     /**
      * 开启新的列表追加流程
      * @param itemCount 新列表包含的数据项数目（若为0，直接完成空列表编码）
      * @return RLP编码流对象的引用
      */
-    RLPStream& appendList(size_t itemCount);
+    BasicRLPStream& appendList(size_t itemCount);
+
+    // 预留编码结果的内存（事先用rlpSize计算出编码长度，编码过程中不再扩容）
+    void reserve(size_t bytes) { m_out.reserve(bytes); }
 
     /**
      * 追加无符号整型到RLP编码，忽略前导零
@@ -248,11 +580,12 @@ public:
      * @throw 若长度编码大于8抛出RLPItemTooLarge异常
      */
     template<typename T>
-    RLPStream& appendInt(const T& u) {
+    BasicRLPStream& appendInt(const T& u) {
         static_assert(
             std::numeric_limits<T>::is_integer && !std::numeric_limits<T>::is_signed,
             "only unsigned types supported"
         );
+        ALLOC_SCOPE(RLP);
 
         if (!u) {
             // 字符串的长度为0，那么直接写入长度为0的编码
@@ -279,11 +612,11 @@ public:
         noteAppended();
         return *this;
     }
-    RLPStream& append(const U512& n) { return appendInt(n); }
-    RLPStream& append(const U256& n) { return appendInt(n); }
-    RLPStream& append(const U160& n) { return appendInt(n); }
-    RLPStream& append(uint64_t n) { return appendInt(n); }
-    RLPStream& append(uint32_t n) { return appendInt(n); }
+    BasicRLPStream& append(const U512& n) { return appendInt(n); }
+    BasicRLPStream& append(const U256& n) { return appendInt(n); }
+    BasicRLPStream& append(const U160& n) { return appendInt(n); }
+    BasicRLPStream& append(uint64_t n) { return appendInt(n); }
+    BasicRLPStream& append(uint32_t n) { return appendInt(n); }
 
     /**
      * 追加字节数组到RLP编码
@@ -292,28 +625,28 @@ public:
      * @return RLP编码流对象的引用
      * @throw 若长度编码大于8抛出RLPItemTooLarge异常
      */
-    RLPStream& append(BytesConstRef bs, bool ignoreLeading0s = false);
+    BasicRLPStream& append(BytesConstRef bs, bool ignoreLeading0s = false);
 
     // 追加rlp数据项
-    RLPStream& append(RLP item) { return appendRaw(item.actualData()); }
+    BasicRLPStream& append(RLP item) { return appendRaw(item.actualData()); }
 
     // 重载流操作符
     template <typename T>
-    RLPStream& operator<<(T&& data) { return append(std::forward<T>(data)); }
+    BasicRLPStream& operator<<(T&& data) { return append(std::forward<T>(data)); }
 
     /**
      * 查看当前编码结果
      * @return 当前编码结果的常量引用
      * @throw 若当前还有列表未完成编码抛出RLPIncompleteList异常
      */
-    const Bytes& peek();
+    const Buffer& peek();
 
     /**
      * 取走当前编码结果
      * @return 当前编码结果
      * @throw 若当前还有列表未完成编码抛出RLPIncompleteList异常
      */
-    Bytes take();
+    Buffer take();
 
 private:
     /**
@@ -322,7 +655,7 @@ private:
      * @return RLP编码流对象的引用
      * @throw 若造成当前列表长度编码大于8字节抛出RLPItemTooLarge异常
      */
-    RLPStream& appendRaw(BytesConstRef rawItem);
+    BasicRLPStream& appendRaw(BytesConstRef rawItem);
 
     /**
      * 通知追加了新的数据项（以便列表出栈）
@@ -339,14 +672,83 @@ private:
     void pushCount(size_t count, unsigned offset);
 
     // 编码结果
-    Bytes m_out;
+    Buffer m_out;
 
     // 嵌套的列表需要递归，这里用手动压栈的方式实现
     // top.first记录当前列表还剩多少个数据项待添加
     // top.second记录当前列表的存储起始位置
-    std::vector<std::pair<size_t, size_t>> m_listStack;
+    using ListEntry = std::pair<size_t, size_t>;
+    std::vector<ListEntry, typename std::allocator_traits<Alloc>::template rebind_alloc<ListEntry>> m_listStack;
 };
 
+// 编码结果为Bytes
+using RLPStream = BasicRLPStream<>;
+
+// 编码结果从Arena分配（默认使用当前线程安装的Arena）
+using ArenaRLPStream = BasicRLPStream<ArenaAllocator<Byte>>;
+
+extern template class BasicRLPStream<std::allocator<Byte>>;
+extern template class BasicRLPStream<ArenaAllocator<Byte>>;
+
+//------------------------------------编码长度------------------------------------//
+// 以下函数计算RLP编码的长度而不写入任何数据，用来预先分配内存，检查消息大小等
+
+// 长度为len的字符串或列表的前缀+长度编码所占字节数
+constexpr size_t rlpHeaderSize(size_t len) noexcept {
+    size_t size = 1;
+    if (len >= c_rlpDataImmLenCount) {
+        for (; len; len >>= 8) {
+            ++size;
+        }
+    }
+    return size;
+}
+
+// 载荷长度为payloadSize的列表的编码长度
+constexpr size_t rlpListSizeOfPayload(size_t payloadSize) noexcept {
+    return rlpHeaderSize(payloadSize) + payloadSize;
+}
+
+// 字符串的编码长度（与RLPStream::append(bs)一致，长度为1且小于0x80的字节编码为其本身）
+inline size_t rlpSize(BytesConstRef bs) noexcept {
+    return 1 == bs.size() && bs[0] < c_rlpDataImmLenStart ? 1 : rlpHeaderSize(bs.size()) + bs.size();
+}
+
+// 无符号整型的编码长度（忽略前导0）
+template <typename T>
+typename std::enable_if<isRLPUnsigned<T>::value, size_t>::type rlpSize(const T& u) noexcept {
+    if (u < c_rlpDataImmLenStart) {
+        return 1;
+    }
+    size_t br = bytesRequired(u);
+    return rlpHeaderSize(br) + br;
+}
+
+// 定长字节数组的编码长度（N大于1时为常量）
+template <size_t N>
+size_t rlpSize(const FixedBytes<N>& v) noexcept {
+    return N > 1 || v[0] >= c_rlpDataImmLenStart ? rlpHeaderSize(N) + N : 1;
+}
+
+// 已编码的RLP数据项的长度
+inline size_t rlpSize(const RLP& item) noexcept { return item.actualSize(); }
+
+// 数组编码为列表的长度
+template <typename T>
+typename std::enable_if<!std::is_same<T, Byte>::value, size_t>::type rlpSize(const std::vector<T>& items) noexcept {
+    size_t payload = 0;
+    for (const auto& item : items) {
+        payload += rlpSize(item);
+    }
+    return rlpListSizeOfPayload(payload);
+}
+
+// 多个数据项组成的列表的编码长度（与rlpList(items...)的结果长度一致）
+template <typename... Ts>
+size_t rlpListSize(const Ts&... items) noexcept {
+    return rlpListSizeOfPayload((size_t(0) + ... + rlpSize(items)));
+}
+
 // 计算单个字符串的RLP编码
 template <typename T>
 Bytes rlpData(T&& data) { return (RLPStream() << std::forward<T>(data)).take(); }
@@ -354,16 +756,13 @@ Bytes rlpData(T&& data) { return (RLPStream() << std::forward<T>(data)).take();
 // 计算列表的RLP编码（空列表）
 inline Bytes rlpList() { return RLPStream(0).take(); }
 
-template <typename T>
-void rlpListAux(RLPStream& out, T&& data) { out << std::forward<T>(data); }
-template <typename T, typename... Ts>
-void rlpListAux(RLPStream& out, T&& data, Ts&&... list) { rlpListAux(out << std::forward<T>(data), std::forward<Ts>(list)...); }
-
-// 计算列表的RLP编码
+// 计算列表的RLP编码（事先计算出编码长度，一次分配好内存）
 template <typename... Ts>
 Bytes rlpList(Ts&&... list) {
-    RLPStream ret(sizeof...(Ts));
-    rlpListAux(ret, std::forward<Ts>(list)...);
+    RLPStream ret;
+    ret.reserve(rlpListSize(list...));
+    ret.appendList(sizeof...(Ts));
+    (ret << ... << std::forward<Ts>(list));
     return ret.take();
 }
 
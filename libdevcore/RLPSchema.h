@@ -0,0 +1,331 @@
+/**
+ * 结构体的RLP编解码（字段只声明一次，自动生成编码器和解码器）
+ * @file: RLPSchema.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Common.h"
+#include "FixedBytes.h"
+#include "RLP.h"
+#include "SmallBytes.h"
+
+namespace dev {
+
+/**
+ * 每个需要序列化的类型都手写`RLPStream(n) << a << b << c`编码，再手写splitList()+逐个字段convert<T>()解码，
+ * 编码要经过RLPStream的列表栈和多次扩容，解码要生成中间的std::vector<RLP>，并且编码和解码的字段顺序容易改得不一致。
+ * 1. 在结构体中用RLP_FIELDS(a, b, c)按顺序声明字段，结构体编码为这些字段组成的列表，编码和解码共用这一份声明
+ * 2. rlpEncode先用rlpSize计算编码长度（H256/H160等定长字段以及全部由定长字段组成的结构体的长度在编译期确定），
+ *    一次分配好内存后直接写入，不经过RLPStream
+ * 3. rlpDecode一次遍历列表，逐个字段就地解码，不生成中间的std::vector<RLP>，
+ *    std::vector<H256>等定长字节数组的列表按固定步长解码
+ * 支持的字段类型：无符号整型（uint8_t~uint64_t，U160，U256，U512），FixedBytes<N>，Bytes，SmallBytes，std::string，
+ * 声明了RLP_FIELDS的结构体，以及以上类型的std::vector（编码为列表）
+ * 解码时字段个数不符或字段类型不符抛出RLPBadCast异常，编码不合法抛出BadRLP异常
+ */
+
+// 在结构体中按编码顺序声明RLP字段（展开为public成员函数rlpFields()）
+#define RLP_FIELDS(...)                                                         \
+    auto rlpFields() noexcept { return std::tie(__VA_ARGS__); }                 \
+    auto rlpFields() const noexcept { return std::tie(__VA_ARGS__); }
+
+/**
+ * 写入字符串或列表的前缀+长度编码
+ * @param out 输出位置（至少有rlpHeaderSize(len)字节）
+ * @param len 字符串或列表的载荷长度
+ * @param immStart 前缀起始值（字符串为c_rlpDataImmLenStart，列表为c_rlpListStart）
+ * @return 写入后的输出位置
+ */
+inline Byte* rlpWriteHeader(Byte* out, size_t len, unsigned immStart) noexcept {
+    if (len < c_rlpDataImmLenCount) {
+        *out++ = static_cast<Byte>(immStart + len);
+    } else {
+        unsigned br = bytesRequired(len);
+        *out++ = static_cast<Byte>(immStart + c_rlpDataImmLenCount - 1 + br);
+        toBigEndian(len, BytesRef(out, br));
+        out += br;
+    }
+    return out;
+}
+
+// 写入字节串的编码（长度为1且小于0x80的字节编码为其本身）
+inline Byte* rlpWriteBytes(Byte* out, const Byte* data, size_t size) noexcept {
+    if (1 == size && data[0] < c_rlpDataImmLenStart) {
+        *out++ = data[0];
+        return out;
+    }
+    out = rlpWriteHeader(out, size, c_rlpDataImmLenStart);
+    if (size) {
+        memcpy(out, data, size);
+    }
+    return out + size;
+}
+
+/**
+ * 字段类型的编解码（按类型特化）
+ * c_fixedSize: 编码长度固定时为编码长度，否则为0
+ * size(v): 编码长度
+ * encode(v, out): 写入编码，返回写入后的输出位置
+ * decode(item, v): 从RLP数据项解码
+ */
+template <typename T, typename Enable = void>
+struct RLPCodec;
+
+// 判断结构体是否声明了RLP_FIELDS
+template <typename T, typename Enable = void>
+struct hasRLPFields : std::false_type {};
+template <typename T>
+struct hasRLPFields<T, decltype(std::declval<const T&>().rlpFields(), void())> : std::true_type {};
+
+// 无符号整型（去掉前导0后按字节串编码）
+template <typename T>
+struct RLPCodec<T, typename std::enable_if<isRLPUnsigned<T>::value>::type> {
+    static constexpr size_t c_fixedSize = 0;
+
+    static size_t size(const T& v) noexcept { return rlpSize(v); }
+
+    static Byte* encode(const T& v, Byte* out) noexcept {
+        if (!v) {
+            *out++ = c_rlpDataImmLenStart;
+        } else if (v < c_rlpDataImmLenStart) {
+            *out++ = static_cast<Byte>(v);
+        } else {
+            unsigned br = bytesRequired(v);
+            out = rlpWriteHeader(out, br, c_rlpDataImmLenStart);
+            toBigEndian(v, BytesRef(out, br));
+            out += br;
+        }
+        return out;
+    }
+
+    static void decode(const RLP& item, T& v) { v = item.toInt<T>(); }
+};
+
+// 定长字节数组（N大于1时编码长度固定）
+template <size_t N>
+struct RLPCodec<FixedBytes<N>> {
+    static constexpr size_t c_fixedSize = N > 1 ? rlpHeaderSize(N) + N : 0;
+
+    static size_t size(const FixedBytes<N>& v) noexcept { return rlpSize(v); }
+
+    static Byte* encode(const FixedBytes<N>& v, Byte* out) noexcept { return rlpWriteBytes(out, v.data(), N); }
+
+    // 长度不符时抛出RLPBadCast异常（而不是toFixedBytes的Unaligned异常），与其它字段类型不符时一致
+    static void decode(const RLP& item, FixedBytes<N>& v) {
+        if (!item.isData() || N != item.payload().size()) {
+            throw RLPBadCast();
+        }
+        v = FixedBytes<N>(item.payload());
+    }
+};
+
+// 字节数组
+template <>
+struct RLPCodec<Bytes> {
+    static constexpr size_t c_fixedSize = 0;
+
+    static size_t size(const Bytes& v) noexcept { return rlpSize(BytesConstRef(v)); }
+
+    static Byte* encode(const Bytes& v, Byte* out) noexcept { return rlpWriteBytes(out, v.data(), v.size()); }
+
+    static void decode(const RLP& item, Bytes& v) { v = item.toBytes(); }
+};
+
+// 小字节数组（不超过64字节时解码不分配堆内存）
+template <>
+struct RLPCodec<SmallBytes> {
+    static constexpr size_t c_fixedSize = 0;
+
+    static size_t size(const SmallBytes& v) noexcept { return rlpSize(v.ref()); }
+
+    static Byte* encode(const SmallBytes& v, Byte* out) noexcept { return rlpWriteBytes(out, v.data(), v.size()); }
+
+    static void decode(const RLP& item, SmallBytes& v) { v = item.toSmallBytes(); }
+};
+
+// 字符串
+template <>
+struct RLPCodec<std::string> {
+    static constexpr size_t c_fixedSize = 0;
+
+    static size_t size(const std::string& v) noexcept { return rlpSize(BytesConstRef(v)); }
+
+    static Byte* encode(const std::string& v, Byte* out) noexcept {
+        return rlpWriteBytes(out, reinterpret_cast<const Byte*>(v.data()), v.size());
+    }
+
+    static void decode(const RLP& item, std::string& v) { v = item.toString(); }
+};
+
+/**
+ * 依次解码列表载荷中的下一个数据项
+ * @param rest 列表中剩余的载荷（解码后去掉该数据项）
+ * @param v 输出
+ * @throw 载荷已经用完抛出RLPBadCast异常
+ */
+template <typename T>
+void rlpDecodeNext(BytesConstRef& rest, T& v) {
+    if (rest.empty()) {
+        throw RLPBadCast();
+    }
+    RLP item(rest, false);
+    rest = rest.cropped(item.actualSize());
+    RLPCodec<T>::decode(item, v);
+}
+
+// 数组（编码为列表，元素编码长度固定时载荷长度为元素个数乘以元素编码长度）
+template <typename T>
+struct RLPCodec<std::vector<T>, typename std::enable_if<!std::is_same<T, Byte>::value>::type> {
+    static constexpr size_t c_fixedSize = 0;
+
+    static size_t payloadSize(const std::vector<T>& v) noexcept {
+        if (RLPCodec<T>::c_fixedSize) {
+            return v.size() * RLPCodec<T>::c_fixedSize;
+        }
+        size_t size = 0;
+        for (const auto& e : v) {
+            size += RLPCodec<T>::size(e);
+        }
+        return size;
+    }
+
+    static size_t size(const std::vector<T>& v) noexcept { return rlpListSizeOfPayload(payloadSize(v)); }
+
+    static Byte* encode(const std::vector<T>& v, Byte* out) noexcept {
+        out = rlpWriteHeader(out, payloadSize(v), c_rlpListStart);
+        for (const auto& e : v) {
+            out = RLPCodec<T>::encode(e, out);
+        }
+        return out;
+    }
+
+    static void decode(const RLP& item, std::vector<T>& v) {
+        if (!item.isList()) {
+            throw RLPBadCast();
+        }
+        if constexpr (isFixedStrideBytes<T>::value) {
+            // 哈希列表等按固定步长直接复制，不逐个解析前缀
+            if (item.isFixedStrideList(isFixedStrideBytes<T>::c_size)) {
+                v = RLPFixedBytesView<isFixedStrideBytes<T>::c_size>(item.payload()).toVector();
+                return;
+            }
+        }
+        v.clear();
+        BytesConstRef rest = item.payload();
+        while (!rest.empty()) {
+            v.emplace_back();
+            rlpDecodeNext(rest, v.back());
+        }
+    }
+};
+
+// 声明了RLP_FIELDS的结构体（编码为字段组成的列表）
+template <typename T>
+struct RLPCodec<T, typename std::enable_if<hasRLPFields<T>::value>::type> {
+private:
+    using Fields = decltype(std::declval<const T&>().rlpFields());
+
+    // 所有字段都是定长时的载荷长度，否则为0
+    template <size_t... Is>
+    static constexpr size_t fixedPayloadSize(std::index_sequence<Is...>) noexcept {
+        constexpr bool allFixed = (... && (RLPCodec<typename std::decay<
+            typename std::tuple_element<Is, Fields>::type>::type>::c_fixedSize != 0));
+        return allFixed ? (size_t(0) + ... + RLPCodec<typename std::decay<
+            typename std::tuple_element<Is, Fields>::type>::type>::c_fixedSize) : 0;
+    }
+
+    static constexpr size_t c_fixedPayloadSize = fixedPayloadSize(std::make_index_sequence<std::tuple_size<Fields>::value>());
+
+public:
+    static constexpr size_t c_fixedSize = c_fixedPayloadSize ? rlpHeaderSize(c_fixedPayloadSize) + c_fixedPayloadSize : 0;
+
+    static size_t payloadSize(const T& v) noexcept {
+        if constexpr (c_fixedPayloadSize != 0) {
+            (void)v;
+            return c_fixedPayloadSize;
+        } else {
+            return std::apply([](const auto&... fields) {
+                return (size_t(0) + ... + RLPCodec<typename std::decay<decltype(fields)>::type>::size(fields));
+            }, v.rlpFields());
+        }
+    }
+
+    static size_t size(const T& v) noexcept { return rlpListSizeOfPayload(payloadSize(v)); }
+
+    static Byte* encode(const T& v, Byte* out) noexcept {
+        out = rlpWriteHeader(out, payloadSize(v), c_rlpListStart);
+        std::apply([&out](const auto&... fields) {
+            ((out = RLPCodec<typename std::decay<decltype(fields)>::type>::encode(fields, out)), ...);
+        }, v.rlpFields());
+        return out;
+    }
+
+    static void decode(const RLP& item, T& v) {
+        if (!item.isList()) {
+            throw RLPBadCast();
+        }
+        BytesConstRef rest = item.payload();
+        std::apply([&rest](auto&... fields) { (rlpDecodeNext(rest, fields), ...); }, v.rlpFields());
+        if (!rest.empty()) {
+            // 字段比声明的多
+            throw RLPBadCast();
+        }
+    }
+};
+
+// 声明了RLP_FIELDS的结构体的编码长度（不写入任何数据）
+template <typename T>
+typename std::enable_if<hasRLPFields<T>::value, size_t>::type rlpSize(const T& v) noexcept { return RLPCodec<T>::size(v); }
+
+/**
+ * 编码到调用方提供的内存中
+ * @param v 要编码的值
+ * @param out 输出，长度至少为rlpSize(v)
+ * @return 写入的字节数
+ * @throw out长度不足抛出OutOfRange异常
+ */
+template <typename T>
+size_t rlpEncode(const T& v, BytesRef out) {
+    size_t size = RLPCodec<T>::size(v);
+    if (out.size() < size) {
+        throw OutOfRange();
+    }
+    RLPCodec<T>::encode(v, out.data());
+    return size;
+}
+
+// 编码（一次分配正好长度的内存）
+template <typename T>
+Bytes rlpEncode(const T& v) {
+    ALLOC_SCOPE(RLP);
+    Bytes out(RLPCodec<T>::size(v));
+    RLPCodec<T>::encode(v, out.data());
+    return out;
+}
+
+/**
+ * 解码到已有对象中
+ * @param rlp 完整的RLP编码（后面不能有多余的数据）
+ * @param v 输出
+ * @throw 编码不合法抛出BadRLP异常，字段个数或类型不符抛出RLPBadCast异常
+ */
+template <typename T>
+void rlpDecode(BytesConstRef rlp, T& v) { RLPCodec<T>::decode(RLP(rlp), v); }
+
+// 解码（异常同上）
+template <typename T>
+T rlpDecode(BytesConstRef rlp) {
+    T v;
+    rlpDecode(rlp, v);
+    return v;
+}
+
+}   // namespace dev
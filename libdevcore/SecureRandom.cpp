@@ -0,0 +1,223 @@
+/**
+ * 密码学安全的伪随机数生成器（基于ChaCha20）
+ * @file: SecureRandom.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "SecureRandom.h"
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace dev {
+
+static inline uint32_t rotl32(uint32_t x, unsigned s) {
+    return (x << s) | (x >> (32 - s));
+}
+
+// 四分之一轮
+#define CHACHA_QR(a, b, c, d)                \
+    a += b; d ^= a; d = rotl32(d, 16);       \
+    c += d; b ^= c; b = rotl32(b, 12);       \
+    a += b; d ^= a; d = rotl32(d, 8);        \
+    c += d; b ^= c; b = rotl32(b, 7);
+
+/**
+ * 计算一个ChaCha20密钥流块（原始DJB版本，64位计数器+64位nonce，20轮）
+ * @param key 256位密钥（8个小端序字）
+ * @param counter 块计数器
+ * @param nonce 随机数
+ * @param out 输出的64字节密钥流
+ */
+void chacha20Block(const uint32_t key[8], uint64_t counter, uint64_t nonce, Byte out[64]) noexcept {
+    // 常量"expand 32-byte k"
+    uint32_t in[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+        static_cast<uint32_t>(nonce), static_cast<uint32_t>(nonce >> 32)
+    };
+    uint32_t x[16];
+    memcpy(x, in, sizeof(x));
+
+    // 10次双轮（列轮+对角线轮）
+    for (int i = 0; i < 10; ++i) {
+        CHACHA_QR(x[0], x[4], x[8], x[12]);
+        CHACHA_QR(x[1], x[5], x[9], x[13]);
+        CHACHA_QR(x[2], x[6], x[10], x[14]);
+        CHACHA_QR(x[3], x[7], x[11], x[15]);
+        CHACHA_QR(x[0], x[5], x[10], x[15]);
+        CHACHA_QR(x[1], x[6], x[11], x[12]);
+        CHACHA_QR(x[2], x[7], x[8], x[13]);
+        CHACHA_QR(x[3], x[4], x[9], x[14]);
+    }
+
+    // 输出为小端序
+    for (int i = 0; i < 16; ++i) {
+        uint32_t v = x[i] + in[i];
+        out[i * 4 + 0] = static_cast<Byte>(v);
+        out[i * 4 + 1] = static_cast<Byte>(v >> 8);
+        out[i * 4 + 2] = static_cast<Byte>(v >> 16);
+        out[i * 4 + 3] = static_cast<Byte>(v >> 24);
+    }
+}
+
+#undef CHACHA_QR
+
+/**
+ * 直接从操作系统获取随机数（每次调用都是系统调用，仅用于生成种子）
+ * @param out 输出缓冲区
+ */
+void osRandom(BytesRef out) noexcept {
+    Byte* p = out.data();
+    size_t n = out.size();
+
+#if defined(__linux__) && defined(SYS_getrandom)
+    // 优先使用getrandom，不需要打开文件，也不受文件描述符耗尽的影响
+    while (n > 0) {
+        long r = syscall(SYS_getrandom, p, n, 0);
+        if (r < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        p += r;
+        n -= r;
+    }
+#endif
+
+    // 退化为读取/dev/urandom
+    if (n > 0) {
+        int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        while (fd >= 0 && n > 0) {
+            ssize_t r = read(fd, p, n);
+            if (r <= 0) {
+                if (r < 0 && EINTR == errno) {
+                    continue;
+                }
+                break;
+            }
+            p += r;
+            n -= r;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // 拿不到系统随机数时继续运行是不安全的（会生成可预测的私钥）
+    if (n > 0) {
+        std::abort();
+    }
+}
+
+// fork代数，子进程中加1，各线程的CSPRNG发现代数变化后重新获取种子（避免父子进程输出相同的随机数）
+static std::atomic<uint32_t> s_forkGeneration(0);
+
+static void onFork() {
+    s_forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 用操作系统的随机数初始化
+CSPRNG::CSPRNG() {
+    static std::once_flag s_atforkFlag;
+    std::call_once(s_atforkFlag, [] { pthread_atfork(nullptr, nullptr, &onFork); });
+
+    memset(m_key, 0, sizeof(m_key));
+    memset(m_buffer, 0, sizeof(m_buffer));
+    reseed();
+}
+
+// 析构时清除内部状态
+CSPRNG::~CSPRNG() {
+    volatile Byte* p = reinterpret_cast<volatile Byte*>(m_key);
+    for (size_t i = 0; i < sizeof(m_key); ++i) {
+        p[i] = 0;
+    }
+    p = m_buffer;
+    for (size_t i = 0; i < sizeof(m_buffer); ++i) {
+        p[i] = 0;
+    }
+}
+
+// 用随机数填充字节数组
+void CSPRNG::fill(BytesRef out) noexcept {
+    if (m_sinceReseed >= c_reseedInterval ||
+        m_forkGeneration != s_forkGeneration.load(std::memory_order_relaxed)) {
+        reseed();
+    }
+
+    Byte* p = out.data();
+    size_t n = out.size();
+    while (n > 0) {
+        if (0 == m_available) {
+            refill();
+        }
+        size_t take = std::min(n, m_available);
+        Byte* src = m_buffer + c_bufferSize - m_available;
+        memcpy(p, src, take);
+        // 已输出的密钥流立即清除
+        memset(src, 0, take);
+        m_available -= take;
+        p += take;
+        n -= take;
+    }
+    m_sinceReseed += out.size();
+}
+
+// 从操作系统重新获取种子，混入当前密钥
+void CSPRNG::reseed() noexcept {
+    uint32_t seed[8];
+    osRandom(BytesRef(reinterpret_cast<Byte*>(seed), sizeof(seed)));
+    for (int i = 0; i < 8; ++i) {
+        m_key[i] ^= seed[i];
+    }
+    memset(seed, 0, sizeof(seed));
+
+    // 丢弃旧密钥生成的缓存
+    memset(m_buffer, 0, sizeof(m_buffer));
+    m_available = 0;
+    m_sinceReseed = 0;
+    m_forkGeneration = s_forkGeneration.load(std::memory_order_relaxed);
+}
+
+// 生成一批新的密钥流，并用其前32字节替换密钥
+void CSPRNG::refill() noexcept {
+    // 每次都换新密钥，计数器可以从0开始
+    for (size_t i = 0; i < c_bufferSize / 64; ++i) {
+        chacha20Block(m_key, i, 0, m_buffer + i * 64);
+    }
+    memcpy(m_key, m_buffer, sizeof(m_key));
+    memset(m_buffer, 0, sizeof(m_key));
+    m_available = c_bufferSize - sizeof(m_key);
+}
+
+// 当前线程的CSPRNG
+static CSPRNG& threadCSPRNG() {
+    static thread_local CSPRNG t_csprng;
+    return t_csprng;
+}
+
+// 用当前线程的CSPRNG填充随机数
+void secureRandom(BytesRef out) noexcept {
+    threadCSPRNG().fill(out);
+}
+
+// 生成一个64位随机数
+uint64_t secureRandom64() noexcept {
+    uint64_t ret;
+    threadCSPRNG().fill(BytesRef(reinterpret_cast<Byte*>(&ret), sizeof(ret)));
+    return ret;
+}
+
+}   // namespace dev
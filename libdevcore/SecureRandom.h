@@ -0,0 +1,80 @@
+/**
+ * 密码学安全的伪随机数生成器（基于ChaCha20）
+ * @file: SecureRandom.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "Common.h"
+
+namespace dev {
+
+/**
+ * 直接从/dev/urandom或getrandom读取随机数，每次都需要一次系统调用，逐字节读取时性能非常差
+ * 这里参考OpenBSD的arc4random实现：
+ * 1. 每个线程维护一个ChaCha20生成器，密钥由操作系统的随机数初始化（getrandom）
+ * 2. 每次生成一批（1KB）密钥流，前32字节立即作为新的密钥（fast key erasure），已经输出的随机数不会被反推
+ * 3. 每输出c_reseedInterval字节，或者进程fork之后，重新从操作系统获取随机数混入密钥
+ * 生成的随机数可以用于私钥，nonce等对安全性有要求的场合
+ */
+
+/**
+ * 计算一个ChaCha20密钥流块（原始DJB版本，64位计数器+64位nonce，20轮）
+ * @param key 256位密钥（8个小端序字）
+ * @param counter 块计数器
+ * @param nonce 随机数
+ * @param out 输出的64字节密钥流
+ */
+void chacha20Block(const uint32_t key[8], uint64_t counter, uint64_t nonce, Byte out[64]) noexcept;
+
+// 每个线程独立使用的ChaCha20随机数生成器
+class CSPRNG {
+public:
+    // 两次从操作系统重新获取种子之间最多输出的字节数
+    static constexpr uint64_t c_reseedInterval = 1 << 20;
+
+    // 用操作系统的随机数初始化
+    CSPRNG();
+
+    // 析构时清除内部状态
+    ~CSPRNG();
+
+    CSPRNG(const CSPRNG&) = delete;
+    CSPRNG& operator=(const CSPRNG&) = delete;
+
+    // 用随机数填充字节数组
+    void fill(BytesRef out) noexcept;
+
+    // 从操作系统重新获取种子，混入当前密钥
+    void reseed() noexcept;
+
+private:
+    // 生成一批新的密钥流，并用其前32字节替换密钥
+    void refill() noexcept;
+
+    // 一批密钥流的长度
+    static constexpr size_t c_bufferSize = 16 * 64;
+
+    uint32_t m_key[8];                  // 当前密钥
+    Byte m_buffer[c_bufferSize];        // 密钥流缓存
+    size_t m_available = 0;             // 缓存中剩余可用字节数（位于缓存末尾）
+    uint64_t m_sinceReseed = 0;         // 上次获取种子之后输出的字节数
+    uint32_t m_forkGeneration = 0;      // 上次获取种子时的fork代数
+};
+
+// 用当前线程的CSPRNG填充随机数
+void secureRandom(BytesRef out) noexcept;
+
+// 生成一个64位随机数
+uint64_t secureRandom64() noexcept;
+
+/**
+ * 直接从操作系统获取随机数（每次调用都是系统调用，仅用于生成种子）
+ * @param out 输出缓冲区
+ */
+void osRandom(BytesRef out) noexcept;
+
+}   // namespace dev
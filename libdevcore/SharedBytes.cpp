@@ -0,0 +1,71 @@
+/**
+ * 引用计数的不可变字节数组
+ * @file: SharedBytes.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "SharedBytes.h"
+#include <algorithm>
+
+namespace dev {
+
+// 接管Bytes的内存（不拷贝）
+SharedBytes::SharedBytes(Bytes&& bs) : m_size(bs.size()) {
+    m_backing = std::make_shared<Bytes>(std::move(bs));
+}
+
+// 拷贝字节数组引用指向的数据
+SharedBytes::SharedBytes(BytesConstRef bs)
+: m_backing(std::make_shared<Bytes>(bs.begin(), bs.end())), m_size(bs.size()) {}
+
+// 引用整块共享内存（之后调用方不能再修改其中的数据）
+SharedBytes::SharedBytes(std::shared_ptr<Bytes> backing) noexcept
+: m_backing(std::move(backing)), m_size(m_backing ? m_backing->size() : 0) {}
+
+// 引用SmallBytes的共享存储（不拷贝，内联存储时拷贝）
+SharedBytes::SharedBytes(const SmallBytes& bs) : m_size(bs.size()) {
+    if (bs.m_backing) {
+        m_backing = bs.m_backing;
+        m_offset = bs.m_offset;
+    } else if (!bs.empty()) {
+        m_backing = std::make_shared<Bytes>(bs.begin(), bs.end());
+    }
+}
+
+// 转换为SmallBytes（共享底层内存，不拷贝）
+SmallBytes SharedBytes::toSmallBytes() const {
+    return m_backing ? SmallBytes::share(m_backing, m_offset, m_size) : SmallBytes();
+}
+
+// 截取[beg, min(beg + cnt, size))范围的子数组（不拷贝），若beg大于size抛出OutOfRange异常
+SharedBytes SharedBytes::cropped(size_t beg, size_t cnt) const {
+    if (beg > m_size) {
+        throw OutOfRange();
+    }
+    SharedBytes ret;
+    ret.m_backing = m_backing;
+    ret.m_offset = m_offset + beg;
+    ret.m_size = std::min(m_size - beg, cnt);
+    return ret;
+}
+
+/**
+ * 将指向当前字节数组内部的引用转换为SharedBytes（不拷贝）
+ * @param sub 指向当前字节数组内部的引用（比如从ref()解析出来的RLP数据项）
+ * @return 共享同一块底层内存的子数组
+ * @throw 若sub不在当前字节数组范围内抛出OutOfRange异常
+ */
+SharedBytes SharedBytes::slice(BytesConstRef sub) const {
+    if (sub.empty()) {
+        return SharedBytes();
+    }
+    // 用整数比较地址，避免比较不相关的指针
+    auto beg = reinterpret_cast<uintptr_t>(data());
+    auto subBeg = reinterpret_cast<uintptr_t>(sub.data());
+    if (!m_backing || subBeg < beg || subBeg - beg > m_size || sub.size() > m_size - (subBeg - beg)) {
+        throw OutOfRange();
+    }
+    return cropped(subBeg - beg, sub.size());
+}
+
+}   // namespace dev
@@ -0,0 +1,94 @@
+/**
+ * 引用计数的不可变字节数组
+ * @file: SharedBytes.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstring>
+#include "Common.h"
+#include "Exceptions.h"
+#include "SmallBytes.h"
+
+namespace dev {
+
+/**
+ * BytesConstRef只是裸指针+长度，需要调用者自己保证被引用数据的生命周期，
+ * 把解码出来的字段交给其它线程时只能深拷贝一份。
+ * SharedBytes是一块引用计数的不可变内存中的一段（类似folly::IOBuf），
+ * 拷贝和截取子数组只增加引用计数，不拷贝数据，只要还有SharedBytes引用，底层内存就不会释放。
+ * 底层内存不可修改，所以可以在线程之间自由传递。
+ * 底层内存与SmallBytes的共享存储是同一种类型（std::shared_ptr<Bytes>），两者可以互相转换而不拷贝；
+ * SmallBytes只在独占共享存储时原地修改，被SharedBytes引用的内存不会被修改。
+ */
+class SharedBytes {
+public:
+    // 值类型（使得可以隐式转换为BytesConstRef）
+    using value_type = Byte;
+    using const_iterator = const Byte*;
+
+    // 构造空字节数组
+    SharedBytes() noexcept = default;
+
+    // 接管Bytes的内存（不拷贝）
+    explicit SharedBytes(Bytes&& bs);
+
+    // 拷贝字节数组引用指向的数据
+    explicit SharedBytes(BytesConstRef bs);
+
+    // 引用整块共享内存（之后调用方不能再修改其中的数据）
+    explicit SharedBytes(std::shared_ptr<Bytes> backing) noexcept;
+
+    // 引用SmallBytes的共享存储（不拷贝，内联存储时拷贝）
+    explicit SharedBytes(const SmallBytes& bs);
+
+    // 长度
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return 0 == m_size; }
+
+    // 只读访问
+    const Byte* data() const noexcept { return m_backing ? m_backing->data() + m_offset : nullptr; }
+    const Byte& operator[](size_t idx) const noexcept { return data()[idx]; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + m_size; }
+
+    // 转换为字节数组引用（引用的有效期不超过当前对象或其拷贝的生命周期）
+    BytesConstRef ref() const noexcept { return BytesConstRef(data(), m_size); }
+
+    // 底层内存的引用计数
+    long useCount() const noexcept { return m_backing.use_count(); }
+
+    // 截取[beg, min(beg + cnt, size))范围的子数组（不拷贝），若beg大于size抛出OutOfRange异常
+    SharedBytes cropped(size_t beg, size_t cnt = static_cast<size_t>(-1)) const;
+
+    /**
+     * 将指向当前字节数组内部的引用转换为SharedBytes（不拷贝）
+     * @param sub 指向当前字节数组内部的引用（比如从ref()解析出来的RLP数据项）
+     * @return 共享同一块底层内存的子数组
+     * @throw 若sub不在当前字节数组范围内抛出OutOfRange异常
+     */
+    SharedBytes slice(BytesConstRef sub) const;
+
+    // 转换为SmallBytes（共享底层内存，不拷贝）
+    SmallBytes toSmallBytes() const;
+
+    // 转换为Bytes和字符串（拷贝）
+    Bytes toBytes() const { return Bytes(begin(), end()); }
+    std::string toString() const { return ref().toString(); }
+
+    // 比较
+    bool operator==(const SharedBytes& rhs) const noexcept {
+        return m_size == rhs.m_size && (0 == m_size || 0 == memcmp(data(), rhs.data(), m_size));
+    }
+    bool operator!=(const SharedBytes& rhs) const noexcept { return !(*this == rhs); }
+
+private:
+    std::shared_ptr<Bytes> m_backing;           // 底层内存（只读）
+    size_t m_offset = 0;                        // 起始位置
+    size_t m_size = 0;                          // 长度
+};
+
+}   // namespace dev
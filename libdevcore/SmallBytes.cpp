@@ -0,0 +1,175 @@
+/**
+ * 带小对象优化的字节数组类型
+ * @file: SmallBytes.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "SmallBytes.h"
+#include <algorithm>
+#include <functional>
+
+namespace dev {
+
+// 接管Bytes的内存（长度较小时拷贝到内联存储）
+SmallBytes::SmallBytes(Bytes&& bs) {
+    if (bs.size() <= c_inlineCapacity) {
+        assign(bs);
+    } else {
+        m_size = bs.size();
+        m_backing = std::make_shared<Bytes>(std::move(bs));
+    }
+}
+
+/**
+ * 引用共享内存中的一段数据（不拷贝）
+ * @param backing 共享内存
+ * @param offset 起始位置
+ * @param size 长度
+ * @throw 若超出共享内存的范围抛出OutOfRange异常
+ */
+SmallBytes SmallBytes::share(std::shared_ptr<Bytes> backing, size_t offset, size_t size) {
+    if (!backing || offset > backing->size() || size > backing->size() - offset) {
+        throw OutOfRange();
+    }
+    SmallBytes ret;
+    ret.m_backing = std::move(backing);
+    ret.m_offset = offset;
+    ret.m_size = size;
+    return ret;
+}
+
+// 可写访问（共享存储被其它对象引用时先拷贝一份）
+Byte* SmallBytes::mutableData() {
+    if (!m_backing) {
+        return m_inline;
+    }
+    if (m_backing.use_count() > 1) {
+        // 写时复制
+        if (m_size <= c_inlineCapacity) {
+            assign(ref());
+            return m_inline;
+        }
+        ownedBacking();
+    }
+    return m_backing->data() + m_offset;
+}
+
+// 截取[beg, min(beg + cnt, size))范围的子数组（共享存储时不拷贝），若beg大于size抛出OutOfRange异常
+SmallBytes SmallBytes::cropped(size_t beg, size_t cnt) const {
+    if (beg > m_size) {
+        throw OutOfRange();
+    }
+    cnt = std::min(m_size - beg, cnt);
+    if (!m_backing) {
+        return SmallBytes(BytesConstRef(m_inline + beg, cnt));
+    }
+    SmallBytes ret;
+    ret.m_backing = m_backing;
+    ret.m_offset = m_offset + beg;
+    ret.m_size = cnt;
+    return ret;
+}
+
+// 替换为bs的内容
+void SmallBytes::assign(BytesConstRef bs) {
+    if (bs.size() <= c_inlineCapacity) {
+        // bs可能指向当前对象的共享存储，先拷贝再释放
+        memmove(m_inline, bs.data(), bs.size());
+        m_backing.reset();
+        m_offset = 0;
+    } else if (m_backing && m_backing.use_count() == 1 && !std::less<const Byte*>()(bs.data(), m_backing->data())
+        && !std::less<const Byte*>()(m_backing->data() + m_backing->size(), bs.data() + bs.size())) {
+        // bs指向当前对象独占的共享存储，原地截取
+        m_offset = bs.data() - m_backing->data();
+    } else {
+        m_backing = std::make_shared<Bytes>(bs.begin(), bs.end());
+        m_offset = 0;
+    }
+    m_size = bs.size();
+}
+
+// 追加数据
+void SmallBytes::append(BytesConstRef bs) {
+    if (!m_backing && m_size + bs.size() <= c_inlineCapacity) {
+        memcpy(m_inline + m_size, bs.data(), bs.size());
+        m_size += bs.size();
+        return;
+    }
+
+    // bs可能指向自身，先拷贝出来
+    auto selfBegin = data();
+    if (!std::less<const Byte*>()(bs.data(), selfBegin) && std::less<const Byte*>()(bs.data(), selfBegin + m_size)) {
+        Bytes tmp(bs.begin(), bs.end());
+        append(tmp);
+        return;
+    }
+
+    Bytes& buf = ownedBacking();
+    buf.insert(buf.end(), bs.begin(), bs.end());
+    m_size = buf.size();
+}
+
+// 调整长度，新增的字节初始化为0
+void SmallBytes::resize(size_t size) {
+    if (!m_backing && size <= c_inlineCapacity) {
+        if (size > m_size) {
+            memset(m_inline + m_size, 0, size - m_size);
+        }
+        m_size = size;
+        return;
+    }
+    if (size <= m_size) {
+        // 缩短只需要调整视图
+        m_size = size;
+        return;
+    }
+
+    Bytes& buf = ownedBacking();
+    buf.resize(size);
+    m_size = size;
+}
+
+// 拷贝另一个对象的内容
+void SmallBytes::copyFrom(const SmallBytes& other) noexcept {
+    if (other.m_backing) {
+        m_backing = other.m_backing;
+    } else {
+        m_backing.reset();
+        memcpy(m_inline, other.m_inline, other.m_size);
+    }
+    m_offset = other.m_offset;
+    m_size = other.m_size;
+}
+
+// 移动另一个对象的内容
+void SmallBytes::moveFrom(SmallBytes& other) noexcept {
+    if (other.m_backing) {
+        m_backing = std::move(other.m_backing);
+    } else {
+        m_backing.reset();
+        memcpy(m_inline, other.m_inline, other.m_size);
+    }
+    m_offset = other.m_offset;
+    m_size = other.m_size;
+    other.m_offset = 0;
+    other.m_size = 0;
+}
+
+// 获取独占的堆存储（调用后m_offset为0，并且*m_backing的长度就是m_size）
+Bytes& SmallBytes::ownedBacking() {
+    if (!m_backing) {
+        // 从内联存储转移到堆存储，预留两倍空间
+        auto buf = std::make_shared<Bytes>();
+        buf->reserve(c_inlineCapacity * 2);
+        buf->assign(m_inline, m_inline + m_size);
+        m_backing = std::move(buf);
+    } else if (m_backing.use_count() > 1 || 0 != m_offset || m_backing->size() != m_size) {
+        // 被共享或只是其中一段，拷贝一份
+        const Byte* p = m_backing->data() + m_offset;
+        m_backing = std::make_shared<Bytes>(p, p + m_size);
+    }
+    m_offset = 0;
+    return *m_backing;
+}
+
+}   // namespace dev
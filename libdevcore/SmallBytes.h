@@ -0,0 +1,141 @@
+/**
+ * 带小对象优化的字节数组类型
+ * @file: SmallBytes.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstring>
+#include "Common.h"
+#include "Exceptions.h"
+
+namespace dev {
+
+/**
+ * 地址，哈希值，短的RLP数据项，日志topic等大部分字节数组都不超过64字节，
+ * 用Bytes（std::vector）存放时每个对象都要单独分配一次堆内存。
+ * SmallBytes有两种存储方式：
+ * 1. 内联存储：长度不超过c_inlineCapacity时直接存放在对象内部，不需要分配堆内存
+ * 2. 共享存储：引用计数的堆内存（std::shared_ptr<Bytes>，与SharedBytes相同）中的一段，拷贝和截取子数组时只增加引用计数，
+ *    可以直接引用大消息中的一段而不需要拷贝，修改时若存储被共享则先拷贝一份（写时复制）
+ * 为了避免不经意间触发写时复制，只读访问用data()，需要修改时显式调用mutableData()
+ */
+class SmallBytes {
+public:
+    // 内联存储的最大长度
+    static constexpr size_t c_inlineCapacity = 64;
+
+    // 值类型（使得可以隐式转换为BytesConstRef）
+    using value_type = Byte;
+    using const_iterator = const Byte*;
+
+    // 构造空字节数组
+    SmallBytes() noexcept = default;
+
+    // 构造长度为size的字节数组，所有字节初始化为0
+    explicit SmallBytes(size_t size) { resize(size); }
+
+    // 拷贝字节数组引用指向的数据
+    explicit SmallBytes(BytesConstRef bs) { assign(bs); }
+
+    // 接管Bytes的内存（长度较小时拷贝到内联存储）
+    explicit SmallBytes(Bytes&& bs);
+
+    // 拷贝构造/赋值（共享存储时只增加引用计数）
+    SmallBytes(const SmallBytes& other) noexcept { copyFrom(other); }
+    SmallBytes& operator=(const SmallBytes& other) noexcept {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // 移动构造/赋值
+    SmallBytes(SmallBytes&& other) noexcept { moveFrom(other); }
+    SmallBytes& operator=(SmallBytes&& other) noexcept {
+        if (this != &other) {
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * 引用共享内存中的一段数据（不拷贝）
+     * @param backing 共享内存
+     * @param offset 起始位置
+     * @param size 长度
+     * @throw 若超出共享内存的范围抛出OutOfRange异常
+     */
+    static SmallBytes share(std::shared_ptr<Bytes> backing, size_t offset, size_t size);
+
+    // 长度
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return 0 == m_size; }
+
+    // 是否为内联存储
+    bool isInline() const noexcept { return !m_backing; }
+
+    // 只读访问
+    const Byte* data() const noexcept { return m_backing ? m_backing->data() + m_offset : m_inline; }
+    const Byte& operator[](size_t idx) const noexcept { return data()[idx]; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + m_size; }
+
+    // 可写访问（共享存储被其它对象引用时先拷贝一份）
+    Byte* mutableData();
+    BytesRef mutableRef() { return BytesRef(mutableData(), m_size); }
+
+    // 转换为字节数组引用
+    BytesConstRef ref() const noexcept { return BytesConstRef(data(), m_size); }
+
+    // 截取[beg, min(beg + cnt, size))范围的子数组（共享存储时不拷贝），若beg大于size抛出OutOfRange异常
+    SmallBytes cropped(size_t beg, size_t cnt = static_cast<size_t>(-1)) const;
+
+    // 替换为bs的内容
+    void assign(BytesConstRef bs);
+
+    // 追加数据
+    void append(BytesConstRef bs);
+    void push_back(Byte b) { append(BytesConstRef(&b, 1)); }
+
+    // 调整长度，新增的字节初始化为0
+    void resize(size_t size);
+
+    // 清空（释放共享存储）
+    void clear() noexcept {
+        m_backing.reset();
+        m_offset = 0;
+        m_size = 0;
+    }
+
+    // 转换为Bytes和字符串
+    Bytes toBytes() const { return Bytes(begin(), end()); }
+    std::string toString() const { return ref().toString(); }
+
+    // 比较
+    bool operator==(const SmallBytes& rhs) const noexcept {
+        return m_size == rhs.m_size && 0 == memcmp(data(), rhs.data(), m_size);
+    }
+    bool operator!=(const SmallBytes& rhs) const noexcept { return !(*this == rhs); }
+
+private:
+    // SharedBytes与SmallBytes共享同一种存储
+    friend class SharedBytes;
+
+    // 拷贝/移动另一个对象的内容
+    void copyFrom(const SmallBytes& other) noexcept;
+    void moveFrom(SmallBytes& other) noexcept;
+
+    // 获取独占的堆存储（调用后m_offset为0，并且*m_backing的长度就是m_size）
+    Bytes& ownedBacking();
+
+    Byte m_inline[c_inlineCapacity];        // 内联存储
+    std::shared_ptr<Bytes> m_backing;       // 共享存储（为空表示内联存储）
+    size_t m_offset = 0;                    // 在共享存储中的起始位置
+    size_t m_size = 0;                      // 长度
+};
+
+}   // namespace dev
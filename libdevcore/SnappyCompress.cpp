@@ -22,16 +22,59 @@
  * @date: 2021-01-24
  */
 #include "SnappyCompress.h"
+#include "AllocTracker.h"
+#include "Metrics.h"
 #include <snappy.h>
 
 namespace dev {
 
+// 压缩到SmallBytes时使用栈上缓冲区的最大输出长度
+static const size_t c_stackCompressBufferSize = 4096;
+
+// 压缩/解压的监控指标（op标签区分压缩和解压，耗时直方图的计数即调用次数）
+struct SnappyMetrics {
+    explicit SnappyMetrics(const char* op)
+    : inputBytes(MetricsRegistry::instance().counter("compression_input_bytes_total",
+        "Bytes fed into compression", {{"algo", "snappy"}, {"op", op}})),
+      outputBytes(MetricsRegistry::instance().counter("compression_output_bytes_total",
+        "Bytes produced by compression", {{"algo", "snappy"}, {"op", op}})),
+      errors(MetricsRegistry::instance().counter("compression_errors_total",
+        "Corrupted compression inputs", {{"algo", "snappy"}, {"op", op}})),
+      seconds(MetricsRegistry::instance().histogram("compression_seconds",
+        "Compression latency", Histogram::latencyBuckets(), {{"algo", "snappy"}, {"op", op}})) {}
+
+    // 记录一次成功的调用
+    void record(size_t in, size_t out) noexcept {
+        inputBytes.inc(in);
+        outputBytes.inc(out);
+    }
+
+    Counter& inputBytes;
+    Counter& outputBytes;
+    Counter& errors;
+    Histogram& seconds;
+};
+
+static SnappyMetrics& compressMetrics() {
+    static SnappyMetrics s_metrics("compress");
+    return s_metrics;
+}
+
+static SnappyMetrics& uncompressMetrics() {
+    static SnappyMetrics s_metrics("uncompress");
+    return s_metrics;
+}
+
 /**
  * 压缩数据
  * @param src 输入的字节数组
  * @return 经过压缩的数据
  */
 Bytes SnappyCompress::compress(BytesConstRef src) {
+    ALLOC_SCOPE(Compression);
+    auto& metrics = compressMetrics();
+    HistogramTimer timer(metrics.seconds);
+
     // 提前分配足够的空间
     Bytes dst(snappy::MaxCompressedLength(src.size()));
     size_t compressedLen = 0;
@@ -46,6 +89,7 @@ Bytes SnappyCompress::compress(BytesConstRef src) {
 
     // 调整为实际的压缩长度
     dst.resize(compressedLen);
+    metrics.record(src.size(), dst.size());
 
     return dst;
 }
@@ -57,6 +101,10 @@ Bytes SnappyCompress::compress(BytesConstRef src) {
  * @throw 输入的压缩数据损坏抛出CorruptedInput异常
  */
 Bytes SnappyCompress::uncompress(BytesConstRef src) {
+    ALLOC_SCOPE(Compression);
+    auto& metrics = uncompressMetrics();
+    HistogramTimer timer(metrics.seconds);
+
     // 解析出解压数据的长度（花费O(1)时间）
     size_t uncompressedLen = 0;
     bool status = snappy::GetUncompressedLength(
@@ -67,6 +115,7 @@ Bytes SnappyCompress::uncompress(BytesConstRef src) {
 
     if (!status) {
         // 解析长度编码出错
+        metrics.errors.inc();
         throw CorruptedInput();
     }
 
@@ -82,10 +131,88 @@ Bytes SnappyCompress::uncompress(BytesConstRef src) {
 
     if (!status) {
         // 压缩数据损坏
+        metrics.errors.inc();
         throw CorruptedInput();
     }
+    metrics.record(src.size(), dst.size());
 
     return dst;
 }
 
+/**
+ * 压缩数据（压缩后的长度不超过SmallBytes的内联容量时不需要分配堆内存）
+ * @param src 输入的字节数组
+ * @param dst 经过压缩的数据
+ */
+void SnappyCompress::compress(BytesConstRef src, SmallBytes& dst) {
+    ALLOC_SCOPE(Compression);
+    auto& metrics = compressMetrics();
+    HistogramTimer timer(metrics.seconds);
+
+    size_t maxCompressedLen = snappy::MaxCompressedLength(src.size());
+    size_t compressedLen = 0;
+    if (maxCompressedLen <= c_stackCompressBufferSize) {
+        // MaxCompressedLength比内联容量大得多（32 + n + n/6），先压缩到栈上的缓冲区，再按实际长度拷贝
+        char buffer[c_stackCompressBufferSize];
+        snappy::RawCompress(reinterpret_cast<const char*>(src.data()), src.size(), buffer, &compressedLen);
+        dst.assign(BytesConstRef(reinterpret_cast<const Byte*>(buffer), compressedLen));
+    } else {
+        // 输出较大时直接压缩到dst中，提前分配足够的空间，再调整为实际的压缩长度
+        dst.clear();
+        dst.resize(maxCompressedLen);
+        snappy::RawCompress(
+            reinterpret_cast<const char*>(src.data()),
+            src.size(),
+            reinterpret_cast<char*>(dst.mutableData()),
+            &compressedLen
+        );
+        dst.resize(compressedLen);
+    }
+    metrics.record(src.size(), dst.size());
+}
+
+/**
+ * 解压数据（输出较小时不需要分配堆内存）
+ * @param src 经过压缩的字节数组
+ * @param dst 经过解压的数据
+ * @throw 输入的压缩数据损坏抛出CorruptedInput异常
+ */
+void SnappyCompress::uncompress(BytesConstRef src, SmallBytes& dst) {
+    ALLOC_SCOPE(Compression);
+    auto& metrics = uncompressMetrics();
+    HistogramTimer timer(metrics.seconds);
+
+    // 解析出解压数据的长度（花费O(1)时间）
+    size_t uncompressedLen = 0;
+    bool status = snappy::GetUncompressedLength(
+        reinterpret_cast<const char*>(src.data()),
+        src.size(),
+        &uncompressedLen
+    );
+
+    if (!status) {
+        // 解析长度编码出错
+        metrics.errors.inc();
+        throw CorruptedInput();
+    }
+
+    // 提前分配空间
+    dst.clear();
+    dst.resize(uncompressedLen);
+
+    // 进行解压
+    status = snappy::RawUncompress(
+        reinterpret_cast<const char*>(src.data()),
+        src.size(),
+        reinterpret_cast<char*>(dst.mutableData())
+    );
+
+    if (!status) {
+        // 压缩数据损坏
+        metrics.errors.inc();
+        throw CorruptedInput();
+    }
+    metrics.record(src.size(), dst.size());
+}
+
 }   // namespace dev
\ No newline at end of file
@@ -25,6 +25,7 @@
 
 #include "Common.h"
 #include "Exceptions.h"
+#include "SmallBytes.h"
 
 namespace dev {
 
@@ -56,6 +57,21 @@ public:
      * @throw 输入的压缩数据损坏抛出CorruptedInput异常
      */
     static Bytes uncompress(BytesConstRef src);
+
+    /**
+     * 压缩数据（压缩后的长度不超过SmallBytes的内联容量时不需要分配堆内存）
+     * @param src 输入的字节数组
+     * @param dst 经过压缩的数据
+     */
+    static void compress(BytesConstRef src, SmallBytes& dst);
+
+    /**
+     * 解压数据（输出较小时不需要分配堆内存）
+     * @param src 经过压缩的字节数组
+     * @param dst 经过解压的数据
+     * @throw 输入的压缩数据损坏抛出CorruptedInput异常
+     */
+    static void uncompress(BytesConstRef src, SmallBytes& dst);
 };
 
 }   // namespace dev
\ No newline at end of file
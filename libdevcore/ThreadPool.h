@@ -8,12 +8,17 @@
 
 #include <vector>
 #include <queue>
+#include <atomic>
+#include <algorithm>
+#include <exception>
 #include <memory>
 #include <utility>
 #include <thread>
 #include <condition_variable>
 #include <functional>
+#include "AllocTracker.h"
 #include "Guards.h"
+#include "Metrics.h"
 
 namespace dev {
 
@@ -22,7 +27,10 @@ public:
     using SP = std::shared_ptr<ThreadPool>;
 
     // 创建线程池
-    explicit ThreadPool(unsigned threadNum) {
+    explicit ThreadPool(unsigned threadNum)
+    : m_enqueued(MetricsRegistry::instance().counter("threadpool_tasks_enqueued_total", "Tasks enqueued to thread pools")),
+      m_queueDepth(MetricsRegistry::instance().gauge("threadpool_queue_depth", "Tasks waiting in thread pool queues")),
+      m_taskSeconds(MetricsRegistry::instance().histogram("threadpool_task_seconds", "Thread pool task run time")) {
         // 创建线程
         for (unsigned i = 0; i < threadNum; ++i) {
             m_pool.emplace_back([this] {
@@ -38,7 +46,9 @@ public:
                         }
                         task = std::move(m_taskQueue.front());
                         m_taskQueue.pop();
+                        m_queueDepth.add(-1);
                     }
+                    HistogramTimer timer(m_taskSeconds);
                     task();
                 }
             });
@@ -55,18 +65,100 @@ public:
         for (auto& t : m_pool) {
             t.join();
         }
+        // 没有执行的任务直接丢弃
+        m_queueDepth.add(-static_cast<int64_t>(m_taskQueue.size()));
     }
 
     // 添加任务
     template <class F>
     void enqueue(F&& f) {
+        ALLOC_SCOPE(Pool);
         {
             Guard  guard(m_mutex);
             m_taskQueue.push(std::forward<F>(f));
+            m_queueDepth.add(1);
         }
+        m_enqueued.inc();
         m_cv.notify_one();
     }
 
+    // 线程数
+    size_t size() const noexcept { return m_pool.size(); }
+
+    /**
+     * 并行执行f(beg, end)，返回时所有任务都已执行完
+     * [0, n)被分成长度为grain的若干段，线程池和调用线程通过原子计数器领取，
+     * 调用线程会一直领取到没有剩余的段为止，所以即使在线程池的线程中调用也不会死锁
+     * @param n 任务总数
+     * @param grain 每段的长度
+     * @param f 处理一段任务的函数
+     * @throw 重新抛出f抛出的第一个异常
+     */
+    template <class F>
+    void parallelFor(size_t n, size_t grain, const F& f) {
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (n + grain - 1) / grain;
+        if (chunks <= 1 || m_pool.empty()) {
+            if (n > 0) {
+                f(0, n);
+            }
+            return;
+        }
+
+        // 共享状态（线程池中的任务可能在本函数返回后才被调度，此时已经领取不到段，不会再访问f）
+        struct State {
+            std::atomic<size_t> next{0};
+            size_t done = 0;
+            Mutex mutex;
+            std::condition_variable cv;
+            std::exception_ptr error;
+        };
+        std::shared_ptr<State> state;
+        {
+            // 调用线程稍后也会执行任务，只有共享状态计入线程池
+            ALLOC_SCOPE(Pool);
+            state = std::make_shared<State>();
+        }
+        const F* func = &f;
+        auto work = [state, func, n, grain, chunks] {
+            size_t finished = 0;
+            std::exception_ptr error;
+            for (size_t i = state->next.fetch_add(1); i < chunks; i = state->next.fetch_add(1)) {
+                try {
+                    (*func)(i * grain, std::min(n, (i + 1) * grain));
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                ++finished;
+            }
+            if (finished > 0) {
+                Guard guard(state->mutex);
+                state->done += finished;
+                if (error && !state->error) {
+                    state->error = error;
+                }
+                if (state->done == chunks) {
+                    state->cv.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(chunks - 1, m_pool.size());
+        for (size_t i = 0; i < helpers; ++i) {
+            enqueue(work);
+        }
+        work();
+
+        // 等待其它线程领取的段执行完
+        UniqueLock lock(state->mutex);
+        state->cv.wait(lock, [&state, chunks] { return state->done == chunks; });
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
 private:
     // 线程池
     std::vector<std::thread> m_pool;
@@ -80,6 +172,11 @@ private:
 
     // 运行标志
     bool m_runFlag = true;
+
+    // 监控指标（所有线程池共用）
+    Counter& m_enqueued;
+    Gauge& m_queueDepth;
+    Histogram& m_taskSeconds;
 };
 
 }   // namespace dev
\ No newline at end of file
@@ -0,0 +1,341 @@
+/**
+ * 预写日志（支持组提交）
+ * @file: WAL.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "WAL.h"
+#include "CRC32C.h"
+#include "RLP.h"
+#include <algorithm>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace dev {
+
+// 记录头长度：4字节负载长度 + 4字节CRC32C
+static const size_t c_walHeaderSize = 8;
+
+// 带errno描述的IO异常
+static StorageIOError ioError(const std::string& what) {
+    return StorageIOError(what + ": " + strerror(errno));
+}
+
+// 段文件路径（以第一条记录的序号命名）
+static std::string segmentPath(const std::string& dir, uint64_t firstSeq) {
+    char name[32];
+    snprintf(name, sizeof(name), "%020llu.wal", static_cast<unsigned long long>(firstSeq));
+    return dir + "/" + name;
+}
+
+// 段文件
+struct WAL::Segment {
+    uint64_t firstSeq = 0;                      // 第一条记录的序号
+    std::string path;                           // 文件路径
+    int fd = -1;                                // 文件描述符
+    uint64_t size = 0;                          // 有效数据的长度
+
+    ~Segment() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+// 打开日志目录（不存在时创建）
+WAL::WAL(const std::string& dir, const WALOptions& options) : m_dir(dir), m_options(options) {
+    if (mkdir(m_dir.c_str(), 0755) < 0 && EEXIST != errno) {
+        throw ioError("mkdir " + m_dir + " failed");
+    }
+
+    DIR* d = opendir(m_dir.c_str());
+    if (!d) {
+        throw ioError("opendir " + m_dir + " failed");
+    }
+    std::vector<uint64_t> seqs;
+    while (dirent* entry = readdir(d)) {
+        char* end = nullptr;
+        unsigned long long seq = strtoull(entry->d_name, &end, 10);
+        if (end != entry->d_name && 0 == strcmp(end, ".wal")) {
+            seqs.push_back(seq);
+        }
+    }
+    closedir(d);
+    std::sort(seqs.begin(), seqs.end());
+
+    for (auto seq : seqs) {
+        auto segment = std::make_shared<Segment>();
+        segment->firstSeq = seq;
+        segment->path = segmentPath(m_dir, seq);
+        segment->fd = open(segment->path.c_str(), O_RDWR | O_CLOEXEC);
+        if (segment->fd < 0) {
+            throw ioError("open " + segment->path + " failed");
+        }
+        struct stat st;
+        if (fstat(segment->fd, &st) < 0) {
+            throw ioError("fstat " + segment->path + " failed");
+        }
+        segment->size = st.st_size;
+        m_segments.push_back(segment);
+    }
+
+    if (m_segments.empty()) {
+        m_segments.push_back(createSegment(1));
+        return;
+    }
+
+    // 之前的段文件在切换前已经落盘，只需要检查最后一个段文件，截掉末尾不完整的记录
+    auto& last = m_segments.back();
+    uint64_t lastSeq = 0;
+    uint64_t valid = scan(*last, last->size, Replayer(), lastSeq);
+    if (valid != last->size) {
+        if (ftruncate(last->fd, valid) < 0) {
+            throw ioError("ftruncate " + last->path + " failed");
+        }
+        last->size = valid;
+    }
+    m_nextSeq = std::max(lastSeq + 1, last->firstSeq);
+    m_durableSeq = m_nextSeq - 1;
+}
+
+WAL::~WAL() = default;
+
+// 追加一条记录，阻塞到记录所在的组写入磁盘
+uint64_t WAL::append(BytesConstRef data) {
+    UniqueLock l(m_mutex);
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+
+    // 编码记录，放入等待提交的缓冲区
+    uint64_t seq = m_nextSeq++;
+    RLPStream s(2);
+    s << seq << data;
+    Bytes payload = s.take();
+    if (m_pending.empty()) {
+        m_pendingFirst = seq;
+    }
+    size_t pos = m_pending.size();
+    m_pending.resize(pos + c_walHeaderSize + payload.size());
+    toBigEndian(static_cast<uint32_t>(payload.size()), BytesRef(&m_pending[pos], 4));
+    toBigEndian(crc32c(payload), BytesRef(&m_pending[pos + 4], 4));
+    memcpy(&m_pending[pos + c_walHeaderSize], payload.data(), payload.size());
+
+    while (m_durableSeq < seq) {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+        if (m_committing) {
+            // 等待当前领导者完成
+            m_cv.wait(l);
+            continue;
+        }
+
+        // 成为领导者，提交缓冲区中的所有记录
+        m_committing = true;
+        if (m_options.commitDelay.count() > 0) {
+            l.unlock();
+            std::this_thread::sleep_for(m_options.commitDelay);
+            l.lock();
+        }
+        Bytes batch;
+        batch.swap(m_pending);
+        uint64_t firstSeq = m_pendingFirst;
+        uint64_t lastSeq = m_nextSeq - 1;
+        l.unlock();
+
+        try {
+            commit(batch, firstSeq);
+        } catch (...) {
+            l.lock();
+            m_error = std::current_exception();
+            m_committing = false;
+            m_cv.notify_all();
+            throw;
+        }
+
+        l.lock();
+        m_durableSeq = lastSeq;
+        m_committing = false;
+        ++m_commits;
+        m_cv.notify_all();
+    }
+    return seq;
+}
+
+// 按顺序回放序号不小于from的所有记录
+void WAL::replay(uint64_t from, const Replayer& replayer) const {
+    std::vector<std::pair<SegmentPtr, uint64_t>> segments;
+    {
+        Guard l(m_mutex);
+        for (auto& segment : m_segments) {
+            segments.emplace_back(segment, segment->size);
+        }
+    }
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        // 跳过所有记录都小于from的段文件
+        if (i + 1 < segments.size() && segments[i + 1].first->firstSeq <= from) {
+            continue;
+        }
+        auto& segment = *segments[i].first;
+        uint64_t lastSeq = 0;
+        uint64_t valid = scan(segment, segments[i].second, [&](uint64_t seq, BytesConstRef data) {
+            if (seq >= from) {
+                replayer(seq, data);
+            }
+        }, lastSeq);
+        if (valid != segments[i].second) {
+            throw StorageCorrupted("corrupted record in " + segment.path);
+        }
+    }
+}
+
+// 删除所有记录的序号都小于seq的段文件
+void WAL::truncate(uint64_t seq) {
+    Guard l(m_mutex);
+    while (m_segments.size() > 1 && m_segments[1]->firstSeq <= seq) {
+        unlink(m_segments.front()->path.c_str());
+        m_segments.erase(m_segments.begin());
+    }
+}
+
+// 最后写入磁盘的记录的序号
+uint64_t WAL::lastSequence() const {
+    Guard l(m_mutex);
+    return m_durableSeq;
+}
+
+// 段文件个数
+size_t WAL::segmentCount() const {
+    Guard l(m_mutex);
+    return m_segments.size();
+}
+
+// 组提交的次数
+uint64_t WAL::commitCount() const {
+    Guard l(m_mutex);
+    return m_commits;
+}
+
+// 创建以firstSeq命名的段文件
+WAL::SegmentPtr WAL::createSegment(uint64_t firstSeq) {
+    auto segment = std::make_shared<Segment>();
+    segment->firstSeq = firstSeq;
+    segment->path = segmentPath(m_dir, firstSeq);
+    segment->fd = open(segment->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (segment->fd < 0) {
+        throw ioError("open " + segment->path + " failed");
+    }
+
+    // 新建的文件需要目录落盘后才能在宕机后找到
+    int dirFd = open(m_dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return segment;
+}
+
+// 把一组记录写入磁盘（只有领导者调用，不持有锁）
+void WAL::commit(const Bytes& batch, uint64_t firstSeq) {
+    SegmentPtr segment;
+    {
+        Guard l(m_mutex);
+        segment = m_segments.back();
+    }
+
+    if (segment->size > 0 && segment->size + batch.size() > m_options.maxSegmentSize) {
+        // 切换段文件，旧的段文件先落盘（打开时只检查最后一个段文件）
+        if (fdatasync(segment->fd) < 0) {
+            throw ioError("fdatasync " + segment->path + " failed");
+        }
+        segment = createSegment(firstSeq);
+        Guard l(m_mutex);
+        m_segments.push_back(segment);
+    }
+
+    const Byte* p = batch.data();
+    size_t n = batch.size();
+    uint64_t offset = segment->size;
+    while (n > 0) {
+        ssize_t written = pwrite(segment->fd, p, n, offset);
+        if (written < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            throw ioError("write " + segment->path + " failed");
+        }
+        p += written;
+        n -= written;
+        offset += written;
+    }
+    if (m_options.sync && fdatasync(segment->fd) < 0) {
+        throw ioError("fdatasync " + segment->path + " failed");
+    }
+
+    Guard l(m_mutex);
+    segment->size += batch.size();
+}
+
+// 解析段文件中的记录，返回有效数据的长度
+uint64_t WAL::scan(const Segment& segment, uint64_t size, const Replayer& replayer, uint64_t& lastSeq) {
+    Bytes data(size);
+    size_t total = 0;
+    while (total < size) {
+        ssize_t n = pread(segment.fd, data.data() + total, size - total, total);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            throw ioError("read " + segment.path + " failed");
+        }
+        if (0 == n) {
+            break;
+        }
+        total += n;
+    }
+
+    uint64_t pos = 0;
+    while (total - pos >= c_walHeaderSize) {
+        uint32_t payloadSize = fromBigEndian<uint32_t>(BytesConstRef(&data[pos], 4));
+        uint32_t checksum = fromBigEndian<uint32_t>(BytesConstRef(&data[pos + 4], 4));
+        if (total - pos - c_walHeaderSize < payloadSize) {
+            break;
+        }
+        BytesConstRef payload(&data[pos + c_walHeaderSize], payloadSize);
+        if (crc32c(payload) != checksum) {
+            break;
+        }
+
+        // 校验通过但格式错误的记录不是宕机造成的，直接抛出异常
+        uint64_t seq;
+        BytesConstRef record;
+        try {
+            RLP rlp(payload);
+            auto it = rlp.begin();
+            seq = it->toInt<uint64_t>();
+            if (++it == rlp.end()) {
+                throw BadRLP();
+            }
+            record = it->payload();
+        } catch (const RLPExcept&) {
+            throw StorageCorrupted("bad record in " + segment.path);
+        }
+        if (replayer) {
+            replayer(seq, record);
+        }
+        lastSeq = seq;
+        pos += c_walHeaderSize + payloadSize;
+    }
+    return pos;
+}
+
+}   // namespace dev
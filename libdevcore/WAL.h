@@ -0,0 +1,115 @@
+/**
+ * 预写日志（支持组提交）
+ * @file: WAL.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Common.h"
+#include "Guards.h"
+
+namespace dev {
+
+// 预写日志选项
+struct WALOptions {
+    uint64_t maxSegmentSize = 64 << 20;         // 单个段文件的最大长度，超过后切换到新的段文件
+    bool sync = true;                           // 每组提交后是否调用fdatasync
+    std::chrono::microseconds commitDelay{0};   // 组提交的领导者写盘前等待更多追加者的时间
+};
+
+/**
+ * 状态和区块在写入存储之前先写预写日志，每条记录都fsync时提交吞吐受限于磁盘的IOPS。
+ * 组提交：并发的追加者把记录放入同一个缓冲区，第一个发现没有正在进行的提交的线程成为领导者，
+ * 一次write + fdatasync把缓冲区中所有记录写入磁盘，再唤醒这一组的所有追加者，
+ * 领导者写盘期间到达的记录组成下一组，因此每组只需要一次fsync。
+ * 记录格式：[4字节负载长度][4字节负载的CRC32C][负载 = RLP([序号, 数据])]
+ * 段文件以其第一条记录的序号命名，打开时截掉最后一个段文件末尾不完整的记录，
+ * 检查点之后可以用truncate删除所有记录都已不再需要的段文件。
+ */
+class WAL {
+public:
+    // 回放回调
+    using Replayer = std::function<void(uint64_t seq, BytesConstRef data)>;
+
+    /**
+     * 打开日志目录（不存在时创建）
+     * @param dir 日志目录
+     * @param options 日志选项
+     * @throw 无法读写文件抛出StorageIOError异常
+     */
+    explicit WAL(const std::string& dir, const WALOptions& options = WALOptions());
+
+    ~WAL();
+
+    WAL(const WAL&) = delete;
+    WAL& operator=(const WAL&) = delete;
+
+    /**
+     * 追加一条记录，阻塞到记录所在的组写入磁盘
+     * @param data 记录数据
+     * @return 记录的序号（从1开始递增）
+     * @throw 写盘失败抛出StorageIOError异常（之后所有追加都会失败）
+     */
+    uint64_t append(BytesConstRef data);
+
+    /**
+     * 按顺序回放序号不小于from的所有记录
+     * @throw 中间的段文件损坏抛出StorageCorrupted异常
+     */
+    void replay(uint64_t from, const Replayer& replayer) const;
+
+    // 删除所有记录的序号都小于seq的段文件（当前写入的段文件不会被删除）
+    void truncate(uint64_t seq);
+
+    // 最后写入磁盘的记录的序号（0表示没有记录）
+    uint64_t lastSequence() const;
+
+    // 段文件个数
+    size_t segmentCount() const;
+
+    // 组提交的次数
+    uint64_t commitCount() const;
+
+private:
+    struct Segment;
+    using SegmentPtr = std::shared_ptr<Segment>;
+
+    // 创建以firstSeq命名的段文件
+    SegmentPtr createSegment(uint64_t firstSeq);
+
+    // 把一组记录写入磁盘（只有领导者调用）
+    void commit(const Bytes& batch, uint64_t firstSeq);
+
+    /**
+     * 解析段文件中的记录
+     * @param segment 段文件
+     * @param size 要解析的长度
+     * @param replayer 每条有效记录的回调（可以为空）
+     * @param lastSeq 最后一条有效记录的序号
+     * @return 有效数据的长度（遇到不完整或校验失败的记录时停止）
+     */
+    static uint64_t scan(const Segment& segment, uint64_t size, const Replayer& replayer, uint64_t& lastSeq);
+
+    std::string m_dir;                          // 日志目录
+    WALOptions m_options;
+    mutable Mutex m_mutex;
+    std::condition_variable m_cv;               // 组提交完成的通知
+    std::vector<SegmentPtr> m_segments;         // 段文件（按序号递增，最后一个是当前写入的段文件）
+    Bytes m_pending;                            // 等待提交的记录
+    uint64_t m_pendingFirst = 0;                // 等待提交的第一条记录的序号
+    uint64_t m_nextSeq = 1;                     // 下一条记录的序号
+    uint64_t m_durableSeq = 0;                  // 已经写入磁盘的最后一条记录的序号
+    bool m_committing = false;                  // 是否有领导者正在写盘
+    uint64_t m_commits = 0;                     // 组提交的次数
+    std::exception_ptr m_error;                 // 写盘失败的异常
+};
+
+}   // namespace dev
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <cstddef>
 #include <cstring>
@@ -102,6 +103,11 @@ public:
         return std::string(reinterpret_cast<const char*>(m_data), sizeof(T) * m_size);
     }
 
+    // 转换为字符串视图（不复制）
+    std::string_view toStringView() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(m_data), sizeof(T) * m_size);
+    }
+
 private:
     // 保存原始指针和长度信息（需保证引用对象的生命周期）
     pointer m_data = nullptr;
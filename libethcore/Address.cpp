@@ -11,17 +11,93 @@
 #include "Address.h"
 #include <libcrypto/Keccak.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/Exceptions.h>
+#include <cstring>
 
 namespace dev { namespace eth {
 
+// 批量计算时每个并行任务处理的个数
+static const size_t c_batchGrain = 1024;
+
+// 在当前线程或线程池中对[0, count)执行f(beg, end)
+template <typename F>
+static void forRange(size_t count, ThreadPool* pool, const F& f) {
+    if (pool && count > c_batchGrain) {
+        pool->parallelFor(count, c_batchGrain, f);
+    } else {
+        f(0, count);
+    }
+}
+
+/**
+ * 把rlp([sender, nonce])编码到buf中（列表载荷最长21 + 33字节，前缀1字节）
+ * @return 编码长度
+ */
+static size_t encodeCreation(const Address& sender, const U256& nonce, Byte buf[56]) noexcept {
+    Byte* p = buf + 1;
+    *p++ = static_cast<Byte>(c_rlpDataImmLenStart + 20);
+    memcpy(p, sender.data(), 20);
+    p += 20;
+    if (!nonce) {
+        *p++ = static_cast<Byte>(c_rlpDataImmLenStart);
+    } else if (nonce < c_rlpDataImmLenStart) {
+        *p++ = static_cast<Byte>(nonce);
+    } else {
+        unsigned br = bytesRequired(nonce);
+        *p++ = static_cast<Byte>(c_rlpDataImmLenStart + br);
+        toBigEndian(nonce, BytesRef(p, br));
+        p += br;
+    }
+    size_t size = p - buf;
+    buf[0] = static_cast<Byte>(c_rlpListStart + size - 1);
+    return size;
+}
+
 // 计算外部账户地址
 Address toAddress(const PubKey& pub) noexcept {
     return right160(keccak256(pub));
 }
 
-// 计算合约账户地址
-Address toAddress(const Address& sender, const U256& nonce) {
-    return right160(keccak256(rlpList(sender, nonce)));
+// 计算合约账户地址（RLP编码最长55字节，直接编码到栈上的缓冲区，不分配内存）
+Address toAddress(const Address& sender, const U256& nonce) noexcept {
+    Byte buf[56];
+    size_t size = encodeCreation(sender, nonce, buf);
+    return right160(keccak256(BytesConstRef(buf, size)));
+}
+
+// 批量计算外部账户地址
+void toAddresses(const PubKey* pubs, size_t count, Address* out, ThreadPool* pool) {
+    forRange(count, pool, [pubs, out](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            out[i] = right160(keccak256(pubs[i]));
+        }
+    });
+}
+
+Addresses toAddresses(const std::vector<PubKey>& pubs, ThreadPool* pool) {
+    Addresses ret(pubs.size());
+    toAddresses(pubs.data(), pubs.size(), ret.data(), pool);
+    return ret;
+}
+
+// 批量计算合约账户地址
+void toAddresses(const Address* senders, const U256* nonces, size_t count, Address* out, ThreadPool* pool) {
+    forRange(count, pool, [senders, nonces, out](size_t beg, size_t end) {
+        Byte buf[56];
+        for (size_t i = beg; i < end; ++i) {
+            size_t size = encodeCreation(senders[i], nonces[i], buf);
+            out[i] = right160(keccak256(BytesConstRef(buf, size)));
+        }
+    });
+}
+
+Addresses toAddresses(const Addresses& senders, const std::vector<U256>& nonces, ThreadPool* pool) {
+    if (senders.size() != nonces.size()) {
+        throw OutOfRange("senders and nonces size mismatch");
+    }
+    Addresses ret(senders.size());
+    toAddresses(senders.data(), nonces.data(), senders.size(), ret.data(), pool);
+    return ret;
 }
 
 }}   // namespace dev::eth
\ No newline at end of file
@@ -10,8 +10,10 @@
  */
 #pragma once
 
+#include <vector>
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedBytes.h>
+#include <libdevcore/ThreadPool.h>
 #include <libcrypto/ECDSA.h>
 
 namespace dev { namespace eth {
@@ -32,7 +34,33 @@ using Addresses = H160s;
 // 计算外部账户地址
 Address toAddress(const PubKey& pub) noexcept;
 
-// 计算合约账户地址
-Address toAddress(const Address& sender, const U256& nonce);
+// 计算合约账户地址（RLP编码最长55字节，直接编码到栈上的缓冲区，不分配内存）
+Address toAddress(const Address& sender, const U256& nonce) noexcept;
+
+/**
+ * 批量计算外部账户地址（创世块导入，钱包扫描等场景需要计算大量地址）
+ * @param pubs 公钥数组
+ * @param count 公钥个数
+ * @param out 输出的地址数组（长度不小于count）
+ * @param pool 用于并行计算的线程池，为空时在当前线程计算
+ */
+void toAddresses(const PubKey* pubs, size_t count, Address* out, ThreadPool* pool = nullptr);
+Addresses toAddresses(const std::vector<PubKey>& pubs, ThreadPool* pool = nullptr);
+
+/**
+ * 批量计算合约账户地址
+ * @param senders 创建者地址数组
+ * @param nonces 创建者nonce数组
+ * @param count 个数
+ * @param out 输出的地址数组（长度不小于count）
+ * @param pool 用于并行计算的线程池，为空时在当前线程计算
+ */
+void toAddresses(const Address* senders, const U256* nonces, size_t count, Address* out, ThreadPool* pool = nullptr);
+
+/**
+ * 批量计算合约账户地址
+ * @throw 若senders与nonces长度不同抛出OutOfRange异常
+ */
+Addresses toAddresses(const Addresses& senders, const std::vector<U256>& nonces, ThreadPool* pool = nullptr);
 
 }}   // namespace dev::eth
\ No newline at end of file
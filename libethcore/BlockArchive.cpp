@@ -0,0 +1,348 @@
+/**
+ * 历史区块归档（内存映射的只追加文件）
+ * @file: BlockArchive.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "BlockArchive.h"
+#include <libdevcore/CRC32C.h>
+#include <libdevcore/SnappyCompress.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace dev { namespace eth {
+
+// 记录头长度：4字节负载长度 + 4字节CRC32C（覆盖标志和负载） + 1字节标志
+static const size_t c_recordHeaderSize = 9;
+
+// 记录标志：区块经过压缩
+static const Byte c_recordCompressed = 0x01;
+
+// 索引项中偏移占用的位数（单个数据文件最大1TB）
+static const unsigned c_offsetBits = 40;
+static const uint64_t c_offsetMask = (uint64_t(1) << c_offsetBits) - 1;
+
+// 带errno描述的IO异常
+static StorageIOError ioError(const std::string& what) {
+    return StorageIOError(what + ": " + strerror(errno));
+}
+
+// 完整写入
+static void pwriteAll(int fd, const Byte* data, size_t size, uint64_t offset, const std::string& path) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            throw ioError("write " + path + " failed");
+        }
+        data += n;
+        size -= n;
+        offset += n;
+    }
+}
+
+// 数据文件
+struct BlockArchive::Segment {
+    uint64_t id = 0;                        // 编号
+    std::string path;                       // 文件路径
+    int fd = -1;                            // 文件描述符
+    uint64_t size = 0;                      // 已写入的长度
+    const Byte* map = nullptr;              // 映射的起始地址
+    uint64_t mapSize = 0;                   // 映射的长度（不小于文件长度）
+
+    ~Segment() {
+        if (map) {
+            munmap(const_cast<Byte*>(map), mapSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+// 打开归档目录（不存在时创建）
+BlockArchive::BlockArchive(const std::string& dir, const BlockArchiveOptions& options)
+: m_dir(dir), m_options(options) {
+    if (mkdir(m_dir.c_str(), 0755) < 0 && EEXIST != errno) {
+        throw ioError("mkdir " + m_dir + " failed");
+    }
+
+    // 数据文件编号必须从1开始连续
+    DIR* d = opendir(m_dir.c_str());
+    if (!d) {
+        throw ioError("opendir " + m_dir + " failed");
+    }
+    std::vector<uint64_t> ids;
+    while (dirent* entry = readdir(d)) {
+        char* end = nullptr;
+        unsigned long long id = strtoull(entry->d_name, &end, 10);
+        if (end != entry->d_name && 0 == strcmp(end, ".dat")) {
+            ids.push_back(id);
+        }
+    }
+    closedir(d);
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (ids[i] != i + 1) {
+            throw StorageCorrupted("missing data file in " + m_dir);
+        }
+        m_segments.push_back(openSegment(ids[i], false, 0));
+    }
+
+    // 读取索引
+    std::string indexPath = m_dir + "/index";
+    m_indexFd = open(indexPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_indexFd < 0) {
+        throw ioError("open " + indexPath + " failed");
+    }
+    struct stat st;
+    if (fstat(m_indexFd, &st) < 0) {
+        throw ioError("fstat " + indexPath + " failed");
+    }
+    Bytes raw(st.st_size / 8 * 8);
+    size_t total = 0;
+    while (total < raw.size()) {
+        ssize_t n = pread(m_indexFd, raw.data() + total, raw.size() - total, total);
+        if (n <= 0) {
+            if (n < 0 && EINTR == errno) {
+                continue;
+            }
+            break;
+        }
+        total += n;
+    }
+    m_index.resize(total / 8);
+    for (size_t i = 0; i < m_index.size(); ++i) {
+        m_index[i] = fromBigEndian<uint64_t>(BytesConstRef(raw.data() + i * 8, 8));
+    }
+
+    /**
+     * 丢弃第一个无效的索引项及其之后的所有项：
+     * 切换数据文件时旧的数据文件已经落盘，指向它们的索引项只要写入了（不是全0）就指向完整的记录；
+     * sync为false时最后一个数据文件的记录和索引项之间没有写入顺序，宕机后可能只有后面的记录落盘，
+     * 因此指向最后一个数据文件的索引项逐个校验（最多扫描一个数据文件）
+     */
+    size_t valid = 0;
+    for (; valid < m_index.size(); ++valid) {
+        uint64_t id = m_index[valid] >> c_offsetBits;
+        if (id < 1 || id > m_segments.size() || (valid > 0 && m_index[valid] <= m_index[valid - 1])) {
+            break;
+        }
+        if (id == m_segments.size() && 0 == checkRecord(*m_segments[id - 1], m_index[valid] & c_offsetMask)) {
+            break;
+        }
+    }
+    m_index.resize(valid);
+
+    // 校验最后一项并得到数据的末尾（宕机时数据或索引没有完整写入）
+    uint64_t end = 0;
+    while (!m_index.empty()) {
+        uint64_t id = m_index.back() >> c_offsetBits;
+        uint64_t offset = m_index.back() & c_offsetMask;
+        if (id >= 1 && id <= m_segments.size()) {
+            uint64_t size = checkRecord(*m_segments[id - 1], offset);
+            if (size > 0) {
+                end = offset + size;
+                break;
+            }
+        }
+        m_index.pop_back();
+    }
+    if (ftruncate(m_indexFd, m_index.size() * 8) < 0) {
+        throw ioError("ftruncate " + indexPath + " failed");
+    }
+
+    // 截掉最后一个区块之后的数据
+    size_t keep = m_index.empty() ? 0 : (m_index.back() >> c_offsetBits);
+    while (m_segments.size() > std::max<size_t>(keep, 1)) {
+        unlink(m_segments.back()->path.c_str());
+        m_segments.pop_back();
+    }
+    if (m_segments.empty()) {
+        m_segments.push_back(openSegment(1, true, 0));
+    } else if (m_segments.back()->size != end) {
+        auto& segment = m_segments.back();
+        if (ftruncate(segment->fd, end) < 0) {
+            throw ioError("ftruncate " + segment->path + " failed");
+        }
+        segment->size = end;
+    }
+}
+
+BlockArchive::~BlockArchive() {
+    if (m_indexFd >= 0) {
+        close(m_indexFd);
+    }
+}
+
+// 追加下一个区块
+uint64_t BlockArchive::append(BytesConstRef rlp, bool sync) {
+    // 组装记录（压缩在锁外进行）
+    Bytes record;
+    Byte flags = 0;
+    if (m_options.compress) {
+        Bytes compressed = SnappyCompress::compress(rlp);
+        if (compressed.size() < rlp.size()) {
+            flags |= c_recordCompressed;
+            record.reserve(c_recordHeaderSize + compressed.size());
+            record.resize(c_recordHeaderSize);
+            record.insert(record.end(), compressed.begin(), compressed.end());
+        }
+    }
+    if (!(flags & c_recordCompressed)) {
+        record.reserve(c_recordHeaderSize + rlp.size());
+        record.resize(c_recordHeaderSize);
+        record.insert(record.end(), rlp.begin(), rlp.end());
+    }
+    size_t payloadSize = record.size() - c_recordHeaderSize;
+    if (payloadSize > std::numeric_limits<uint32_t>::max()) {
+        throw OutOfRange("block too large");
+    }
+    toBigEndian(static_cast<uint32_t>(payloadSize), BytesRef(record.data(), 4));
+    record[8] = flags;
+    toBigEndian(crc32c(BytesConstRef(record.data() + 8, 1 + payloadSize)), BytesRef(record.data() + 4, 4));
+
+    Guard appendGuard(m_appendMutex);
+    SegmentPtr segment = m_segments.back();
+    if (segment->size + record.size() > segment->mapSize) {
+        // 当前数据文件已满（映射的地址空间用完），切换到新的数据文件
+        if (fdatasync(segment->fd) < 0) {
+            throw ioError("fdatasync " + segment->path + " failed");
+        }
+        segment = openSegment(segment->id + 1, true, record.size());
+        Guard l(m_mutex);
+        m_segments.push_back(segment);
+    }
+
+    // 先写数据再写索引
+    uint64_t offset = segment->size;
+    pwriteAll(segment->fd, record.data(), record.size(), offset, segment->path);
+    if (sync && fdatasync(segment->fd) < 0) {
+        throw ioError("fdatasync " + segment->path + " failed");
+    }
+    segment->size += record.size();
+
+    uint64_t entry = (segment->id << c_offsetBits) | offset;
+    Byte raw[8];
+    toBigEndian(entry, BytesRef(raw, 8));
+    uint64_t number = size();
+    pwriteAll(m_indexFd, raw, 8, number * 8, m_dir + "/index");
+    if (sync && fdatasync(m_indexFd) < 0) {
+        throw ioError("fdatasync " + m_dir + "/index failed");
+    }
+
+    Guard l(m_mutex);
+    m_index.push_back(entry);
+    return number;
+}
+
+// 读取区块
+bool BlockArchive::get(uint64_t number, ArchivedBlock& block) const {
+    uint64_t entry;
+    SegmentPtr segment;
+    {
+        Guard l(m_mutex);
+        if (number >= m_index.size()) {
+            return false;
+        }
+        entry = m_index[number];
+        segment = m_segments[(entry >> c_offsetBits) - 1];
+    }
+
+    // 直接访问映射内存（索引项只会指向完整写入的记录）
+    const Byte* p = segment->map + (entry & c_offsetMask);
+    uint32_t payloadSize = fromBigEndian<uint32_t>(BytesConstRef(p, 4));
+    uint32_t checksum = fromBigEndian<uint32_t>(BytesConstRef(p + 4, 4));
+    Byte flags = p[8];
+    BytesConstRef payload(p + c_recordHeaderSize, payloadSize);
+    if (checksum != crc32c(BytesConstRef(p + 8, 1 + payloadSize))) {
+        throw StorageCorrupted("bad checksum of block " + std::to_string(number));
+    }
+
+    if (flags & c_recordCompressed) {
+        block.m_uncompressed = std::make_shared<Bytes>(SnappyCompress::uncompress(payload));
+        block.m_mapping.reset();
+        block.m_data = *block.m_uncompressed;
+    } else {
+        block.m_uncompressed.reset();
+        block.m_mapping = segment;
+        block.m_data = payload;
+    }
+    return true;
+}
+
+// 区块个数
+uint64_t BlockArchive::size() const {
+    Guard l(m_mutex);
+    return m_index.size();
+}
+
+// 所有数据落盘
+void BlockArchive::sync() {
+    Guard appendGuard(m_appendMutex);
+    if (fdatasync(m_segments.back()->fd) < 0) {
+        throw ioError("fdatasync " + m_segments.back()->path + " failed");
+    }
+    if (fdatasync(m_indexFd) < 0) {
+        throw ioError("fdatasync " + m_dir + "/index failed");
+    }
+}
+
+// 打开（或创建）数据文件并映射
+BlockArchive::SegmentPtr BlockArchive::openSegment(uint64_t id, bool create, uint64_t minMapSize) {
+    auto segment = std::make_shared<Segment>();
+    segment->id = id;
+    char name[32];
+    snprintf(name, sizeof(name), "%06llu.dat", static_cast<unsigned long long>(id));
+    segment->path = m_dir + "/" + name;
+
+    int flags = O_RDWR | O_CLOEXEC | (create ? O_CREAT | O_TRUNC : 0);
+    segment->fd = open(segment->path.c_str(), flags, 0644);
+    if (segment->fd < 0) {
+        throw ioError("open " + segment->path + " failed");
+    }
+    struct stat st;
+    if (fstat(segment->fd, &st) < 0) {
+        throw ioError("fstat " + segment->path + " failed");
+    }
+    segment->size = st.st_size;
+
+    // 映射超出文件长度的部分只占用地址空间，追加的数据通过页缓存直接可见
+    segment->mapSize = std::max<uint64_t>(std::max<uint64_t>(m_options.maxSegmentSize, minMapSize), segment->size);
+    void* map = mmap(nullptr, segment->mapSize, PROT_READ, MAP_SHARED, segment->fd, 0);
+    if (MAP_FAILED == map) {
+        throw ioError("mmap " + segment->path + " failed");
+    }
+    segment->map = static_cast<const Byte*>(map);
+    return segment;
+}
+
+// 检查记录是否完整并且校验通过，返回记录的总长度，无效时返回0
+uint64_t BlockArchive::checkRecord(const Segment& segment, uint64_t offset) {
+    if (offset > segment.size || segment.size - offset < c_recordHeaderSize) {
+        return 0;
+    }
+    const Byte* p = segment.map + offset;
+    uint32_t payloadSize = fromBigEndian<uint32_t>(BytesConstRef(p, 4));
+    if (segment.size - offset - c_recordHeaderSize < payloadSize) {
+        return 0;
+    }
+    uint32_t checksum = fromBigEndian<uint32_t>(BytesConstRef(p + 4, 4));
+    if (checksum != crc32c(BytesConstRef(p + 8, 1 + payloadSize))) {
+        return 0;
+    }
+    return c_recordHeaderSize + payloadSize;
+}
+
+}}   // namespace dev::eth
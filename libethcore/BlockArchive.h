@@ -0,0 +1,118 @@
+/**
+ * 历史区块归档（内存映射的只追加文件）
+ * @file: BlockArchive.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/RLP.h>
+
+namespace dev { namespace eth {
+
+/**
+ * 历史区块写入后不再修改，同步中的节点按区块号顺序大量读取，用通用的键值存储既浪费空间又需要拷贝：
+ * 1. 数据文件（000001.dat, ...）只追加，每条记录为[4字节长度][4字节CRC32C][1字节标志][区块RLP]，
+ *    区块RLP可以选择用snappy压缩；单个数据文件超过maxSegmentSize后切换到新的数据文件
+ * 2. 索引文件（index）是定长的数组，第n项（8字节）记录区块n所在的数据文件编号和偏移，
+ *    按区块号查找只需要一次数组访问
+ * 3. 数据文件用mmap映射（预留maxSegmentSize的地址空间，追加数据不需要重新映射），
+ *    未压缩的区块直接返回指向映射内存的RLP视图，读取没有系统调用也没有拷贝
+ * 4. 先写数据再写索引，切换数据文件时旧的数据文件先落盘。sync为false时最后一个数据文件的数据和索引的
+ *    落盘顺序没有保证，打开时校验指向最后一个数据文件的所有索引项，从第一个无效的项开始丢弃，
+ *    并截掉数据文件末尾多余的数据，因此宕机后恢复出的是一个没有空洞的区块前缀（可能丢失最近未sync的区块）
+ */
+
+// 归档选项
+struct BlockArchiveOptions {
+    bool compress = false;                  // 是否用snappy压缩区块
+    uint64_t maxSegmentSize = 256 << 20;    // 单个数据文件的最大长度
+};
+
+// 从归档中读出的区块（持有映射内存或解压后的数据，RLP视图在对象存活期间有效）
+class ArchivedBlock {
+public:
+    ArchivedBlock() = default;
+
+    // 区块RLP编码
+    BytesConstRef data() const noexcept { return m_data; }
+    RLP rlp() const { return RLP(m_data); }
+
+    // 是否直接指向映射内存（没有拷贝）
+    bool mapped() const noexcept { return !m_uncompressed; }
+
+private:
+    friend class BlockArchive;
+
+    std::shared_ptr<const void> m_mapping;  // 数据文件的映射
+    std::shared_ptr<Bytes> m_uncompressed;  // 解压后的数据
+    BytesConstRef m_data;
+};
+
+// 历史区块归档（一个线程追加，多个线程并发读取）
+class BlockArchive {
+public:
+    /**
+     * 打开归档目录（不存在时创建）
+     * @param dir 归档目录
+     * @param options 归档选项
+     * @throw 无法读写文件抛出StorageIOError异常
+     */
+    explicit BlockArchive(const std::string& dir, const BlockArchiveOptions& options = BlockArchiveOptions());
+
+    ~BlockArchive();
+
+    BlockArchive(const BlockArchive&) = delete;
+    BlockArchive& operator=(const BlockArchive&) = delete;
+
+    /**
+     * 追加下一个区块
+     * @param rlp 区块RLP编码
+     * @param sync 是否等待数据落盘后再返回
+     * @return 区块号（从0开始连续编号）
+     */
+    uint64_t append(BytesConstRef rlp, bool sync = false);
+
+    /**
+     * 读取区块
+     * @param number 区块号
+     * @param block 读出的区块
+     * @return 区块不存在返回false
+     * @throw 校验失败抛出StorageCorrupted异常
+     */
+    bool get(uint64_t number, ArchivedBlock& block) const;
+
+    // 区块个数
+    uint64_t size() const;
+
+    // 所有数据落盘
+    void sync();
+
+private:
+    struct Segment;
+    using SegmentPtr = std::shared_ptr<Segment>;
+
+    // 打开（或创建）数据文件并映射
+    SegmentPtr openSegment(uint64_t id, bool create, uint64_t minMapSize);
+
+    /**
+     * 检查记录是否完整并且校验通过
+     * @return 记录的总长度，无效时返回0
+     */
+    static uint64_t checkRecord(const Segment& segment, uint64_t offset);
+
+    std::string m_dir;                      // 归档目录
+    BlockArchiveOptions m_options;
+    int m_indexFd = -1;                     // 索引文件
+    Mutex m_appendMutex;                    // 串行化追加
+    mutable Mutex m_mutex;                  // 保护m_index和m_segments
+    std::vector<uint64_t> m_index;          // 索引（数据文件编号 << 40 | 偏移）
+    std::vector<SegmentPtr> m_segments;     // 数据文件（下标为编号 - 1）
+};
+
+}}   // namespace dev::eth
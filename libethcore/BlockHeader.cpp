@@ -0,0 +1,155 @@
+/**
+ * 区块头
+ * @file: BlockHeader.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "BlockHeader.h"
+#include <cstring>
+#include <libdevcore/RLP.h>
+#include <libcrypto/Keccak.h>
+#include "Exceptions.h"
+
+namespace dev { namespace eth {
+
+// 签名编码长度（r:[0, 32)，s:[32, 64)，v:64）
+static const size_t c_signatureSize = 65;
+
+// 取出列表的下一个数据项，若已经到末尾抛出BadBlockHeader异常
+static RLP nextItem(RLP::iterator& it, const RLP::iterator& end) {
+    if (it == end) {
+        throw BadBlockHeader("too few block header fields");
+    }
+    RLP ret = *it;
+    ++it;
+    return ret;
+}
+
+// 取出列表的下一个定长字段，长度不对时抛出BadBlockHeader异常（toFixedBytes抛出的Unaligned不是RLPExcept）
+template <size_t N>
+static FixedBytes<N> nextFixedBytes(RLP::iterator& it, const RLP::iterator& end) {
+    RLP item = nextItem(it, end);
+    if (!item.isData() || N != item.payload().size()) {
+        throw BadBlockHeader("bad block header field length");
+    }
+    return FixedBytes<N>(item.payload());
+}
+
+/**
+ * 一次遍历解码区块头，并保留原始编码（不拷贝）
+ * @param rlp 区块头的RLP编码
+ * @throw 若编码不合法抛出BadBlockHeader异常
+ */
+BlockHeader::BlockHeader(SharedBytes rlp) {
+    try {
+        RLP root(rlp);
+        auto it = root.begin();
+        auto end = root.end();
+        RLP fields = nextItem(it, end);
+        RLP sigs = nextItem(it, end);
+        if (it != end) {
+            throw BadBlockHeader("too many block header items");
+        }
+
+        auto fit = fields.begin();
+        auto fend = fields.end();
+        m_parentHash = nextFixedBytes<32>(fit, fend);
+        m_stateRoot = nextFixedBytes<32>(fit, fend);
+        m_transactionsRoot = nextFixedBytes<32>(fit, fend);
+        m_receiptsRoot = nextFixedBytes<32>(fit, fend);
+        m_logBloom = nextFixedBytes<256>(fit, fend);
+        m_number = nextItem(fit, fend).toInt<uint64_t>();
+        m_gasLimit = nextItem(fit, fend).toInt<U256>();
+        m_gasUsed = nextItem(fit, fend).toInt<U256>();
+        m_timestamp = nextItem(fit, fend).toInt<uint64_t>();
+        m_extraData = nextItem(fit, fend).toBytes();
+        if (fit != fend) {
+            throw BadBlockHeader("too many block header fields");
+        }
+
+        for (const auto& item : sigs) {
+            BytesConstRef p = item.isData() ? item.payload() : BytesConstRef();
+            if (c_signatureSize != p.size()) {
+                throw BadBlockHeader("bad block signature");
+            }
+            m_signatures.emplace_back(H256(p.cropped(0, 32)), H256(p.cropped(32, 32)), p[64]);
+        }
+
+        m_unsignedRlp = rlp.slice(fields.actualData());
+    } catch (const RLPExcept& e) {
+        throw BadBlockHeader(e.what());
+    }
+    m_rlp = std::move(rlp);
+}
+
+// 区块哈希（第一次访问时计算，线程安全）
+const H256& BlockHeader::hash() const {
+    if (!m_hashValid.load(std::memory_order_acquire)) {
+        Guard guard(m_hashMutex);
+        if (!m_hashValid.load(std::memory_order_relaxed)) {
+            // 解码得到的区块头直接对原始编码计算哈希，不需要重新编码
+            m_hash = m_unsignedRlp.empty() ? keccak256(encodeUnsigned()) : keccak256(m_unsignedRlp);
+            m_hashValid.store(true, std::memory_order_release);
+        }
+    }
+    return m_hash;
+}
+
+// 完整的RLP编码（解码得到的区块头直接返回原始编码）
+SharedBytes BlockHeader::rlp() const {
+    if (!m_rlp.empty()) {
+        return m_rlp;
+    }
+
+    Bytes encoded;
+    BytesConstRef fields = m_unsignedRlp;
+    if (fields.empty()) {
+        encoded = encodeUnsigned();
+        fields = encoded;
+    }
+
+    // 事先计算出编码长度，一次分配好内存
+    size_t sigsSize = rlpListSizeOfPayload(m_signatures.size() * (rlpHeaderSize(c_signatureSize) + c_signatureSize));
+    RLPStream s;
+    s.reserve(rlpListSizeOfPayload(fields.size() + sigsSize));
+    s.appendList(2);
+    s.append(RLP(fields));
+    s.appendList(m_signatures.size());
+    for (const auto& sig : m_signatures) {
+        Byte buf[c_signatureSize];
+        memcpy(buf, sig.r.data(), 32);
+        memcpy(buf + 32, sig.s.data(), 32);
+        buf[64] = sig.v;
+        s.append(BytesConstRef(buf, sizeof(buf)));
+    }
+    return SharedBytes(s.take());
+}
+
+// 编码不含签名的部分
+Bytes BlockHeader::encodeUnsigned() const {
+    return rlpList(m_parentHash, m_stateRoot, m_transactionsRoot, m_receiptsRoot, m_logBloom,
+                   m_number, m_gasLimit, m_gasUsed, m_timestamp, m_extraData);
+}
+
+// 拷贝另一个区块头（包括缓存）
+void BlockHeader::copyFrom(const BlockHeader& other) {
+    m_parentHash = other.m_parentHash;
+    m_stateRoot = other.m_stateRoot;
+    m_transactionsRoot = other.m_transactionsRoot;
+    m_receiptsRoot = other.m_receiptsRoot;
+    m_logBloom = other.m_logBloom;
+    m_number = other.m_number;
+    m_gasLimit = other.m_gasLimit;
+    m_gasUsed = other.m_gasUsed;
+    m_timestamp = other.m_timestamp;
+    m_extraData = other.m_extraData;
+    m_signatures = other.m_signatures;
+    m_rlp = other.m_rlp;
+    m_unsignedRlp = other.m_unsignedRlp;
+
+    Guard guard(other.m_hashMutex);
+    m_hash = other.m_hash;
+    m_hashValid.store(other.m_hashValid.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+}}   // namespace dev::eth
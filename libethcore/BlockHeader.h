@@ -0,0 +1,117 @@
+/**
+ * 区块头
+ * @file: BlockHeader.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/SharedBytes.h>
+#include <libcrypto/ECDSA.h>
+
+namespace dev { namespace eth {
+
+/**
+ * 区块头的RLP编码为[[parentHash, stateRoot, transactionsRoot, receiptsRoot, logBloom,
+ * number, gasLimit, gasUsed, timestamp, extraData], [signature...]]，
+ * 区块哈希为第一个子列表（不含签名）的keccak256，共识节点对区块哈希签名，签名追加到第二个子列表中。
+ * 同步区块头时要校验大量区块头的哈希，这里解码时保留原始编码，计算哈希时直接对原始编码中的子列表做一次keccak256，
+ * 不需要重新编码，并且哈希在第一次计算后缓存下来
+ */
+class BlockHeader {
+public:
+    // 构造空区块头（用于打包新区块）
+    BlockHeader() = default;
+
+    /**
+     * 一次遍历解码区块头，并保留原始编码（不拷贝）
+     * @param rlp 区块头的RLP编码
+     * @throw 若编码不合法抛出BadBlockHeader异常
+     */
+    explicit BlockHeader(SharedBytes rlp);
+
+    BlockHeader(const BlockHeader& other) { copyFrom(other); }
+    BlockHeader& operator=(const BlockHeader& other) {
+        if (this != &other) {
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    // 获取字段
+    const H256& parentHash() const noexcept { return m_parentHash; }
+    const H256& stateRoot() const noexcept { return m_stateRoot; }
+    const H256& transactionsRoot() const noexcept { return m_transactionsRoot; }
+    const H256& receiptsRoot() const noexcept { return m_receiptsRoot; }
+    const H2048& logBloom() const noexcept { return m_logBloom; }
+    uint64_t number() const noexcept { return m_number; }
+    const U256& gasLimit() const noexcept { return m_gasLimit; }
+    const U256& gasUsed() const noexcept { return m_gasUsed; }
+    uint64_t timestamp() const noexcept { return m_timestamp; }
+    const Bytes& extraData() const noexcept { return m_extraData; }
+    const std::vector<Signature>& signatures() const noexcept { return m_signatures; }
+
+    // 修改字段（会使缓存的编码和哈希失效，不能与其它线程的访问并发）
+    void setParentHash(const H256& v) { m_parentHash = v; invalidate(); }
+    void setStateRoot(const H256& v) { m_stateRoot = v; invalidate(); }
+    void setTransactionsRoot(const H256& v) { m_transactionsRoot = v; invalidate(); }
+    void setReceiptsRoot(const H256& v) { m_receiptsRoot = v; invalidate(); }
+    void setLogBloom(const H2048& v) { m_logBloom = v; invalidate(); }
+    void setNumber(uint64_t v) { m_number = v; invalidate(); }
+    void setGasLimit(const U256& v) { m_gasLimit = v; invalidate(); }
+    void setGasUsed(const U256& v) { m_gasUsed = v; invalidate(); }
+    void setTimestamp(uint64_t v) { m_timestamp = v; invalidate(); }
+    void setExtraData(const Bytes& v) { m_extraData = v; invalidate(); }
+
+    // 追加签名（签名不影响区块哈希，只使缓存的完整编码失效）
+    void addSignature(const Signature& sig) {
+        m_signatures.push_back(sig);
+        m_rlp = SharedBytes();
+    }
+
+    // 区块哈希（第一次访问时计算，线程安全）
+    const H256& hash() const;
+
+    // 完整的RLP编码（解码得到的区块头直接返回原始编码）
+    SharedBytes rlp() const;
+
+private:
+    // 编码不含签名的部分
+    Bytes encodeUnsigned() const;
+
+    // 修改字段后清除缓存
+    void invalidate() {
+        m_rlp = SharedBytes();
+        m_unsignedRlp = SharedBytes();
+        m_hashValid.store(false, std::memory_order_relaxed);
+    }
+
+    // 拷贝另一个区块头（包括缓存）
+    void copyFrom(const BlockHeader& other);
+
+    H256 m_parentHash;                      // 父区块哈希
+    H256 m_stateRoot;                       // 状态根
+    H256 m_transactionsRoot;                // 交易根
+    H256 m_receiptsRoot;                    // 回执根
+    H2048 m_logBloom;                       // 日志布隆过滤器
+    uint64_t m_number = 0;                  // 区块高度
+    U256 m_gasLimit;                        // gas上限
+    U256 m_gasUsed;                         // 已使用的gas
+    uint64_t m_timestamp = 0;               // 时间戳（毫秒）
+    Bytes m_extraData;                      // 附加数据
+    std::vector<Signature> m_signatures;    // 共识节点对区块哈希的签名
+
+    SharedBytes m_rlp;                      // 完整的原始编码（为空表示没有缓存）
+    SharedBytes m_unsignedRlp;              // 原始编码中不含签名的子列表（为空表示没有缓存）
+
+    mutable Mutex m_hashMutex;
+    mutable std::atomic<bool> m_hashValid{false};
+    mutable H256 m_hash;                    // 区块哈希
+};
+
+}}   // namespace dev::eth
@@ -0,0 +1,23 @@
+/**
+ * 异常类型定义
+ * @file: Exceptions.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <libdevcore/Exceptions.h>
+
+namespace dev { namespace eth {
+
+// 默克尔帕特里夏树异常
+DEV_SIMPLE_EXCEPTION(BadTrieNode);
+DEV_SIMPLE_EXCEPTION(MissingTrieNode);
+
+// 交易异常
+DEV_SIMPLE_EXCEPTION(BadTransaction);
+
+// 区块异常
+DEV_SIMPLE_EXCEPTION(BadBlockHeader);
+
+}}   // namespace dev::eth
@@ -0,0 +1,228 @@
+/**
+ * 日志布隆过滤器
+ * @file: LogBloom.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "LogBloom.h"
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <libcrypto/Keccak.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace dev { namespace eth {
+
+// 布隆过滤器的64位字数
+static const size_t c_bloomWords = 2048 / 64;
+
+// 读取布隆过滤器的第i个64位字
+static inline uint64_t bloomWord(const LogBloom& bloom, size_t i) noexcept {
+    uint64_t w;
+    memcpy(&w, bloom.data() + i * 8, 8);
+    return w;
+}
+
+// 计算单个数据项（地址或topic）的布隆过滤器
+LogBloom bloomOf(BytesConstRef item) noexcept {
+    H256 h = keccak256(item);
+    LogBloom ret;
+    for (size_t i = 0; i < 6; i += 2) {
+        unsigned bit = ((unsigned(h[i]) << 8) | h[i + 1]) & 2047;
+        ret[255 - bit / 8] |= static_cast<Byte>(1 << (bit % 8));
+    }
+    return ret;
+}
+
+// 判断bloom是否包含query中的所有位（可能误判为包含，不会误判为不包含）
+bool containsBloom(const LogBloom& bloom, const LogBloom& query) noexcept {
+    for (size_t i = 0; i < c_bloomWords; ++i) {
+        uint64_t q = bloomWord(query, i);
+        if ((bloomWord(bloom, i) & q) != q) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 稀疏匹配的最大置位字数，超过后整体比较
+static const size_t c_maxSparseWords = 8;
+
+/**
+ * 批量匹配：query中置位的64位字通常只有几个，预先提取出来后每个布隆过滤器只需要比较这几个字，
+ * 置位字较多时用SSE2一次比较128位
+ * @param blooms 布隆过滤器数组
+ * @param query 查询条件
+ * @return 包含query的布隆过滤器下标
+ */
+std::vector<size_t> matchBlooms(const LogBlooms& blooms, const LogBloom& query) {
+    std::vector<std::pair<size_t, uint64_t>> words;
+    for (size_t i = 0; i < c_bloomWords; ++i) {
+        uint64_t q = bloomWord(query, i);
+        if (q) {
+            words.emplace_back(i, q);
+        }
+    }
+
+    std::vector<size_t> ret;
+    if (words.size() <= c_maxSparseWords) {
+        for (size_t b = 0; b < blooms.size(); ++b) {
+            bool match = true;
+            for (const auto& w : words) {
+                if ((bloomWord(blooms[b], w.first) & w.second) != w.second) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                ret.push_back(b);
+            }
+        }
+        return ret;
+    }
+
+#if defined(__SSE2__)
+    __m128i q[16];
+    for (size_t i = 0; i < 16; ++i) {
+        q[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(query.data() + i * 16));
+    }
+    for (size_t b = 0; b < blooms.size(); ++b) {
+        // 累积所有(~bloom & query)，全0表示包含
+        __m128i miss = _mm_setzero_si128();
+        const Byte* p = blooms[b].data();
+        for (size_t i = 0; i < 16; ++i) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+            miss = _mm_or_si128(miss, _mm_andnot_si128(v, q[i]));
+        }
+        if (0xffff == _mm_movemask_epi8(_mm_cmpeq_epi8(miss, _mm_setzero_si128()))) {
+            ret.push_back(b);
+        }
+    }
+#else
+    for (size_t b = 0; b < blooms.size(); ++b) {
+        if (containsBloom(blooms[b], query)) {
+            ret.push_back(b);
+        }
+    }
+#endif
+    return ret;
+}
+
+// 添加区块的布隆过滤器（同一个区块多次添加时按位或）
+void BloomIndex::add(uint64_t number, const LogBloom& bloom) {
+    size_t s = static_cast<size_t>(number / c_sectionSize);
+    if (s >= m_sections.size()) {
+        m_sections.resize(s + 1);
+    }
+    if (!m_sections[s]) {
+        m_sections[s].reset(new Section());
+    }
+    Section& section = *m_sections[s];
+    section.summary |= bloom;
+
+    size_t offset = static_cast<size_t>(number % c_sectionSize);
+    uint64_t mask = uint64_t(1) << (offset % 64);
+    section.present[offset / 64] |= mask;
+    for (size_t i = 0; i < 256; ++i) {
+        Byte b = bloom[i];
+        while (b) {
+            unsigned bit = __builtin_ctz(b);
+            b &= b - 1;
+            auto& row = section.rows[i * 8 + bit];
+            if (!row) {
+                row.reset(new Row());
+                row->fill(0);
+            }
+            (*row)[offset / 64] |= mask;
+        }
+    }
+}
+
+// 计算一段中匹配查询条件的区块位图，返回是否有匹配
+bool BloomIndex::matchSection(const Section& section, const std::vector<LogBlooms>& filters, Row& out) const {
+    // 从添加过的区块开始（空的查询条件不能匹配没有添加过的区块，比如超过最新区块的区块号）
+    out = section.present;
+    for (const auto& group : filters) {
+        if (group.empty()) {
+            continue;
+        }
+
+        // 组内各布隆过滤器之间为或
+        Row any;
+        any.fill(0);
+        for (const auto& bloom : group) {
+            // 摘要不包含时整段都不会匹配
+            if (!containsBloom(section.summary, bloom)) {
+                continue;
+            }
+            Row all;
+            all.fill(~uint64_t(0));
+            for (size_t i = 0; i < 256; ++i) {
+                Byte b = bloom[i];
+                while (b) {
+                    unsigned bit = __builtin_ctz(b);
+                    b &= b - 1;
+                    const Row& row = *section.rows[i * 8 + bit];
+                    for (size_t w = 0; w < c_rowWords; ++w) {
+                        all[w] &= row[w];
+                    }
+                }
+            }
+            for (size_t w = 0; w < c_rowWords; ++w) {
+                any[w] |= all[w];
+            }
+        }
+
+        // 组之间为与
+        uint64_t nonzero = 0;
+        for (size_t w = 0; w < c_rowWords; ++w) {
+            out[w] &= any[w];
+            nonzero |= out[w];
+        }
+        if (!nonzero) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 查询可能包含日志的区块
+ * @param from 起始区块号
+ * @param to 结束区块号（包含）
+ * @param filters 查询条件：外层各组之间为与，组内各布隆过滤器之间为或，空组表示不限（对应eth_getLogs的地址和各位置的topic）
+ * @return 候选区块号（升序，可能误判为匹配）
+ */
+std::vector<uint64_t> BloomIndex::query(uint64_t from, uint64_t to, const std::vector<LogBlooms>& filters) const {
+    std::vector<uint64_t> ret;
+    if (from > to) {
+        return ret;
+    }
+
+    uint64_t firstSection = from / c_sectionSize;
+    uint64_t lastSection = std::min<uint64_t>(to / c_sectionSize, m_sections.size() ? m_sections.size() - 1 : 0);
+    Row matched;
+    for (uint64_t s = firstSection; s <= lastSection && s < m_sections.size(); ++s) {
+        if (!m_sections[s] || !matchSection(*m_sections[s], filters, matched)) {
+            continue;
+        }
+
+        // 只保留[from, to]范围内的区块
+        uint64_t base = s * c_sectionSize;
+        for (size_t w = 0; w < c_rowWords; ++w) {
+            uint64_t bits = matched[w];
+            while (bits) {
+                uint64_t number = base + w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                if (number >= from && number <= to) {
+                    ret.push_back(number);
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+}}   // namespace dev::eth
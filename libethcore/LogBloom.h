@@ -0,0 +1,100 @@
+/**
+ * 日志布隆过滤器
+ * @file: LogBloom.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+
+namespace dev { namespace eth {
+
+/**
+ * 以太坊用2048位的布隆过滤器记录区块/回执中出现过的合约地址和日志topic：
+ * 对每个数据项计算keccak256，取哈希值的前3对字节，每对字节的低11位作为位下标（0~2047），
+ * 按大端序置位（位下标i对应第255 - i / 8个字节的第i % 8位）。
+ * 区块的布隆过滤器是所有回执的布隆过滤器按位或的结果
+ */
+
+// 日志布隆过滤器（256字节）
+using LogBloom = H2048;
+using LogBlooms = std::vector<LogBloom>;
+
+// 计算单个数据项（地址或topic）的布隆过滤器
+LogBloom bloomOf(BytesConstRef item) noexcept;
+
+// 把数据项加入布隆过滤器
+inline void addToBloom(LogBloom& bloom, BytesConstRef item) noexcept { bloom |= bloomOf(item); }
+
+// 按位或累加（例如把回执的布隆过滤器累加到区块）
+inline void accumulateBloom(LogBloom& acc, const LogBloom& bloom) noexcept { acc |= bloom; }
+
+// 判断bloom是否包含query中的所有位（可能误判为包含，不会误判为不包含）
+bool containsBloom(const LogBloom& bloom, const LogBloom& query) noexcept;
+
+/**
+ * 批量匹配：query中置位的64位字通常只有几个，预先提取出来后每个布隆过滤器只需要比较这几个字，
+ * 置位字较多时用SSE2一次比较128位
+ * @param blooms 布隆过滤器数组
+ * @param query 查询条件
+ * @return 包含query的布隆过滤器下标
+ */
+std::vector<size_t> matchBlooms(const LogBlooms& blooms, const LogBloom& query);
+
+/**
+ * 分段的位切片布隆索引，用于在大量区块中查询日志（类似eth_getLogs）：
+ * 1. 每c_sectionSize个区块为一段，每段保存所有区块布隆过滤器按位或的摘要，摘要不包含查询条件时整段跳过
+ * 2. 段内按位切片存储：2048个位各对应一行c_sectionSize位的位图，第j位表示段内第j个区块的布隆过滤器是否有该位，
+ *    查询时只需要把查询条件置位的几行按位与，得到候选区块，不需要逐个比较区块的布隆过滤器
+ * 行位图在第一次置位时才分配。非线程安全，需要调用者同步
+ */
+class BloomIndex {
+public:
+    // 每段的区块数
+    static constexpr uint64_t c_sectionSize = 4096;
+
+    // 添加区块的布隆过滤器（同一个区块多次添加时按位或）
+    void add(uint64_t number, const LogBloom& bloom);
+
+    /**
+     * 查询可能包含日志的区块
+     * @param from 起始区块号
+     * @param to 结束区块号（包含）
+     * @param filters 查询条件：外层各组之间为与，组内各布隆过滤器之间为或，空组表示不限（对应eth_getLogs的地址和各位置的topic）
+     * @return 候选区块号（升序，可能误判为匹配）
+     */
+    std::vector<uint64_t> query(uint64_t from, uint64_t to, const std::vector<LogBlooms>& filters) const;
+
+    // 查询布隆过滤器包含query的所有位的区块
+    std::vector<uint64_t> query(uint64_t from, uint64_t to, const LogBloom& query) const {
+        return this->query(from, to, std::vector<LogBlooms>{LogBlooms{query}});
+    }
+
+    // 已经建立索引的段数
+    size_t sectionCount() const noexcept { return m_sections.size(); }
+
+private:
+    // 段内位图的字数
+    static constexpr size_t c_rowWords = c_sectionSize / 64;
+
+    using Row = std::array<uint64_t, c_rowWords>;
+
+    // 一段区块的索引
+    struct Section {
+        LogBloom summary;                               // 所有区块布隆过滤器按位或的摘要
+        Row present{};                                  // 添加过的区块（没有查询条件时只返回这些区块）
+        std::array<std::unique_ptr<Row>, 2048> rows;    // 位切片（按布隆过滤器的存储位序）
+    };
+
+    // 计算一段中匹配查询条件的区块位图，返回是否有匹配
+    bool matchSection(const Section& section, const std::vector<LogBlooms>& filters, Row& out) const;
+
+    std::vector<std::unique_ptr<Section>> m_sections;   // 各段索引（下标为段号，未添加过的段为空）
+};
+
+}}   // namespace dev::eth
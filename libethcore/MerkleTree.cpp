@@ -0,0 +1,216 @@
+/**
+ * 默克尔树（交易根，回执根）
+ * @file: MerkleTree.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "MerkleTree.h"
+#include <cstring>
+#include <libdevcore/Exceptions.h>
+#include <libcrypto/Keccak.h>
+
+namespace dev { namespace eth {
+
+// 每个并行任务处理的节点数
+static const size_t c_parallelGrain = 256;
+
+// 叶子节点和内部节点的前缀（RFC 6962）
+static const Byte c_leafPrefix = 0x00;
+static const Byte c_nodePrefix = 0x01;
+
+// 计算叶子节点keccak256(0x00 || leaf)
+static inline H256 hashLeaf(const H256& leaf) noexcept {
+    Byte buf[33];
+    buf[0] = c_leafPrefix;
+    memcpy(buf + 1, leaf.data(), 32);
+    return keccak256(BytesConstRef(buf, sizeof(buf)));
+}
+
+// 计算父节点keccak256(0x01 || left || right)
+static inline H256 hashPair(const H256& left, const H256& right) noexcept {
+    Byte buf[65];
+    buf[0] = c_nodePrefix;
+    memcpy(buf + 1, left.data(), 32);
+    memcpy(buf + 33, right.data(), 32);
+    return keccak256(BytesConstRef(buf, sizeof(buf)));
+}
+
+// 计算上一层的第i个节点
+static inline H256 parentAt(const H256s& level, size_t i) noexcept {
+    size_t left = i * 2;
+    return left + 1 < level.size() ? hashPair(level[left], level[left + 1]) : level[left];
+}
+
+// 计算所有叶子节点
+static H256s leafLevel(const H256s& leaves, ThreadPool* pool) {
+    H256s nodes(leaves.size());
+    auto work = [&leaves, &nodes](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            nodes[i] = hashLeaf(leaves[i]);
+        }
+    };
+    if (pool && nodes.size() >= MerkleTree::c_parallelThreshold) {
+        pool->parallelFor(nodes.size(), c_parallelGrain, work);
+    } else {
+        work(0, nodes.size());
+    }
+    return nodes;
+}
+
+// 计算上一层的所有节点
+static H256s parentLevel(const H256s& level, ThreadPool* pool) {
+    H256s parents((level.size() + 1) / 2);
+    auto work = [&level, &parents](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            parents[i] = parentAt(level, i);
+        }
+    };
+    if (pool && parents.size() >= MerkleTree::c_parallelThreshold) {
+        pool->parallelFor(parents.size(), c_parallelGrain, work);
+    } else {
+        work(0, parents.size());
+    }
+    return parents;
+}
+
+// 构造默克尔树
+MerkleTree::MerkleTree(H256s leaves, ThreadPool* pool) : m_leafCount(leaves.size()) {
+    m_levels.push_back(std::move(leaves));
+    build(pool);
+}
+
+// 用RLP编码的数据项构造默克尔树（叶子为各数据项的keccak256哈希值）
+MerkleTree MerkleTree::fromItems(const std::vector<Bytes>& items, ThreadPool* pool) {
+    H256s leaves(items.size());
+    auto work = [&items, &leaves](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            leaves[i] = keccak256(items[i]);
+        }
+    };
+    if (pool && items.size() >= c_parallelThreshold) {
+        pool->parallelFor(items.size(), c_parallelGrain, work);
+    } else {
+        work(0, items.size());
+    }
+
+    MerkleTree ret;
+    ret.m_leafCount = leaves.size();
+    ret.m_levels.push_back(std::move(leaves));
+    ret.build(pool);
+    return ret;
+}
+
+// 获取叶子，若index越界抛出OutOfRange异常
+const H256& MerkleTree::leaf(size_t index) const {
+    if (index >= m_leafCount) {
+        throw OutOfRange("merkle leaf index out of range");
+    }
+    return m_levels.front()[index];
+}
+
+/**
+ * 生成成员证明
+ * @param index 叶子下标
+ * @return 从叶子到根路径上的兄弟节点
+ * @throw 若index越界抛出OutOfRange异常
+ */
+MerkleProof MerkleTree::proof(size_t index) const {
+    if (index >= m_leafCount) {
+        throw OutOfRange("merkle leaf index out of range");
+    }
+
+    // 从叶子节点层开始
+    MerkleProof ret;
+    for (size_t l = 1; l + 1 < m_levels.size(); ++l) {
+        size_t sibling = index ^ 1;
+        if (sibling < m_levels[l].size()) {
+            ret.push_back(m_levels[l][sibling]);
+        }
+        index /= 2;
+    }
+    return ret;
+}
+
+/**
+ * 修改一个叶子，并重新计算从该叶子到根路径上的节点
+ * @param index 叶子下标
+ * @param leaf 新的叶子
+ * @throw 若index越界抛出OutOfRange异常
+ */
+void MerkleTree::update(size_t index, const H256& leaf) {
+    if (index >= m_leafCount) {
+        throw OutOfRange("merkle leaf index out of range");
+    }
+
+    m_levels.front()[index] = leaf;
+    m_levels[1][index] = hashLeaf(leaf);
+    for (size_t l = 2; l < m_levels.size(); ++l) {
+        index /= 2;
+        m_levels[l][index] = parentAt(m_levels[l - 1], index);
+    }
+}
+
+/**
+ * 验证成员证明
+ * @param root 根
+ * @param leaf 叶子
+ * @param index 叶子下标
+ * @param leafCount 叶子数
+ * @param proof 成员证明
+ * @return 证明是否有效
+ */
+bool MerkleTree::verify(const H256& root, const H256& leaf, size_t index, size_t leafCount, const MerkleProof& proof) {
+    if (index >= leafCount) {
+        return false;
+    }
+
+    H256 node = hashLeaf(leaf);
+    size_t used = 0;
+    for (size_t count = leafCount; count > 1; count = (count + 1) / 2) {
+        size_t sibling = index ^ 1;
+        if (sibling < count) {
+            if (used >= proof.size()) {
+                return false;
+            }
+            node = (index & 1) ? hashPair(proof[used], node) : hashPair(node, proof[used]);
+            ++used;
+        }
+        index /= 2;
+    }
+    return used == proof.size() && node == root;
+}
+
+// 逐层计算到根
+void MerkleTree::build(ThreadPool* pool) {
+    if (m_levels.front().empty()) {
+        // 没有叶子时根为keccak256("")
+        m_levels.push_back(H256s{keccak256(BytesConstRef())});
+        return;
+    }
+    m_levels.push_back(leafLevel(m_levels.front(), pool));
+    while (m_levels.back().size() > 1) {
+        H256s parents = parentLevel(m_levels.back(), pool);
+        m_levels.push_back(std::move(parents));
+    }
+}
+
+// 计算默克尔根
+H256 merkleRoot(const H256s& leaves, ThreadPool* pool) {
+    if (leaves.empty()) {
+        return keccak256(BytesConstRef());
+    }
+
+    // 只需要根时不保留中间层
+    H256s level = leafLevel(leaves, pool);
+    while (level.size() > 1) {
+        level = parentLevel(level, pool);
+    }
+    return level.front();
+}
+
+// 计算RLP编码的数据项的默克尔根（叶子为各数据项的keccak256哈希值）
+H256 merkleRoot(const std::vector<Bytes>& items, ThreadPool* pool) {
+    return MerkleTree::fromItems(items, pool).root();
+}
+
+}}   // namespace dev::eth
@@ -0,0 +1,111 @@
+/**
+ * 默克尔树（交易根，回执根）
+ * @file: MerkleTree.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/ThreadPool.h>
+
+namespace dev { namespace eth {
+
+/**
+ * 二叉默克尔树，区块头中的交易根，回执根用它计算：
+ * 1. 叶子是H256哈希值（对RLP编码的数据项，叶子为keccak256(item)）
+ * 2. 与RFC 6962一样区分叶子节点和内部节点：叶子节点为keccak256(0x00 || leaf)，父节点为keccak256(0x01 || left || right)，
+ *    否则内部节点可以冒充叶子，用更短的证明通过验证（第二原像攻击），只有一个叶子时根也不等于叶子本身
+ * 3. 某一层节点数为奇数时，最后一个节点直接提升到上一层（不复制，避免出现两组叶子得到相同的根）
+ * 4. 没有叶子时根为keccak256("")
+ * 每一层的哈希计算相互独立，节点数较多时分段交给线程池并行计算。
+ * 保留所有层的节点，可以生成成员证明，修改一个叶子后只需要重新计算从该叶子到根路径上的O(log n)个节点
+ */
+
+// 成员证明：从叶子节点到根路径上的兄弟节点（节点被直接提升的层没有兄弟节点）
+using MerkleProof = H256s;
+
+class MerkleTree {
+public:
+    // 每一层的节点数不少于此值时才并行计算
+    static constexpr size_t c_parallelThreshold = 1024;
+
+    /**
+     * 构造默克尔树
+     * @param leaves 叶子
+     * @param pool 用于并行计算的线程池，为空时在当前线程计算
+     */
+    explicit MerkleTree(H256s leaves, ThreadPool* pool = nullptr);
+
+    /**
+     * 用RLP编码的数据项构造默克尔树（叶子为各数据项的keccak256哈希值）
+     * @param items RLP编码的数据项
+     * @param pool 用于并行计算的线程池，为空时在当前线程计算
+     */
+    static MerkleTree fromItems(const std::vector<Bytes>& items, ThreadPool* pool = nullptr);
+
+    // 根
+    const H256& root() const noexcept { return m_levels.back().front(); }
+
+    // 叶子数
+    size_t size() const noexcept { return m_leafCount; }
+
+    // 获取叶子，若index越界抛出OutOfRange异常
+    const H256& leaf(size_t index) const;
+
+    /**
+     * 生成成员证明
+     * @param index 叶子下标
+     * @return 从叶子到根路径上的兄弟节点
+     * @throw 若index越界抛出OutOfRange异常
+     */
+    MerkleProof proof(size_t index) const;
+
+    /**
+     * 修改一个叶子，并重新计算从该叶子到根路径上的节点
+     * @param index 叶子下标
+     * @param leaf 新的叶子
+     * @throw 若index越界抛出OutOfRange异常
+     */
+    void update(size_t index, const H256& leaf);
+
+    /**
+     * 验证成员证明
+     * @param root 根
+     * @param leaf 叶子
+     * @param index 叶子下标
+     * @param leafCount 叶子数
+     * @param proof 成员证明
+     * @return 证明是否有效
+     */
+    static bool verify(const H256& root, const H256& leaf, size_t index, size_t leafCount, const MerkleProof& proof);
+
+private:
+    MerkleTree() = default;
+
+    // 逐层计算到根
+    void build(ThreadPool* pool);
+
+    std::vector<H256s> m_levels;    // 每一层的节点，第0层为叶子，第1层为叶子节点，最后一层只有根
+    size_t m_leafCount = 0;         // 叶子数
+};
+
+/**
+ * 计算默克尔根
+ * @param leaves 叶子
+ * @param pool 用于并行计算的线程池，为空时在当前线程计算
+ * @return 默克尔根
+ */
+H256 merkleRoot(const H256s& leaves, ThreadPool* pool = nullptr);
+
+/**
+ * 计算RLP编码的数据项的默克尔根（叶子为各数据项的keccak256哈希值）
+ * @param items RLP编码的数据项
+ * @param pool 用于并行计算的线程池，为空时在当前线程计算
+ * @return 默克尔根
+ */
+H256 merkleRoot(const std::vector<Bytes>& items, ThreadPool* pool = nullptr);
+
+}}   // namespace dev::eth
@@ -0,0 +1,183 @@
+/**
+ * 交易类型
+ * @file: Transaction.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "Transaction.h"
+#include <libdevcore/RLP.h>
+#include <libdevcore/RLPSchema.h>
+#include <libdevcore/Profiler.h>
+#include <libcrypto/Keccak.h>
+#include "Exceptions.h"
+
+namespace dev { namespace eth {
+
+// 交易的RLP列表字段数
+static const size_t c_txFieldCount = 9;
+
+// 签名的数字摘要所包含的字段数（不含EIP-155追加的字段）
+static const size_t c_txUnsignedFieldCount = 6;
+
+// 签名交易的RLP编码布局（编码和解码共用）
+struct TransactionRLP {
+    U256 nonce;
+    U256 gasPrice;
+    U256 gas;
+    SmallBytes to;              // 创建合约的交易为空
+    U256 value;
+    Bytes data;
+    uint64_t v = 0;             // recovery id + 27，或者启用EIP-155时为recovery id + chainId * 2 + 35
+    U256 r;
+    U256 s;
+
+    RLP_FIELDS(nonce, gasPrice, gas, to, value, data, v, r, s)
+};
+
+// 追加EIP-155字段[chainId, 0, 0]
+static void appendChainId(RLPStream& s, uint64_t chainId) {
+    s << chainId << uint64_t(0) << uint64_t(0);
+}
+
+/**
+ * 用RLP编码构造交易（只检查最外层是否为列表，字段在第一次访问时才解码）
+ * @param rlp 交易的RLP编码（可以是区块中的一段，不拷贝）
+ * @throw 若编码不是合法的RLP列表抛出BadTransaction异常
+ */
+Transaction::Transaction(SharedBytes rlp) : m_rlp(std::move(rlp)) {
+    try {
+        if (!RLP(m_rlp).isList()) {
+            throw BadTransaction("transaction RLP is not a list");
+        }
+    } catch (const RLPExcept& e) {
+        throw BadTransaction(e.what());
+    }
+}
+
+/**
+ * 构造并签名新交易
+ * @param ts 交易字段
+ * @param sec 发送者私钥
+ * @return 签名后的交易
+ * @throw 签名错误抛出BadSignature异常
+ */
+Transaction::SP Transaction::sign(const TransactionSkeleton& ts, const SecKey& sec) {
+    auto appendFields = [&ts](RLPStream& s) {
+        s << ts.nonce << ts.gasPrice << ts.gas;
+        if (ts.creation) {
+            s.append(BytesConstRef());
+        } else {
+            s.append(ts.to);
+        }
+        s << ts.value << ts.data;
+    };
+
+    RLPStream unsignedStream(ts.chainId ? c_txFieldCount : c_txUnsignedFieldCount);
+    appendFields(unsignedStream);
+    if (ts.chainId) {
+        appendChainId(unsignedStream, ts.chainId);
+    }
+    Signature sig = dev::sign(sec, keccak256(unsignedStream.take()));
+
+    TransactionRLP tx;
+    tx.nonce = ts.nonce;
+    tx.gasPrice = ts.gasPrice;
+    tx.gas = ts.gas;
+    if (!ts.creation) {
+        tx.to = SmallBytes(ts.to.ref());
+    }
+    tx.value = ts.value;
+    tx.data = ts.data;
+    tx.v = ts.chainId ? ts.chainId * 2 + 35 + sig.v : uint64_t(27) + sig.v;
+    tx.r = fromBigEndian<U256>(sig.r.ref());
+    tx.s = fromBigEndian<U256>(sig.s.ref());
+    return std::make_shared<Transaction>(SharedBytes(rlpEncode(tx)));
+}
+
+// 获取解码后的字段（第一次调用时解码）
+const Transaction::Fields& Transaction::decoded() const {
+    std::call_once(m_decodeFlag, [this] {
+        try {
+            TransactionRLP tx;
+            rlpDecode(m_rlp, tx);
+
+            Fields f;
+            f.nonce = tx.nonce;
+            f.gasPrice = tx.gasPrice;
+            f.gas = tx.gas;
+            if (tx.to.empty()) {
+                f.creation = true;
+            } else if (tx.to.size() == Address().size()) {
+                f.to = Address(tx.to.ref());
+            } else {
+                throw BadTransaction("bad receiver address");
+            }
+            f.value = tx.value;
+            f.data = std::move(tx.data);
+
+            // 解析v得到chainId和recovery id
+            uint64_t v = tx.v;
+            if (27 == v || 28 == v) {
+                f.sig.v = static_cast<Byte>(v - 27);
+            } else if (v >= 35) {
+                f.chainId = (v - 35) / 2;
+                f.sig.v = static_cast<Byte>((v - 35) % 2);
+            } else {
+                throw BadTransaction("bad signature v");
+            }
+
+            // r，s必须在[1, n)范围内，并且s不超过n/2（防止签名延展性）
+            if (!tx.r || !tx.s || tx.r >= c_secp256k1n || tx.s > c_secp256k1nHalf) {
+                throw BadTransaction("bad signature r/s");
+            }
+            toBigEndian(tx.r, f.sig.r.ref());
+            toBigEndian(tx.s, f.sig.s.ref());
+
+            m_fields = std::move(f);
+        } catch (const RLPExcept& e) {
+            throw BadTransaction(e.what());
+        }
+    });
+    return m_fields;
+}
+
+// 交易哈希（原始编码的keccak256）
+const H256& Transaction::hash() const {
+    std::call_once(m_hashFlag, [this] {
+        m_hash = keccak256(m_rlp);
+    });
+    return m_hash;
+}
+
+// 签名的数字摘要（若编码不合法抛出BadTransaction异常）
+const H256& Transaction::signingHash() const {
+    std::call_once(m_signingHashFlag, [this] {
+        const Fields& f = decoded();
+
+        // 直接复用原始编码中的前6个字段，不需要重新编码
+        std::vector<RLP> items = RLP(m_rlp).splitList();
+        RLPStream s(f.chainId ? c_txFieldCount : c_txUnsignedFieldCount);
+        for (size_t i = 0; i < c_txUnsignedFieldCount; ++i) {
+            s.append(items[i]);
+        }
+        if (f.chainId) {
+            appendChainId(s, f.chainId);
+        }
+        m_signingHash = keccak256(s.take());
+    });
+    return m_signingHash;
+}
+
+/**
+ * 发送者地址
+ * @throw 若编码不合法抛出BadTransaction异常，恢复签名失败抛出BadSignature异常
+ */
+const Address& Transaction::sender() const {
+    std::call_once(m_senderFlag, [this] {
+        PROFILE_SCOPE("tx.recoverSender");
+        m_sender = toAddress(recover(signature(), signingHash()));
+    });
+    return m_sender;
+}
+
+}}   // namespace dev::eth
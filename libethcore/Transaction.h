@@ -0,0 +1,127 @@
+/**
+ * 交易类型
+ * @file: Transaction.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/SharedBytes.h>
+#include <libcrypto/ECDSA.h>
+#include "Address.h"
+
+namespace dev { namespace eth {
+
+/**
+ * 交易的RLP编码为[nonce, gasPrice, gas, to, value, data, v, r, s]：
+ * to为空表示创建合约；签名的数字摘要为前6个字段组成的列表的keccak256哈希值，
+ * EIP-155之后列表末尾再追加[chainId, 0, 0]，v = chainId * 2 + 35 + recoveryId，之前v = 27 + recoveryId
+ */
+
+// 构造新交易所需的字段
+struct TransactionSkeleton {
+    U256 nonce;
+    U256 gasPrice;
+    U256 gas;
+    bool creation = false;      // 是否为创建合约的交易（此时忽略to）
+    Address to;
+    U256 value;
+    Bytes data;
+    uint64_t chainId = 0;       // 为0时不启用EIP-155
+};
+
+/**
+ * 交易从准入，广播，打包到执行要多次用到哈希和发送者，这里把它们缓存下来：
+ * 1. 只保存原始RLP编码，各字段在第一次访问时才解码
+ * 2. 哈希为原始编码的keccak256，第一次访问时计算
+ * 3. 发送者在第一次访问时从签名恢复
+ * 以上都用std::call_once保证多线程访问时只计算一次，对象不可拷贝，通过SP共享
+ */
+class Transaction {
+public:
+    using SP = std::shared_ptr<Transaction>;
+
+    /**
+     * 用RLP编码构造交易（只检查最外层是否为列表，字段在第一次访问时才解码）
+     * @param rlp 交易的RLP编码（可以是区块中的一段，不拷贝）
+     * @throw 若编码不是合法的RLP列表抛出BadTransaction异常
+     */
+    explicit Transaction(SharedBytes rlp);
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /**
+     * 构造并签名新交易
+     * @param ts 交易字段
+     * @param sec 发送者私钥
+     * @return 签名后的交易
+     * @throw 签名错误抛出BadSignature异常
+     */
+    static SP sign(const TransactionSkeleton& ts, const SecKey& sec);
+
+    // 原始RLP编码
+    const SharedBytes& rlp() const noexcept { return m_rlp; }
+
+    // 各字段（第一次访问时解码，若编码不合法抛出BadTransaction异常）
+    const U256& nonce() const { return decoded().nonce; }
+    const U256& gasPrice() const { return decoded().gasPrice; }
+    const U256& gas() const { return decoded().gas; }
+    bool isCreation() const { return decoded().creation; }
+    const Address& to() const { return decoded().to; }
+    const U256& value() const { return decoded().value; }
+    const Bytes& data() const { return decoded().data; }
+    uint64_t chainId() const { return decoded().chainId; }
+    const Signature& signature() const { return decoded().sig; }
+
+    // 交易哈希（原始编码的keccak256）
+    const H256& hash() const;
+
+    // 签名的数字摘要（若编码不合法抛出BadTransaction异常）
+    const H256& signingHash() const;
+
+    /**
+     * 发送者地址
+     * @throw 若编码不合法抛出BadTransaction异常，恢复签名失败抛出BadSignature异常
+     */
+    const Address& sender() const;
+
+private:
+    // 解码后的字段
+    struct Fields {
+        U256 nonce;
+        U256 gasPrice;
+        U256 gas;
+        bool creation = false;
+        Address to;
+        U256 value;
+        Bytes data;
+        uint64_t chainId = 0;
+        Signature sig;
+    };
+
+    // 获取解码后的字段（第一次调用时解码）
+    const Fields& decoded() const;
+
+    SharedBytes m_rlp;                      // 原始RLP编码
+
+    mutable std::once_flag m_decodeFlag;
+    mutable Fields m_fields;                // 解码后的字段
+
+    mutable std::once_flag m_hashFlag;
+    mutable H256 m_hash;                    // 交易哈希
+
+    mutable std::once_flag m_signingHashFlag;
+    mutable H256 m_signingHash;             // 签名的数字摘要
+
+    mutable std::once_flag m_senderFlag;
+    mutable Address m_sender;               // 发送者地址
+};
+
+using Transactions = std::vector<Transaction::SP>;
+
+}}   // namespace dev::eth
@@ -0,0 +1,563 @@
+/**
+ * 默克尔帕特里夏树（Merkle Patricia Trie）
+ * @file: Trie.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "Trie.h"
+#include <algorithm>
+#include <iterator>
+#include <libdevcore/RLP.h>
+#include <libdevcore/Profiler.h>
+#include <libcrypto/Keccak.h>
+#include "Exceptions.h"
+
+namespace dev { namespace eth {
+
+// 空树的根（keccak256(rlp("")) = keccak256(0x80)），直接写出常量，
+// 不能在静态初始化时依赖其它编译单元的全局变量（c_rlpEmptyData可能还没有初始化）
+const H256 c_emptyTrieRoot("56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421");
+
+// 节点
+struct Trie::Node {
+    enum Type : uint8_t {
+        c_leaf,
+        c_extension,
+        c_branch
+    };
+
+    Type type;
+    bool dirty = true;          // 是否被修改过（需要重新计算编码和哈希）
+    Bytes path;                 // 叶子/扩展节点的路径（半字节序列）
+    Bytes value;                // 叶子/分支节点的值
+    std::vector<Ref> children;  // 扩展节点有1个子节点，分支节点有16个子节点
+    Bytes ref;                  // 不脏时父节点对它的引用编码（内联的RLP编码，或者rlp(哈希)）
+
+    explicit Node(Type t) : type(t) {
+        if (c_extension == type) {
+            children.resize(1);
+        } else if (c_branch == type) {
+            children.resize(16);
+        }
+    }
+};
+
+using Node = Trie::Node;
+using Ref = Trie::Ref;
+using NodeWrites = std::vector<std::pair<H256, Bytes>>;
+
+// 字节序列转换为半字节序列
+static Bytes toNibbles(BytesConstRef key) {
+    Bytes ret(key.size() * 2);
+    for (size_t i = 0; i < key.size(); ++i) {
+        ret[i * 2] = key[i] >> 4;
+        ret[i * 2 + 1] = key[i] & 0x0f;
+    }
+    return ret;
+}
+
+// 公共前缀长度
+static size_t commonPrefix(BytesConstRef a, BytesConstRef b) noexcept {
+    size_t n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// 判断两个半字节序列是否相同
+static bool samePath(BytesConstRef a, BytesConstRef b) noexcept {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+// 判断prefix是否为path的前缀
+static bool startsWith(BytesConstRef path, BytesConstRef prefix) noexcept {
+    return path.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), path.begin());
+}
+
+// 拼接半字节序列
+static Bytes concatPath(BytesConstRef a, BytesConstRef b) {
+    Bytes ret(a.begin(), a.end());
+    ret.insert(ret.end(), b.begin(), b.end());
+    return ret;
+}
+
+/**
+ * Hex-Prefix编码：第一个半字节为标志（bit1表示叶子，bit0表示路径长度为奇数），
+ * 长度为偶数时补一个0半字节，然后每两个半字节合成一个字节
+ */
+static Bytes hexPrefixEncode(BytesConstRef path, bool isLeaf) {
+    bool odd = path.size() & 1;
+    Bytes ret(path.size() / 2 + 1);
+    ret[0] = static_cast<Byte>(((isLeaf ? 2 : 0) + (odd ? 1 : 0)) << 4);
+    size_t i = 0;
+    if (odd) {
+        ret[0] |= path[0];
+        i = 1;
+    }
+    for (size_t j = 1; i < path.size(); i += 2, ++j) {
+        ret[j] = static_cast<Byte>((path[i] << 4) | path[i + 1]);
+    }
+    return ret;
+}
+
+// Hex-Prefix解码，若编码不合法抛出BadTrieNode异常
+static Bytes hexPrefixDecode(BytesConstRef bs, bool& isLeaf) {
+    if (bs.empty() || (bs[0] >> 4) > 3) {
+        throw BadTrieNode("bad hex prefix");
+    }
+    isLeaf = bs[0] & 0x20;
+    bool odd = bs[0] & 0x10;
+    if (!odd && (bs[0] & 0x0f)) {
+        throw BadTrieNode("bad hex prefix");
+    }
+
+    Bytes ret;
+    ret.reserve(bs.size() * 2);
+    if (odd) {
+        ret.push_back(bs[0] & 0x0f);
+    }
+    for (size_t i = 1; i < bs.size(); ++i) {
+        ret.push_back(bs[i] >> 4);
+        ret.push_back(bs[i] & 0x0f);
+    }
+    return ret;
+}
+
+// 构造叶子节点
+static std::unique_ptr<Node> makeLeaf(BytesConstRef path, Bytes value) {
+    std::unique_ptr<Node> ret(new Node(Node::c_leaf));
+    ret->path.assign(path.begin(), path.end());
+    ret->value = std::move(value);
+    return ret;
+}
+
+// 构造扩展节点
+static std::unique_ptr<Node> makeExtension(BytesConstRef path, Ref child) {
+    std::unique_ptr<Node> ret(new Node(Node::c_extension));
+    ret->path.assign(path.begin(), path.end());
+    ret->children[0] = std::move(child);
+    return ret;
+}
+
+// 包装为引用
+static Ref toRef(std::unique_ptr<Node> node) {
+    Ref ret;
+    ret.node = std::move(node);
+    return ret;
+}
+
+static std::unique_ptr<Node> decodeNode(RLP rlp);
+
+// 解码子节点引用，若编码不合法抛出BadTrieNode异常
+static Ref decodeRef(RLP item) {
+    Ref ret;
+    if (item.isList()) {
+        // 内联节点
+        ret.node = decodeNode(item);
+        ret.node->ref.assign(item.actualData().begin(), item.actualData().end());
+    } else if (item.isEmptyData()) {
+        // 空
+    } else if (32 == item.payload().size()) {
+        ret.hash = H256(item.payload());
+    } else {
+        throw BadTrieNode("bad node reference");
+    }
+    return ret;
+}
+
+// 解码节点（不设置引用编码），若编码不合法抛出BadTrieNode异常
+static std::unique_ptr<Node> decodeNode(RLP rlp) {
+    try {
+        std::vector<RLP> items = rlp.splitList();
+        std::unique_ptr<Node> ret;
+        if (2 == items.size()) {
+            bool isLeaf;
+            Bytes path = hexPrefixDecode(items[0].payload(), isLeaf);
+            if (isLeaf) {
+                ret.reset(new Node(Node::c_leaf));
+                ret->value = items[1].toBytes();
+            } else {
+                ret.reset(new Node(Node::c_extension));
+                ret->children[0] = decodeRef(items[1]);
+            }
+            ret->path = std::move(path);
+        } else if (17 == items.size()) {
+            ret.reset(new Node(Node::c_branch));
+            for (size_t i = 0; i < 16; ++i) {
+                ret->children[i] = decodeRef(items[i]);
+            }
+            ret->value = items[16].toBytes();
+        } else {
+            throw BadTrieNode("bad node item count");
+        }
+        ret->dirty = false;
+        return ret;
+    } catch (const RLPExcept& e) {
+        throw BadTrieNode(e.what());
+    }
+}
+
+// 获取引用指向的节点（未加载时从存储中读取）
+static Node* resolveRef(Ref& ref, const TrieStore& store) {
+    if (!ref.node && ref.hash) {
+        Bytes encoded;
+        if (!store.get(ref.hash, encoded)) {
+            throw MissingTrieNode(ref.hash.hex());
+        }
+        ref.node = decodeNode(RLP(encoded));
+        ref.node->ref = rlpData(ref.hash);
+        ref.hash = H256();
+    }
+    return ref.node.get();
+}
+
+// 追加子节点引用
+static void appendRef(RLPStream& s, const Ref& ref) {
+    if (ref.node) {
+        s.append(RLP(ref.node->ref));
+    } else if (ref.hash) {
+        s.append(ref.hash.ref());
+    } else {
+        s.append(BytesConstRef());
+    }
+}
+
+// 编码节点（子节点都已经计算过引用编码）
+static Bytes encodeNode(const Node& node) {
+    if (Node::c_branch == node.type) {
+        RLPStream s(17);
+        for (const auto& child : node.children) {
+            appendRef(s, child);
+        }
+        s.append(node.value);
+        return s.take();
+    }
+
+    RLPStream s(2);
+    s.append(hexPrefixEncode(node.path, Node::c_leaf == node.type));
+    if (Node::c_leaf == node.type) {
+        s.append(node.value);
+    } else {
+        appendRef(s, node.children[0]);
+    }
+    return s.take();
+}
+
+/**
+ * 自底向上计算脏节点的引用编码，新的非内联节点追加到writes
+ * @param ref 子树的根
+ * @param writes 需要写入存储的节点
+ * @param pool 线程池，为空时不并行
+ * @param depth 当前深度
+ */
+static void hashRef(Ref& ref, NodeWrites& writes, ThreadPool* pool, unsigned depth) {
+    Node* node = ref.node.get();
+    if (!node || !node->dirty) {
+        return;
+    }
+
+    if (pool && Node::c_branch == node->type && depth < Trie::c_parallelDepth) {
+        // 各子树互不相交，可以并行计算
+        std::vector<NodeWrites> childWrites(16);
+        pool->parallelFor(16, 1, [node, &childWrites, pool, depth](size_t beg, size_t end) {
+            for (size_t i = beg; i < end; ++i) {
+                hashRef(node->children[i], childWrites[i], pool, depth + 1);
+            }
+        });
+        for (auto& w : childWrites) {
+            std::move(w.begin(), w.end(), std::back_inserter(writes));
+        }
+    } else {
+        for (auto& child : node->children) {
+            hashRef(child, writes, nullptr, depth + 1);
+        }
+    }
+
+    Bytes encoded = encodeNode(*node);
+    if (encoded.size() < 32) {
+        node->ref = std::move(encoded);
+    } else {
+        H256 hash = keccak256(encoded);
+        node->ref = rlpData(hash);
+        writes.emplace_back(hash, std::move(encoded));
+    }
+    node->dirty = false;
+}
+
+// 插入或修改
+static void insertAt(Ref& ref, BytesConstRef key, Bytes&& value, const TrieStore& store) {
+    if (ref.empty()) {
+        ref.node = makeLeaf(key, std::move(value));
+        return;
+    }
+
+    Node* node = resolveRef(ref, store);
+    if (Node::c_branch == node->type) {
+        if (key.empty()) {
+            node->value = std::move(value);
+        } else {
+            insertAt(node->children[key[0]], key.cropped(1), std::move(value), store);
+        }
+        node->dirty = true;
+        return;
+    }
+
+    BytesConstRef path(node->path);
+    size_t common = commonPrefix(path, key);
+    if (Node::c_leaf == node->type && common == path.size() && common == key.size()) {
+        // 修改叶子的值
+        node->value = std::move(value);
+        node->dirty = true;
+        return;
+    }
+    if (Node::c_extension == node->type && common == path.size()) {
+        // 插入到扩展节点的子树中
+        insertAt(node->children[0], key.cropped(common), std::move(value), store);
+        node->dirty = true;
+        return;
+    }
+
+    // 在公共前缀之后分叉：用一个分支节点容纳原节点的剩余部分和新的键
+    std::unique_ptr<Node> branch(new Node(Node::c_branch));
+    if (Node::c_leaf == node->type) {
+        if (common == path.size()) {
+            branch->value = std::move(node->value);
+        } else {
+            branch->children[path[common]].node = makeLeaf(path.cropped(common + 1), std::move(node->value));
+        }
+    } else {
+        Ref& slot = branch->children[path[common]];
+        if (common + 1 == path.size()) {
+            slot = std::move(node->children[0]);
+        } else {
+            slot.node = makeExtension(path.cropped(common + 1), std::move(node->children[0]));
+        }
+    }
+    if (common == key.size()) {
+        branch->value = std::move(value);
+    } else {
+        branch->children[key[common]].node = makeLeaf(key.cropped(common + 1), std::move(value));
+    }
+
+    if (common > 0) {
+        ref.node = makeExtension(key.cropped(0, common), toRef(std::move(branch)));
+    } else {
+        ref.node = std::move(branch);
+    }
+}
+
+// 删除后整理节点，保证树的形状与插入顺序无关（分支节点至少有两个分叉，扩展节点的子节点是分支节点）
+static void normalize(Ref& ref, const TrieStore& store) {
+    Node* node = ref.node.get();
+    if (Node::c_extension == node->type) {
+        Node* child = resolveRef(node->children[0], store);
+        if (Node::c_leaf == child->type) {
+            ref.node = makeLeaf(concatPath(node->path, child->path), std::move(child->value));
+        } else if (Node::c_extension == child->type) {
+            ref.node = makeExtension(concatPath(node->path, child->path), std::move(child->children[0]));
+        }
+        return;
+    }
+    if (Node::c_branch != node->type) {
+        return;
+    }
+
+    size_t count = node->value.empty() ? 0 : 1;
+    size_t last = 16;
+    for (size_t i = 0; i < 16 && count < 2; ++i) {
+        if (!node->children[i].empty()) {
+            ++count;
+            last = i;
+        }
+    }
+    if (count >= 2) {
+        return;
+    }
+    if (16 == last) {
+        // 只剩下值
+        ref.node = makeLeaf(BytesConstRef(), std::move(node->value));
+        return;
+    }
+
+    // 只剩下一个子节点，与其合并
+    Byte nibble = static_cast<Byte>(last);
+    Node* child = resolveRef(node->children[last], store);
+    if (Node::c_leaf == child->type) {
+        ref.node = makeLeaf(concatPath(BytesConstRef(&nibble, 1), child->path), std::move(child->value));
+    } else if (Node::c_extension == child->type) {
+        ref.node = makeExtension(concatPath(BytesConstRef(&nibble, 1), child->path), std::move(child->children[0]));
+    } else {
+        ref.node = makeExtension(BytesConstRef(&nibble, 1), std::move(node->children[last]));
+    }
+}
+
+// 删除
+static bool removeAt(Ref& ref, BytesConstRef key, const TrieStore& store) {
+    if (ref.empty()) {
+        return false;
+    }
+
+    Node* node = resolveRef(ref, store);
+    bool removed = false;
+    if (Node::c_leaf == node->type) {
+        if (samePath(key, node->path)) {
+            ref = Ref();
+            return true;
+        }
+        return false;
+    } else if (Node::c_extension == node->type) {
+        BytesConstRef path(node->path);
+        if (startsWith(key, path)) {
+            removed = removeAt(node->children[0], key.cropped(path.size()), store);
+        }
+    } else if (key.empty()) {
+        removed = !node->value.empty();
+        node->value.clear();
+    } else {
+        removed = removeAt(node->children[key[0]], key.cropped(1), store);
+    }
+
+    if (removed) {
+        node->dirty = true;
+        normalize(ref, store);
+    }
+    return removed;
+}
+
+// 批量写入节点
+void MemoryTrieStore::put(std::vector<std::pair<H256, Bytes>>&& nodes) {
+    for (auto& node : nodes) {
+        m_nodes.insert(node.first, node.second);
+    }
+}
+
+/**
+ * 打开一棵树
+ * @param store 节点存储
+ * @param root 根，为c_emptyTrieRoot时表示空树
+ */
+Trie::Trie(TrieStore::SP store, const H256& root) : m_rootHash(root), m_store(std::move(store)) {
+    if (root != c_emptyTrieRoot) {
+        m_root.hash = root;
+    }
+}
+
+Trie::~Trie() = default;
+
+// 获取引用指向的节点（未加载时从存储中读取）
+Trie::Node* Trie::resolve(Ref& ref) {
+    return resolveRef(ref, *m_store);
+}
+
+/**
+ * 查找
+ * @param key 键
+ * @param value 值
+ * @return 键是否存在
+ * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+ */
+bool Trie::get(BytesConstRef key, Bytes& value) {
+    Bytes nibbles = toNibbles(key);
+    BytesConstRef k(nibbles);
+    Ref* ref = &m_root;
+    while (!ref->empty()) {
+        Node* node = resolve(*ref);
+        if (Node::c_branch == node->type) {
+            if (k.empty()) {
+                if (node->value.empty()) {
+                    return false;
+                }
+                value = node->value;
+                return true;
+            }
+            ref = &node->children[k[0]];
+            k = k.cropped(1);
+            continue;
+        }
+
+        BytesConstRef path(node->path);
+        if (Node::c_leaf == node->type) {
+            if (!samePath(k, path)) {
+                return false;
+            }
+            value = node->value;
+            return true;
+        }
+        if (!startsWith(k, path)) {
+            return false;
+        }
+        ref = &node->children[0];
+        k = k.cropped(path.size());
+    }
+    return false;
+}
+
+/**
+ * 插入或修改（值为空时等同于删除）
+ * @param key 键
+ * @param value 值
+ * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+ */
+void Trie::insert(BytesConstRef key, BytesConstRef value) {
+    if (value.empty()) {
+        remove(key);
+        return;
+    }
+    Bytes nibbles = toNibbles(key);
+    insertAt(m_root, nibbles, Bytes(value.begin(), value.end()), *m_store);
+}
+
+/**
+ * 删除
+ * @param key 键
+ * @return 键是否存在
+ * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+ */
+bool Trie::remove(BytesConstRef key) {
+    Bytes nibbles = toNibbles(key);
+    return removeAt(m_root, nibbles, *m_store);
+}
+
+/**
+ * 计算所有脏节点的哈希，并把新节点批量写入存储
+ * @param pool 用于并行计算的线程池，为空时在当前线程计算
+ * @return 新的根
+ */
+H256 Trie::commit(ThreadPool* pool) {
+    PROFILE_SCOPE("trie.commit");
+    if (m_root.empty()) {
+        m_rootHash = c_emptyTrieRoot;
+        return m_rootHash;
+    }
+    if (!m_root.node || !m_root.node->dirty) {
+        return m_rootHash;
+    }
+
+    NodeWrites writes;
+    hashRef(m_root, writes, pool, 0);
+
+    Node* root = m_root.node.get();
+    if (root->ref.size() < 32) {
+        // 根节点无论长短都以哈希值引用
+        m_rootHash = keccak256(root->ref);
+        writes.emplace_back(m_rootHash, root->ref);
+        root->ref = rlpData(m_rootHash);
+    } else {
+        m_rootHash = H256(RLP(root->ref).payload());
+    }
+
+    m_store->put(std::move(writes));
+    return m_rootHash;
+}
+
+// 是否有未提交的修改
+bool Trie::dirty() const noexcept {
+    if (m_root.node) {
+        return m_root.node->dirty;
+    }
+    return m_root.empty() ? c_emptyTrieRoot != m_rootHash : m_root.hash != m_rootHash;
+}
+
+}}   // namespace dev::eth
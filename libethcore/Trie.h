@@ -0,0 +1,150 @@
+/**
+ * 默克尔帕特里夏树（Merkle Patricia Trie）
+ * @file: Trie.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/FlatHashMap.h>
+#include <libdevcore/ThreadPool.h>
+
+namespace dev { namespace eth {
+
+/**
+ * 以太坊的世界状态，合约存储，交易/回执列表都用默克尔帕特里夏树组织，树中有三种节点：
+ * 叶子节点：[hexPrefix(剩余路径, 1), 值]
+ * 扩展节点：[hexPrefix(共享路径, 0), 子节点引用]
+ * 分支节点：[16个子节点引用..., 值]
+ * 节点的RLP编码不少于32字节时，父节点引用其keccak256哈希值（节点以哈希为键存入存储），
+ * 否则直接把节点的RLP编码内联到父节点中；根节点无论长短都以哈希值引用。
+ *
+ * 写操作只修改内存中的节点并标记为脏，不计算哈希；commit()时一次性自底向上计算所有脏节点的哈希，
+ * 分支节点的各个子树相互独立，靠近根的几层交给线程池并行计算，新节点最后批量写入存储。
+ * 已加载的节点常驻内存（相当于节点缓存），未加载的子树只保存哈希，访问时才从存储中读取
+ */
+
+// 空树的根（keccak256(rlp("")))
+extern const H256 c_emptyTrieRoot;
+
+// 节点存储接口（以节点哈希为键）
+class TrieStore {
+public:
+    using SP = std::shared_ptr<TrieStore>;
+
+    virtual ~TrieStore() = default;
+
+    /**
+     * 读取节点
+     * @param hash 节点哈希
+     * @param out 节点的RLP编码
+     * @return 节点是否存在
+     */
+    virtual bool get(const H256& hash, Bytes& out) const = 0;
+
+    /**
+     * 批量写入节点
+     * @param nodes 节点哈希与RLP编码
+     */
+    virtual void put(std::vector<std::pair<H256, Bytes>>&& nodes) = 0;
+};
+
+// 内存节点存储（线程安全）
+class MemoryTrieStore : public TrieStore {
+public:
+    bool get(const H256& hash, Bytes& out) const override { return m_nodes.tryGet(hash, out); }
+    void put(std::vector<std::pair<H256, Bytes>>&& nodes) override;
+
+    // 节点数
+    size_t size() const { return m_nodes.size(); }
+
+private:
+    ConcurrentFlatHashMap<32, Bytes> m_nodes;
+};
+
+// 默克尔帕特里夏树（非线程安全，读操作也可能从存储中加载节点）
+class Trie {
+public:
+    // 距离根小于此深度的分支节点，各子树在commit()时并行计算哈希
+    static constexpr unsigned c_parallelDepth = 2;
+
+    /**
+     * 打开一棵树
+     * @param store 节点存储
+     * @param root 根，为c_emptyTrieRoot时表示空树
+     */
+    explicit Trie(TrieStore::SP store, const H256& root = c_emptyTrieRoot);
+    ~Trie();
+
+    Trie(const Trie&) = delete;
+    Trie& operator=(const Trie&) = delete;
+
+    /**
+     * 查找
+     * @param key 键
+     * @param value 值
+     * @return 键是否存在
+     * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+     */
+    bool get(BytesConstRef key, Bytes& value);
+
+    // 判断键是否存在
+    bool contains(BytesConstRef key) {
+        Bytes value;
+        return get(key, value);
+    }
+
+    /**
+     * 插入或修改（值为空时等同于删除）
+     * @param key 键
+     * @param value 值
+     * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+     */
+    void insert(BytesConstRef key, BytesConstRef value);
+
+    /**
+     * 删除
+     * @param key 键
+     * @return 键是否存在
+     * @throw 若存储中缺少节点抛出MissingTrieNode异常，节点编码不合法抛出BadTrieNode异常
+     */
+    bool remove(BytesConstRef key);
+
+    /**
+     * 计算所有脏节点的哈希，并把新节点批量写入存储
+     * @param pool 用于并行计算的线程池，为空时在当前线程计算
+     * @return 新的根
+     */
+    H256 commit(ThreadPool* pool = nullptr);
+
+    // 上次commit()（或打开时）的根
+    const H256& root() const noexcept { return m_rootHash; }
+
+    // 是否有未提交的修改
+    bool dirty() const noexcept;
+
+    struct Node;
+
+    // 子节点引用：已加载的节点，或者只有哈希（未加载），两者都没有表示空
+    struct Ref {
+        std::unique_ptr<Node> node;
+        H256 hash;
+
+        bool empty() const noexcept { return !node && !hash; }
+    };
+
+private:
+    // 获取引用指向的节点（未加载时从存储中读取）
+    Node* resolve(Ref& ref);
+
+    Ref m_root;                 // 根节点
+    H256 m_rootHash;            // 上次提交的根
+    TrieStore::SP m_store;      // 节点存储
+};
+
+}}   // namespace dev::eth
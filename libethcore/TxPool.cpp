@@ -0,0 +1,288 @@
+/**
+ * 交易池
+ * @file: TxPool.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include "TxPool.h"
+#include <libdevcore/Profiler.h>
+#include <algorithm>
+#include <queue>
+#include <exception>
+
+namespace dev { namespace eth {
+
+// 批量导入时每个并行任务处理的交易数
+static const size_t c_importGrain = 64;
+
+/**
+ * 构造交易池
+ * @param limits 容量限制
+ * @param pool 用于批量导入的线程池，为空时在当前线程导入
+ * @param nonceLookup 查询账户的下一个nonce，为空时没有排队交易的发送者从0开始
+ */
+TxPool::TxPool(const TxPoolLimits& limits, ThreadPool* pool, NonceLookup nonceLookup)
+: m_limits(limits), m_pool(pool), m_nonceLookup(std::move(nonceLookup)) {}
+
+// 导入一个交易（在当前线程验签）
+ImportResult TxPool::import(const Transaction::SP& tx) {
+    PROFILE_SCOPE("txpool.import");
+    // 先去重，重复的交易不需要验签
+    if (m_known.contains(tx->hash())) {
+        return ImportResult::c_alreadyKnown;
+    }
+    try {
+        tx->sender();
+    } catch (const std::exception&) {
+        return ImportResult::c_malformed;
+    }
+    // 查询状态在分片锁外进行
+    return insert(tx, m_nonceLookup ? m_nonceLookup(tx->sender()) : U256(0));
+}
+
+// 批量导入交易（在线程池中验签和插入），返回每个交易的导入结果
+std::vector<ImportResult> TxPool::import(const Transactions& txs) {
+    std::vector<ImportResult> ret(txs.size());
+    auto work = [this, &txs, &ret](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            ret[i] = import(txs[i]);
+        }
+    };
+    if (m_pool) {
+        m_pool->parallelFor(txs.size(), c_importGrain, work);
+    } else {
+        work(0, txs.size());
+    }
+    return ret;
+}
+
+/**
+ * 按gasPrice从高到低取出可执行的交易（同一发送者的交易保持nonce顺序）
+ * @param limit 最多取出的交易数
+ * @return 交易列表（不会从交易池中删除）
+ */
+Transactions TxPool::pending(size_t limit) const {
+    // 收集各发送者从下一个nonce开始连续的交易
+    std::vector<Transactions> runs;
+    for (const auto& shard : m_shards) {
+        Guard guard(shard.mutex);
+        for (const auto& kv : shard.senders) {
+            const SenderQueue& queue = kv.second;
+            // 有排队交易的发送者在导入时已经记录了下一个nonce
+            auto nit = shard.nonces.find(kv.first);
+            U256 next = nit != shard.nonces.end() ? nit->second : U256(0);
+
+            Transactions run;
+            for (auto it = queue.find(next); it != queue.end() && it->first == next; ++it, ++next) {
+                run.push_back(it->second);
+            }
+            if (!run.empty()) {
+                runs.push_back(std::move(run));
+            }
+        }
+    }
+
+    // 按各发送者队首交易的gasPrice多路归并
+    using Head = std::pair<U256, size_t>;    // (gasPrice, 发送者下标)
+    std::priority_queue<Head> heads;
+    std::vector<size_t> positions(runs.size(), 0);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        heads.emplace(runs[i][0]->gasPrice(), i);
+    }
+
+    Transactions ret;
+    while (ret.size() < limit && !heads.empty()) {
+        size_t i = heads.top().second;
+        heads.pop();
+        ret.push_back(runs[i][positions[i]]);
+        if (++positions[i] < runs[i].size()) {
+            heads.emplace(runs[i][positions[i]]->gasPrice(), i);
+        }
+    }
+    return ret;
+}
+
+/**
+ * 删除已上链的交易，并更新发送者的下一个nonce（nonce更小的交易也一并删除）
+ * @param txs 已上链的交易
+ */
+void TxPool::removeMined(const Transactions& txs) {
+    for (const auto& tx : txs) {
+        setNonce(tx->sender(), tx->nonce() + 1);
+    }
+}
+
+/**
+ * 设置发送者的下一个nonce，nonce更小的交易被删除（发送者没有排队的交易时不记录）
+ * @param sender 发送者
+ * @param nonce 下一个nonce
+ */
+void TxPool::setNonce(const Address& sender, const U256& nonce) {
+    Shard& shard = shardOf(sender);
+    Guard guard(shard.mutex);
+    advanceNonceLocked(shard, sender, nonce);
+}
+
+// 删除一个交易，交易不存在返回false
+bool TxPool::drop(const H256& hash) {
+    Address sender;
+    if (!m_known.tryGet(hash, sender)) {
+        return false;
+    }
+
+    Shard& shard = shardOf(sender);
+    Guard guard(shard.mutex);
+    auto sit = shard.senders.find(sender);
+    if (sit == shard.senders.end()) {
+        return false;
+    }
+    SenderQueue& queue = sit->second;
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (it->second->hash() == hash) {
+            eraseLocked(shard, queue, it);
+            removeIfEmptyLocked(shard, sender);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 记录了下一个nonce的发送者数
+size_t TxPool::nonceRecords() const {
+    size_t count = 0;
+    for (const auto& shard : m_shards) {
+        Guard guard(shard.mutex);
+        count += shard.nonces.size();
+    }
+    return count;
+}
+
+// 插入已验签的交易（stateNonce为nonceLookup查询到的下一个nonce）
+ImportResult TxPool::insert(const Transaction::SP& tx, const U256& stateNonce) {
+    const H256& hash = tx->hash();
+    const Address& sender = tx->sender();
+    const U256& nonce = tx->nonce();
+    const U256& gasPrice = tx->gasPrice();
+    size_t txBytes = tx->rlp().size();
+
+    if (!m_known.insert(hash, sender)) {
+        return ImportResult::c_alreadyKnown;
+    }
+
+    Shard& shard = shardOf(sender);
+    ImportResult ret = ImportResult::c_success;
+    {
+        Guard guard(shard.mutex);
+
+        // 有记录时以记录为准（上链后调用者的状态可能还没有更新），不会小于状态中的nonce
+        auto nit = shard.nonces.find(sender);
+        U256 next = nit != shard.nonces.end() ? std::max(nit->second, stateNonce) : stateNonce;
+        if (nonce < next) {
+            ret = ImportResult::c_nonceTooLow;
+        } else {
+            // 同nonce的交易只有gasPrice更高时才能替换（容量检查通过后才删除被替换的交易）
+            Transaction::SP replaced;
+            auto sit = shard.senders.find(sender);
+            if (sit != shard.senders.end()) {
+                auto it = sit->second.find(nonce);
+                if (it != sit->second.end()) {
+                    if (gasPrice <= it->second->gasPrice()) {
+                        ret = ImportResult::c_underpriced;
+                    } else {
+                        replaced = it->second;
+                    }
+                }
+            }
+            size_t freedCount = replaced ? 1 : 0;
+            size_t freedBytes = replaced ? replaced->rlp().size() : 0;
+
+            // 容量不足时淘汰分片中最便宜的交易（被替换的交易腾出的空间也计算在内）
+            while (ImportResult::c_success == ret &&
+                   (m_size.load(std::memory_order_relaxed) + 1 > m_limits.maxTransactions + freedCount ||
+                    m_bytes.load(std::memory_order_relaxed) + txBytes > m_limits.maxBytes + freedBytes)) {
+                if (shard.byPrice.empty()) {
+                    ret = ImportResult::c_poolFull;
+                    break;
+                }
+                PriceKey cheapest = *shard.byPrice.begin();
+                if (cheapest.gasPrice >= gasPrice || (cheapest.sender == sender && cheapest.nonce <= nonce)) {
+                    // 没有更便宜的交易，或者淘汰后新交易也无法执行（包括淘汰被替换的交易）
+                    ret = ImportResult::c_poolFull;
+                    break;
+                }
+                eraseFromLocked(shard, cheapest.sender, cheapest.nonce);
+            }
+
+            if (ImportResult::c_success == ret) {
+                if (replaced) {
+                    SenderQueue& queue = shard.senders[sender];
+                    eraseLocked(shard, queue, queue.find(nonce));
+                }
+                shard.senders[sender].emplace(nonce, tx);
+                shard.nonces[sender] = next;
+                shard.byPrice.insert(PriceKey{gasPrice, hash, sender, nonce});
+                m_size.fetch_add(1, std::memory_order_relaxed);
+                m_bytes.fetch_add(txBytes, std::memory_order_relaxed);
+            } else {
+                removeIfEmptyLocked(shard, sender);
+            }
+        }
+    }
+
+    if (ImportResult::c_success != ret) {
+        m_known.erase(hash);
+    }
+    return ret;
+}
+
+// 持有分片锁时删除一个交易，返回下一个交易（调用者负责清理空的发送者队列）
+TxPool::SenderQueue::iterator TxPool::eraseLocked(Shard& shard, SenderQueue& queue, SenderQueue::iterator it) {
+    const Transaction::SP& tx = it->second;
+    shard.byPrice.erase(PriceKey{tx->gasPrice(), tx->hash(), Address(), U256()});
+    m_known.erase(tx->hash());
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+    m_bytes.fetch_sub(tx->rlp().size(), std::memory_order_relaxed);
+    return queue.erase(it);
+}
+
+// 持有分片锁时清理空的发送者队列（连同nonce记录，之后再导入时通过nonceLookup查询）
+void TxPool::removeIfEmptyLocked(Shard& shard, const Address& sender) {
+    auto sit = shard.senders.find(sender);
+    if (sit != shard.senders.end() && sit->second.empty()) {
+        shard.senders.erase(sit);
+        shard.nonces.erase(sender);
+    }
+}
+
+// 持有分片锁时删除发送者nonce不小于from的交易
+void TxPool::eraseFromLocked(Shard& shard, const Address& sender, const U256& from) {
+    auto sit = shard.senders.find(sender);
+    if (sit == shard.senders.end()) {
+        return;
+    }
+    SenderQueue& queue = sit->second;
+    for (auto it = queue.lower_bound(from); it != queue.end();) {
+        it = eraseLocked(shard, queue, it);
+    }
+    removeIfEmptyLocked(shard, sender);
+}
+
+// 持有分片锁时删除发送者nonce小于nonce的交易，并记录下一个nonce
+void TxPool::advanceNonceLocked(Shard& shard, const Address& sender, const U256& nonce) {
+    // 发送者没有排队的交易时不记录（之后导入时从状态中查询），内存只随排队的交易增长
+    auto sit = shard.senders.find(sender);
+    if (sit == shard.senders.end()) {
+        return;
+    }
+    U256& next = shard.nonces[sender];
+    if (next < nonce) {
+        next = nonce;
+    }
+    SenderQueue& queue = sit->second;
+    for (auto it = queue.begin(); it != queue.end() && it->first < nonce;) {
+        it = eraseLocked(shard, queue, it);
+    }
+    removeIfEmptyLocked(shard, sender);
+}
+
+}}   // namespace dev::eth
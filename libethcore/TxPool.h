@@ -0,0 +1,168 @@
+/**
+ * 交易池
+ * @file: TxPool.h
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/FlatHashMap.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
+#include "Transaction.h"
+
+namespace dev { namespace eth {
+
+// 交易导入结果
+enum class ImportResult {
+    c_success,          // 导入成功
+    c_alreadyKnown,     // 交易已存在
+    c_malformed,        // 编码不合法或签名错误
+    c_nonceTooLow,      // nonce已被使用
+    c_underpriced,      // 与已有的同nonce交易相比gasPrice不够高
+    c_poolFull          // 交易池已满，并且没有更便宜的交易可以淘汰
+};
+
+// 交易池容量限制
+struct TxPoolLimits {
+    size_t maxTransactions = 100000;        // 最大交易数
+    size_t maxBytes = 128 * 1024 * 1024;    // 交易编码的最大总字节数
+};
+
+/**
+ * 交易池的状态按发送者地址分片，每个分片一把锁，不同发送者的交易可以并发导入：
+ * 1. 每个发送者的交易按nonce排序，同nonce的交易只有gasPrice更高时才能替换
+ * 2. 按交易哈希去重（独立的并发哈希表，也按哈希分片加锁）
+ * 3. 每个分片维护按gasPrice排序的索引，交易池满时淘汰新交易所在分片中最便宜的交易
+ *    （连同该发送者nonce更大的交易，它们已经无法执行），各分片的哈希分布均匀，近似于全局淘汰
+ * 4. 打包时合并各分片中可执行的交易（从发送者的下一个nonce开始连续的交易），按gasPrice从高到低取出，
+ *    同一发送者的交易保持nonce顺序
+ * 5. 发送者的下一个nonce只在它有排队的交易时记录（内存随排队的交易数有界），导入没有记录的发送者的交易时
+ *    通过调用者提供的查询函数从世界状态中读取（没有提供时为0），因此已上链的交易不能再次导入
+ * 批量导入时验签和插入都交给线程池并行执行（恢复的发送者缓存在交易对象中）。
+ * 容量限制用原子计数器检查，并发导入时可能略微超出
+ */
+class TxPool {
+public:
+    /**
+     * 查询账户在世界状态中的下一个nonce（在导入线程中调用，不持有交易池的锁，不能抛出异常）
+     * 区块上链后状态中的nonce已经增加，已上链的交易再次导入时返回c_nonceTooLow
+     */
+    using NonceLookup = std::function<U256(const Address&)>;
+
+    // 分片数
+    static constexpr unsigned c_shardBits = 4;
+    static constexpr size_t c_shardCount = size_t(1) << c_shardBits;
+
+    /**
+     * 构造交易池
+     * @param limits 容量限制
+     * @param pool 用于批量导入的线程池，为空时在当前线程导入
+     * @param nonceLookup 查询账户的下一个nonce，为空时没有排队交易的发送者从0开始
+     */
+    explicit TxPool(const TxPoolLimits& limits = TxPoolLimits(), ThreadPool* pool = nullptr,
+        NonceLookup nonceLookup = NonceLookup());
+
+    TxPool(const TxPool&) = delete;
+    TxPool& operator=(const TxPool&) = delete;
+
+    // 导入一个交易（在当前线程验签）
+    ImportResult import(const Transaction::SP& tx);
+
+    // 批量导入交易（在线程池中验签和插入），返回每个交易的导入结果
+    std::vector<ImportResult> import(const Transactions& txs);
+
+    /**
+     * 按gasPrice从高到低取出可执行的交易（同一发送者的交易保持nonce顺序）
+     * @param limit 最多取出的交易数
+     * @return 交易列表（不会从交易池中删除）
+     */
+    Transactions pending(size_t limit) const;
+
+    /**
+     * 删除已上链的交易，并更新发送者的下一个nonce（nonce更小的交易也一并删除）
+     * @param txs 已上链的交易
+     */
+    void removeMined(const Transactions& txs);
+
+    /**
+     * 设置发送者的下一个nonce，nonce更小的交易被删除
+     * （发送者没有排队的交易时不记录，之后导入时通过nonceLookup查询）
+     * @param sender 发送者
+     * @param nonce 下一个nonce
+     */
+    void setNonce(const Address& sender, const U256& nonce);
+
+    // 删除一个交易，交易不存在返回false
+    bool drop(const H256& hash);
+
+    // 判断交易是否存在
+    bool contains(const H256& hash) const { return m_known.contains(hash); }
+
+    // 交易数和交易编码总字节数
+    size_t size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+    size_t bytes() const noexcept { return m_bytes.load(std::memory_order_relaxed); }
+
+    // 记录了下一个nonce的发送者数（只有有排队交易的发送者才有记录）
+    size_t nonceRecords() const;
+
+private:
+    // 按gasPrice排序的索引项
+    struct PriceKey {
+        U256 gasPrice;
+        H256 hash;
+        Address sender;
+        U256 nonce;
+
+        bool operator<(const PriceKey& rhs) const {
+            return gasPrice != rhs.gasPrice ? gasPrice < rhs.gasPrice : hash < rhs.hash;
+        }
+    };
+
+    // 一个发送者的交易（按nonce排序）
+    using SenderQueue = std::map<U256, Transaction::SP>;
+
+    // 分片（按缓存行对齐，避免伪共享）
+    struct alignas(64) Shard {
+        mutable Mutex mutex;
+        FlatHashMap<20, SenderQueue> senders;   // 各发送者的交易
+        FlatHashMap<20, U256> nonces;           // 有排队交易的发送者的下一个nonce（队列清空时删除）
+        std::set<PriceKey> byPrice;             // 按gasPrice排序的索引
+    };
+
+    // 用发送者地址的哈希值最高几位选择分片
+    Shard& shardOf(const Address& sender) { return m_shards[Address::hash()(sender) >> (64 - c_shardBits)]; }
+
+    // 插入已验签的交易（stateNonce为nonceLookup查询到的下一个nonce）
+    ImportResult insert(const Transaction::SP& tx, const U256& stateNonce);
+
+    // 持有分片锁时删除一个交易，返回下一个交易（调用者负责清理空的发送者队列）
+    SenderQueue::iterator eraseLocked(Shard& shard, SenderQueue& queue, SenderQueue::iterator it);
+
+    // 持有分片锁时清理空的发送者队列（连同nonce记录）
+    void removeIfEmptyLocked(Shard& shard, const Address& sender);
+
+    // 持有分片锁时删除发送者nonce不小于from的交易
+    void eraseFromLocked(Shard& shard, const Address& sender, const U256& from);
+
+    // 持有分片锁时删除发送者nonce小于nonce的交易，并记录下一个nonce
+    void advanceNonceLocked(Shard& shard, const Address& sender, const U256& nonce);
+
+    TxPoolLimits m_limits;                          // 容量限制
+    ThreadPool* m_pool;                             // 线程池
+    NonceLookup m_nonceLookup;                      // 查询账户的下一个nonce
+    std::array<Shard, c_shardCount> m_shards;       // 分片
+    ConcurrentFlatHashMap<32, Address> m_known;     // 交易哈希->发送者
+    std::atomic<size_t> m_size{0};                  // 交易数
+    std::atomic<size_t> m_bytes{0};                 // 交易编码总字节数
+};
+
+}}   // namespace dev::eth
@@ -0,0 +1,41 @@
+/**
+ * 没有libFuzzer时模糊测试程序的入口
+ * @file: FuzzMain.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+// 运行一个样本
+static void runOne(std::istream& in) {
+    std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+/**
+ * 依次运行参数指定的样本文件，没有参数时从标准输入读取一个样本
+ * 用于复现libFuzzer发现的崩溃，或交给AFL运行：afl-fuzz -i seeds -o findings -- ./fuzz-RLPFuzzer @@
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        runOne(std::cin);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file) {
+            std::cerr << "Can't open " << argv[i] << std::endl;
+            return 1;
+        }
+        runOne(file);
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * RLP校验与解析的模糊测试
+ * @file: RLPFuzzer.cpp
+ * @author: rancheng <rc4work@163.com>
+ * @date: 2026-10-18
+ */
+#include <libdevcore/RLP.h>
+#include <cstdlib>
+
+using namespace dev;
+
+/**
+ * 递归解析并重新编码
+ * @return 嵌套层数超过depth时返回false（不再比较校验结果）
+ * @throw 若数据项不合法抛出BadRLP异常
+ */
+static bool reencode(const RLP& item, RLPStream& s, size_t depth) {
+    if (item.isData()) {
+        s << item.payload();
+        return true;
+    }
+    if (0 == depth) {
+        return false;
+    }
+
+    std::vector<RLP> items = item.splitList();
+    s.appendList(items.size());
+    for (const auto& i : items) {
+        if (!reencode(i, s, depth - 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 对比validateRLP()与RLP解析的结果：
+ * 1. 校验通过的输入可以完整解析，重新编码后与输入完全相同（最短编码是唯一的）
+ * 2. 解析失败的输入校验不能通过
+ * 不一致时abort()
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    BytesConstRef in(data, size);
+
+    // 默认限制下的校验（时间与输入长度成线性关系，不能崩溃）
+    validateRLP(in);
+
+    // 只限制嵌套层数，与递归解析的结果对比
+    RLPLimits limits;
+    limits.maxDepth = RLPLimits::c_maxDepth;
+    RLPValidity validity = validateRLP(in, limits);
+    if (0 == size || RLPValidity::c_tooDeep == validity) {
+        return 0;
+    }
+
+    RLPStream s;
+    try {
+        if (!reencode(RLP(in), s, RLPLimits::c_maxDepth)) {
+            abort();
+        }
+    } catch (const BadRLP&) {
+        if (RLPValidity::c_valid == validity) {
+            abort();
+        }
+        return 0;
+    }
+
+    if (RLPValidity::c_valid != validity || s.peek() != Bytes(data, data + size)) {
+        abort();
+    }
+    return 0;
+}
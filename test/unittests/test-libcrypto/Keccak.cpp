@@ -1,5 +1,6 @@
 #include <boost/test/unit_test.hpp>
 #include <libcrypto/Keccak.h>
+#include <libdevcore/Metrics.h>
 
 namespace dev { namespace test {
 
@@ -16,6 +17,12 @@ BOOST_AUTO_TEST_CASE(keccak256Test)
     // 长字符串 > blockSize=136
     std::string longStr(200, 'r');
     BOOST_CHECK(keccak256(longStr).hex() == "aac9a41d73145d4163a16b74db2e559b49158aac08932f04ed58db939c303c0d");
+
+    // 哈希的字节数计入指标（指标在静态初始化时已经注册）
+    auto& bytes = MetricsRegistry::instance().counter("crypto_keccak256_bytes_total", "Bytes hashed by Keccak-256");
+    uint64_t before = bytes.value();
+    keccak256(longStr);
+    BOOST_CHECK_EQUAL(bytes.value() - before, 200);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
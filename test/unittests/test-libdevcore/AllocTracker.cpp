@@ -0,0 +1,88 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/AllocTracker.h>
+#include <libdevcore/Metrics.h>
+#include <memory>
+#include <string>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(AllocTrackerTests)
+
+BOOST_AUTO_TEST_CASE(allocScopeTest)
+{
+    BOOST_CHECK_EQUAL(allocTagName(AllocTag::Other), "other");
+    BOOST_CHECK_EQUAL(allocTagName(AllocTag::Compression), "compression");
+
+    // 作用域嵌套，退出时恢复之前的子系统
+    BOOST_CHECK(currentAllocTag() == AllocTag::Other);
+    {
+        AllocScope rlp(AllocTag::RLP);
+        BOOST_CHECK(currentAllocTag() == AllocTag::RLP);
+        {
+            AllocScope pool(AllocTag::Pool);
+            BOOST_CHECK(currentAllocTag() == AllocTag::Pool);
+        }
+        BOOST_CHECK(currentAllocTag() == AllocTag::RLP);
+    }
+    BOOST_CHECK(currentAllocTag() == AllocTag::Other);
+}
+
+BOOST_AUTO_TEST_CASE(trackingTest)
+{
+    const size_t size = 4 << 20;
+    AllocSnapshot before = AllocTracker::snapshot();
+    std::unique_ptr<Bytes> bytes;
+    {
+        AllocScope scope(AllocTag::Compression);
+        bytes.reset(new Bytes(size));
+    }
+    AllocSnapshot during = AllocTracker::snapshot();
+    // 其它子系统分配的内存也可以在作用域之外释放，仍然计入分配时的子系统
+    bytes.reset();
+    AllocSnapshot after = AllocTracker::snapshot();
+
+    auto& c0 = before.tags[static_cast<size_t>(AllocTag::Compression)];
+    auto& c1 = during.tags[static_cast<size_t>(AllocTag::Compression)];
+    auto& c2 = after.tags[static_cast<size_t>(AllocTag::Compression)];
+    if (!AllocTracker::enabled()) {
+        BOOST_CHECK(c2.allocations == 0 && after.total.allocatedBytes == 0);
+        BOOST_CHECK(AllocTracker::topSites(10).empty());
+        return;
+    }
+
+    BOOST_CHECK(c1.allocations - c0.allocations >= 2);
+    BOOST_CHECK(c1.allocatedBytes - c0.allocatedBytes >= size);
+    BOOST_CHECK(c1.liveBytes() - c0.liveBytes() >= static_cast<int64_t>(size));
+    BOOST_CHECK(c1.peakBytes >= size);
+    BOOST_CHECK(c2.freedBytes - c1.freedBytes >= size);
+    BOOST_CHECK(c2.liveBytes() == c0.liveBytes());
+    BOOST_CHECK(after.total.allocatedBytes - before.total.allocatedBytes >= size);
+
+    // 超过采样间隔的分配一定会被采样
+    auto sites = AllocTracker::topSites(100);
+    BOOST_REQUIRE(!sites.empty());
+    bool found = false;
+    for (auto& site : sites) {
+        found |= site.bytes >= size && !site.frames.empty();
+    }
+    BOOST_CHECK(found);
+
+    std::string text = AllocTracker::toText(after, &before, sites);
+    BOOST_CHECK(text.find("compression") != std::string::npos);
+    BOOST_CHECK(text.find("site #1") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(publishTest)
+{
+    AllocSnapshot now = AllocTracker::snapshot();
+    AllocTracker::publish(now, AllocSnapshot());
+    std::string text = MetricsRegistry::instance().toPrometheus();
+    BOOST_CHECK(text.find("memory_live_bytes{subsystem=\"rlp\"}") != std::string::npos);
+    BOOST_CHECK(text.find("memory_total_peak_bytes") != std::string::npos);
+    BOOST_CHECK(MetricsRegistry::instance().counter("memory_allocated_bytes_total", "",
+        {{"subsystem", "other"}}).value() >= now.tags[0].allocatedBytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,146 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/Arena.h>
+#include <libdevcore/RLP.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(ArenaTests)
+
+BOOST_AUTO_TEST_CASE(allocateTest)
+{
+    Arena arena(1024);
+    BOOST_CHECK_EQUAL(arena.used(), 0);
+    BOOST_CHECK_EQUAL(arena.capacity(), 0);
+
+    // 对齐
+    void* a = arena.allocate(1, 1);
+    void* b = arena.allocate(8, 64);
+    void* c = arena.allocate(3);
+    BOOST_CHECK(a != nullptr);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(b) % 64, 0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(c) % alignof(std::max_align_t), 0);
+    BOOST_CHECK(arena.used() >= 12);
+    BOOST_CHECK_EQUAL(arena.capacity(), 1024);
+
+    // 超出当前内存块时分配新的内存块
+    for (int i = 0; i < 100; ++i) {
+        std::memset(arena.allocate(100), i, 100);
+    }
+    size_t capacity = arena.capacity();
+    BOOST_CHECK(capacity > 1024);
+
+    // reset后复用已有的内存块
+    arena.reset();
+    BOOST_CHECK_EQUAL(arena.used(), 0);
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate(100);
+    }
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(largeTest)
+{
+    Arena arena;
+    arena.allocate(16);
+    size_t capacity = arena.capacity();
+
+    // 大对象单独分配，rewind时还给系统
+    Arena::Marker marker = arena.mark();
+    Byte* p = static_cast<Byte*>(arena.allocate(Arena::c_maxChunkSize * 2));
+    std::memset(p, 0xab, Arena::c_maxChunkSize * 2);
+    size_t large = arena.capacity();
+    BOOST_CHECK(large >= capacity + Arena::c_maxChunkSize * 2);
+
+    // 大对象不影响当前内存块的剩余空间
+    arena.allocate(16);
+    BOOST_CHECK_EQUAL(arena.capacity(), large);
+
+    arena.rewind(marker);
+    BOOST_CHECK_EQUAL(arena.capacity(), capacity);
+    BOOST_CHECK_EQUAL(arena.used(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(scopeTest)
+{
+    BOOST_CHECK(ArenaScope::current() == nullptr);
+    Arena& arena = threadArena();
+    size_t used = arena.used();
+    {
+        BlockArenaScope block;
+        BOOST_CHECK(ArenaScope::current() == &arena);
+        ArenaBytes bytes(1000, 1);
+        BOOST_CHECK(bytes.get_allocator().arena() == &arena);
+        BOOST_CHECK(arena.used() >= used + 1000);
+
+        // 嵌套的作用域结束时只释放自己分配的内存
+        size_t outer = arena.used();
+        {
+            BlockArenaScope inner;
+            ArenaString str(5000, 'x');
+            BOOST_CHECK(arena.used() >= outer + 5000);
+        }
+        BOOST_CHECK_EQUAL(arena.used(), outer);
+        BOOST_CHECK(ArenaScope::current() == &arena);
+        BOOST_CHECK_EQUAL(bytes[999], 1);
+    }
+    BOOST_CHECK(ArenaScope::current() == nullptr);
+    BOOST_CHECK_EQUAL(arena.used(), used);
+}
+
+BOOST_AUTO_TEST_CASE(allocatorTest)
+{
+    // 没有安装Arena时使用operator new/delete
+    ArenaVector<int> heap(10, 7);
+    BOOST_CHECK(heap.get_allocator().arena() == nullptr);
+
+    Arena arena;
+    ArenaVector<std::string> strings{ArenaAllocator<std::string>(arena)};
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::to_string(i));
+    }
+    BOOST_CHECK_EQUAL(strings[42], "42");
+    BOOST_CHECK(arena.used() >= 100 * sizeof(std::string));
+
+    // 作用域外复制容器，结果不再引用Arena
+    ArenaVector<std::string> copy(strings);
+    BOOST_CHECK(copy.get_allocator().arena() == nullptr);
+    BOOST_CHECK(copy == strings);
+
+    ArenaAllocator<int> a(arena);
+    ArenaAllocator<double> b(a);
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != ArenaAllocator<int>());
+}
+
+BOOST_AUTO_TEST_CASE(rlpTest)
+{
+    RLPStream s;
+    s.appendList(3) << "dog" << 1024u << Bytes(100, 0x11);
+    Bytes expected = s.take();
+
+    Arena arena;
+    ArenaRLPStream as{ArenaAllocator<Byte>(arena)};
+    as.appendList(3) << "dog" << 1024u << Bytes(100, 0x11);
+    ArenaBytes out = as.take();
+    BOOST_CHECK(out.get_allocator().arena() == &arena);
+    BOOST_CHECK(Bytes(out.begin(), out.end()) == expected);
+
+    RLP rlp(expected);
+    ArenaVector<RLP> items = rlp.splitList(arena);
+    BOOST_REQUIRE_EQUAL(items.size(), 3);
+    BOOST_CHECK(items.get_allocator().arena() == &arena);
+    BOOST_CHECK_EQUAL(items[0].toString(), "dog");
+    BOOST_CHECK_EQUAL(items[1].toInt<unsigned>(), 1024);
+
+    ArenaBytes payload = items[2].toBytes(arena);
+    BOOST_CHECK(Bytes(payload.begin(), payload.end()) == Bytes(100, 0x11));
+    BOOST_CHECK_THROW(items[0].splitList(arena), RLPBadCast);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
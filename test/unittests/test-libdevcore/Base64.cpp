@@ -131,6 +131,16 @@ BOOST_AUTO_TEST_CASE(fromBase64Test)
     BOOST_CHECK_THROW(fromBase64URL(str3Fault3URL), BadBase64Ch);
 }
 
+BOOST_AUTO_TEST_CASE(fromBase64ViewTest)
+{
+    // 从字符串视图解码，不需要先复制成std::string
+    std::string buffer = "[aGVsbG8gYmFzZTY0]";
+    std::string_view view(buffer.data() + 1, buffer.size() - 2);
+    BOOST_CHECK(BytesConstRef(fromBase64Std(view)).toString() == "hello base64");
+    BOOST_CHECK(BytesConstRef(fromBase64URL(view)).toString() == "hello base64");
+    BOOST_CHECK_THROW(fromBase64Std(std::string_view(buffer)), BadBase64Ch);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}   // namespace dev::test
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/CRC32C.h>
+#include <string>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(CRC32CTests)
+
+BOOST_AUTO_TEST_CASE(crc32cTest)
+{
+    // RFC 3720附录B.4的测试向量
+    BOOST_CHECK(crc32c(BytesConstRef()) == 0);
+    BOOST_CHECK(crc32c("123456789") == 0xe3069283);
+    Bytes zeros(32, 0x00);
+    BOOST_CHECK(crc32c(zeros) == 0x8a9136aa);
+    Bytes ones(32, 0xff);
+    BOOST_CHECK(crc32c(ones) == 0x62a8ab43);
+    Bytes inc(32);
+    for (size_t i = 0; i < inc.size(); ++i) {
+        inc[i] = static_cast<Byte>(i);
+    }
+    BOOST_CHECK(crc32c(inc) == 0x46dd794e);
+
+    // 分段计算与整体计算结果相同
+    std::string text(1000, 'x');
+    for (size_t i = 0; i < text.size(); ++i) {
+        text[i] = static_cast<char>(i * 31 + 7);
+    }
+    BytesConstRef all(text);
+    uint32_t whole = crc32c(all);
+    for (size_t split : {0, 1, 7, 8, 9, 500, 999, 1000}) {
+        BOOST_CHECK(crc32c(all.cropped(split), crc32c(all.cropped(0, split))) == whole);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
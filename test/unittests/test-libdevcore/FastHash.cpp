@@ -0,0 +1,78 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/FastHash.h>
+#include <libdevcore/FixedBytes.h>
+#include <string>
+#include <set>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(FastHashTests)
+
+BOOST_AUTO_TEST_CASE(fastHashTest)
+{
+    // 相同输入和种子得到相同的哈希值
+    std::string str = "hello";
+    BytesConstRef ref(str);
+    BOOST_CHECK(fastHash(ref.data(), ref.size(), 1) == fastHash(ref.data(), ref.size(), 1));
+    BOOST_CHECK(fastHash(ref) == fastHash(ref.data(), ref.size(), c_hashSeed));
+
+    // 种子不同哈希值不同
+    BOOST_CHECK(fastHash(ref.data(), ref.size(), 1) != fastHash(ref.data(), ref.size(), 2));
+
+    // 覆盖各个长度分支（0，1-3，4-16，17-48，大于48），前缀相同的输入哈希值都不同
+    std::string longStr(200, 'r');
+    std::set<uint64_t> hashes;
+    for (size_t len = 0; len <= longStr.size(); ++len) {
+        hashes.insert(fastHash(reinterpret_cast<const Byte*>(longStr.data()), len, 1));
+    }
+    BOOST_CHECK(hashes.size() == longStr.size() + 1);
+
+    // 只有一位不同的输入哈希值不同
+    H2048 bloom1, bloom2;
+    bloom2[100] = 0x01;
+    BOOST_CHECK(fastHash(bloom1.ref()) != fastHash(bloom2.ref()));
+}
+
+BOOST_AUTO_TEST_CASE(uniformHashTest)
+{
+    // 均匀分布的键
+    auto h1 = H256::random();
+    auto h2 = h1;
+    h2[0] ^= 0x01;
+    BOOST_CHECK(uniformHash(h1.data(), h1.size(), 1) == uniformHash(h1.data(), h1.size(), 1));
+    BOOST_CHECK(uniformHash(h1.data(), h1.size(), 1) != uniformHash(h2.data(), h2.size(), 1));
+    BOOST_CHECK(uniformHash(h1.data(), h1.size(), 1) != uniformHash(h1.data(), h1.size(), 2));
+
+    // 只在中间的字节上不同的键在任何种子下都不能碰撞
+    H256 m1 = H256::random();
+    H512 w1 = H512::random();
+    H160 a1 = H160::random();
+    for (size_t i = 8; i < 24; ++i) {
+        H256 m2 = m1;
+        m2[i] ^= 0x80;
+        BOOST_CHECK(uniformHash(m1.data(), 32, c_hashSeed) != uniformHash(m2.data(), 32, c_hashSeed));
+        BOOST_CHECK(uniformHash(m1.data(), 32, i) != uniformHash(m2.data(), 32, i));
+    }
+    for (size_t i = 8; i < 56; ++i) {
+        H512 w2 = w1;
+        w2[i] ^= 0x01;
+        BOOST_CHECK(uniformHash(w1.data(), 64, c_hashSeed) != uniformHash(w2.data(), 64, c_hashSeed));
+    }
+    for (size_t i = 0; i < 20; ++i) {
+        H160 a2 = a1;
+        a2[i] ^= 0x01;
+        BOOST_CHECK(uniformHash(a1.data(), 20, c_hashSeed) != uniformHash(a2.data(), 20, c_hashSeed));
+    }
+
+    // 哈希值的低位也要分布均匀（哈希表通常用低位做下标）
+    std::set<uint64_t> buckets;
+    for (int i = 0; i < 1000; ++i) {
+        auto h = H160::random();
+        buckets.insert(uniformHash(h.data(), h.size(), c_hashSeed) & 0xff);
+    }
+    BOOST_CHECK(buckets.size() > 200);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -47,6 +47,14 @@ BOOST_AUTO_TEST_CASE(constructorTest)
     BOOST_CHECK(h2.hex0x() == "0x0000000000000000000000000000000f170d8e0ae1b57d7ecc121f6fe5ceb03c");
     BOOST_CHECK(h2.toArith() == u2);
 
+    // 字符串视图构造
+    std::string buffer = "hash:0x1234567890;";
+    FixedBytes<5> fromHexView(std::string_view(buffer.data() + 5, 12));
+    BOOST_CHECK(fromHexView == fromHexStr);
+    FixedBytes<5> fromHexViewLeft(std::string_view("0x123456"), Align::c_left);
+    BOOST_CHECK(fromHexViewLeft == fromHexStrLeft1);
+    BOOST_CHECK_THROW(FixedBytes<5>(std::string_view("0x12345678zz")), BadHexCh);
+
     // 没有对齐
     BOOST_CHECK_THROW(FixedBytes<5>("0x123456"), Unaligned);
     BOOST_CHECK_THROW(FixedBytes<5>("0x1234567890abcd"), Unaligned);
@@ -120,6 +128,10 @@ BOOST_AUTO_TEST_CASE(hashTest)
     auto h8 = H2048::random();
     BOOST_CHECK(std::hash<H2048>()(h7) == std::hash<H2048>()(h7));
     BOOST_CHECK(std::hash<H2048>()(h7) != std::hash<H2048>()(h8));
+
+    // 可以指定哈希种子
+    BOOST_CHECK(H256::hash(1)(h3) == H256::hash(1)(h3));
+    BOOST_CHECK(H256::hash(1)(h3) != H256::hash(2)(h3));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
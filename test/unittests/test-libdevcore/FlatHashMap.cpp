@@ -0,0 +1,148 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/FlatHashMap.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(FlatHashMapTests)
+
+BOOST_AUTO_TEST_CASE(mapTest)
+{
+    FlatHashMap<32, std::string> m;
+    BOOST_CHECK(m.empty());
+    BOOST_CHECK(m.find(H256()) == m.end());
+
+    // 插入与查找
+    H256 k1("0xf170d8e0ae1b57d7ecc121f6fe5ceb03c1267801ff720edd2f8463e7effac6c6");
+    BOOST_CHECK(m.emplace(k1, "hello").second);
+    BOOST_CHECK(!m.emplace(k1, "world").second);
+    BOOST_CHECK(m.size() == 1);
+    BOOST_CHECK(m.at(k1) == "hello");
+    BOOST_CHECK(m.insertOrAssign(k1, std::string("world")).second == false);
+    BOOST_CHECK(m[k1] == "world");
+    BOOST_CHECK_THROW(m.at(H256()), OutOfRange);
+
+    // 异构查找
+    BOOST_CHECK(m.find(k1.ref()) != m.end());
+    BOOST_CHECK(m.count(k1.ref().cropped(1)) == 0);
+
+    // 删除
+    BOOST_CHECK(m.erase(k1) == 1);
+    BOOST_CHECK(m.erase(k1) == 0);
+    BOOST_CHECK(m.empty());
+}
+
+BOOST_AUTO_TEST_CASE(growTest)
+{
+    // 和std::unordered_map对比，覆盖扩容，删除，墓碑复用等情况
+    FlatHashMap<20, int> m;
+    std::unordered_map<H160, int> expected;
+    H160s keys;
+    for (int i = 0; i < 10000; ++i) {
+        keys.push_back(H160::random());
+        m[keys.back()] = i;
+        expected[keys.back()] = i;
+    }
+    for (int i = 0; i < 10000; i += 2) {
+        BOOST_CHECK(m.erase(keys[i]) == 1);
+        expected.erase(keys[i]);
+    }
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back(H160::random());
+        m.emplace(keys.back(), i);
+        expected.emplace(keys.back(), i);
+    }
+    BOOST_CHECK(m.size() == expected.size());
+    for (const auto& kv : expected) {
+        auto it = m.find(kv.first);
+        BOOST_REQUIRE(it != m.end());
+        BOOST_CHECK(it->second == kv.second);
+    }
+    size_t n = 0;
+    for (const auto& kv : m) {
+        BOOST_CHECK(expected.at(kv.first) == kv.second);
+        ++n;
+    }
+    BOOST_CHECK(n == expected.size());
+
+    // 拷贝和移动
+    FlatHashMap<20, int> copied(m);
+    BOOST_CHECK(copied.size() == m.size());
+    BOOST_CHECK(copied.at(keys.back()) == m.at(keys.back()));
+    FlatHashMap<20, int> moved(std::move(copied));
+    BOOST_CHECK(moved.size() == m.size());
+    BOOST_CHECK(copied.empty());
+
+    // 清空后仍可使用
+    m.clear();
+    BOOST_CHECK(m.empty());
+    BOOST_CHECK(m.find(keys.back()) == m.end());
+    m[keys.back()] = 1;
+    BOOST_CHECK(m.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(reserveTest)
+{
+    FlatHashMap<32, int> m;
+    m.reserve(1000);
+    size_t cap = m.capacity();
+    BOOST_CHECK(cap >= 1000);
+    for (int i = 0; i < 1000; ++i) {
+        m.emplace(H256::random(), i);
+    }
+    // 预留空间足够，不会扩容
+    BOOST_CHECK(m.capacity() == cap);
+    m.rehash(cap * 4);
+    BOOST_CHECK(m.capacity() >= cap * 4);
+    BOOST_CHECK(m.size() == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(setTest)
+{
+    FlatHashSet<32> s;
+    auto h1 = H256::random();
+    BOOST_CHECK(s.insert(h1).second);
+    BOOST_CHECK(!s.insert(h1).second);
+    BOOST_CHECK(s.contains(h1));
+    BOOST_CHECK(s.contains(h1.ref()));
+    BOOST_CHECK(*s.begin() == h1);
+    s.erase(s.begin());
+    BOOST_CHECK(s.empty());
+}
+
+BOOST_AUTO_TEST_CASE(concurrentTest)
+{
+    ConcurrentFlatHashMap<20, int> m;
+    m.reserve(4000);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&m] {
+            for (int i = 0; i < 1000; ++i) {
+                m.insert(H160::random(), i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    BOOST_CHECK(m.size() == 4000);
+
+    H160 k = H160::random();
+    int v = 0;
+    BOOST_CHECK(!m.tryGet(k, v));
+    m.update(k, [](int& x) { x += 2; });
+    BOOST_CHECK(m.tryGet(k, v) && v == 2);
+    BOOST_CHECK(m.erase(k));
+    BOOST_CHECK(!m.contains(k));
+
+    size_t n = 0;
+    m.forEach([&n](const H160&, int) { ++n; });
+    BOOST_CHECK(n == 4000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
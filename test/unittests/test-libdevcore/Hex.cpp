@@ -42,6 +42,26 @@ BOOST_AUTO_TEST_CASE(fromHexTest)
     // 非法字符
     BOOST_CHECK_THROW(fromHex("0xabcdefg"), BadHexCh);
     BOOST_CHECK_THROW(fromHex("0xg"), BadHexCh);
+
+    // 输出到SmallBytes
+    SmallBytes sb;
+    fromHex(toHex0x(bs), sb);
+    BOOST_CHECK(sb.isInline());
+    BOOST_CHECK(sb.toBytes() == bs);
+    BOOST_CHECK_THROW(fromHex("0xabcdefg", sb), BadHexCh);
+
+    // 从字符串视图解码（直接引用网络缓冲区中的一段）
+    std::string buffer = "key=0x1234567890abcdef;";
+    std::string_view hexView(buffer.data() + 4, 18);
+    BOOST_CHECK(hexDecodedSize(hexView) == 8);
+    BOOST_CHECK(bs == fromHex(hexView));
+
+    // 输出到调用方提供的内存
+    Byte out[8];
+    fromHex(hexView, BytesRef(out, sizeof(out)));
+    BOOST_CHECK(bs == Bytes(out, out + sizeof(out)));
+    BOOST_CHECK_THROW(fromHex(hexView, BytesRef(out, 7)), OutOfRange);
+    BOOST_CHECK_THROW(fromHex("0xzz", BytesRef(out, 1)), BadHexCh);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
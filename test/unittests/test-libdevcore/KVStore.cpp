@@ -0,0 +1,134 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/KVStore.h>
+#include <string>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(KVStoreTests)
+
+BOOST_AUTO_TEST_CASE(memoryKVStoreTest)
+{
+    MemoryKVStore store;
+    Bytes value;
+
+    // 单个键值的读写删除
+    BOOST_CHECK(!store.get("a", value));
+    store.put("a", "1");
+    BOOST_CHECK(store.get("a", value) && value == Bytes{'1'});
+    store.put("a", "2");
+    BOOST_CHECK(store.get("a", value) && value == Bytes{'2'});
+    store.put("empty", "");
+    BOOST_CHECK(store.get("empty", value) && value.empty());
+    store.remove("a");
+    BOOST_CHECK(!store.contains("a"));
+    BOOST_CHECK(store.size() == 1);
+
+    // 批量写入，同一个键以最后一次操作为准
+    WriteBatch batch;
+    batch.put("acc/1", "x");
+    batch.put("acc/2", "y");
+    batch.put("acc/3", "z");
+    batch.remove("acc/3");
+    batch.put("blk/1", "b");
+    batch.put("acc/1", "x1");
+    BOOST_CHECK(batch.size() == 6);
+    store.write(batch);
+    BOOST_CHECK(store.size() == 4);
+    BOOST_CHECK(store.get("acc/1", value) && (value == Bytes{'x', '1'}));
+    BOOST_CHECK(!store.contains("acc/3"));
+
+    // 前缀遍历（按键排序，可以提前停止）
+    std::string keys;
+    store.forEach("acc/", [&](BytesConstRef key, BytesConstRef) {
+        keys += key.toString() + ",";
+        return true;
+    });
+    BOOST_CHECK(keys == "acc/1,acc/2,");
+    size_t count = 0;
+    store.forEach(BytesConstRef(), [&](BytesConstRef, BytesConstRef) {
+        return ++count < 2;
+    });
+    BOOST_CHECK(count == 2);
+
+    // 快照不受之后的写入影响
+    auto snapshot = store.snapshot();
+    store.put("acc/2", "y2");
+    store.remove("blk/1");
+    store.put("acc/4", "w");
+    BOOST_CHECK(snapshot->get("acc/2", value) && value == Bytes{'y'});
+    BOOST_CHECK(snapshot->get("blk/1", value));
+    BOOST_CHECK(!snapshot->get("acc/4", value));
+    BOOST_CHECK(store.get("acc/2", value) && (value == Bytes{'y', '2'}));
+    BOOST_CHECK(!store.contains("blk/1"));
+
+    // 遍历时可以写入存储
+    store.forEach("acc/", [&](BytesConstRef key, BytesConstRef) {
+        store.remove(key);
+        return true;
+    });
+    BOOST_CHECK(store.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(memoryKVStoreForEachTest)
+{
+    // 键的个数超过一批，遍历时删除已访问的键、写入尚未访问到的键
+    MemoryKVStore store;
+    for (int i = 0; i < 1000; ++i) {
+        store.put("k" + std::to_string(1000 + i), std::to_string(i));
+    }
+    store.put("z", "");
+    size_t count = 0;
+    bool ordered = true;
+    std::string last;
+    store.forEach("k", [&](BytesConstRef key, BytesConstRef value) {
+        ordered = ordered && last < key.toString() && value.size() == (count < 10 ? 1 : count < 100 ? 2 : 3);
+        last = key.toString();
+        store.remove(key);
+        if (500 == count) {
+            store.put("k1999", "new");
+        }
+        ++count;
+        return true;
+    });
+    BOOST_CHECK(ordered);
+    BOOST_CHECK(count == 1000);
+    BOOST_CHECK(store.size() == 1);
+
+    // 在第一批之后停止
+    for (int i = 0; i < 1000; ++i) {
+        store.put("k" + std::to_string(1000 + i), "");
+    }
+    count = 0;
+    store.forEach("k", [&](BytesConstRef, BytesConstRef) {
+        return ++count < 300;
+    });
+    BOOST_CHECK(count == 300);
+}
+
+BOOST_AUTO_TEST_CASE(memoryKVStoreCompressTest)
+{
+    KVOptions options;
+    options.compress = true;
+    options.compressThreshold = 16;
+    MemoryKVStore store(options);
+
+    std::string small = "short";
+    std::string large(1000, 'x');
+    store.put("small", small);
+    store.put("large", large);
+
+    Bytes value;
+    BOOST_CHECK(store.get("small", value) && std::string(value.begin(), value.end()) == small);
+    BOOST_CHECK(store.get("large", value) && std::string(value.begin(), value.end()) == large);
+
+    std::string visited;
+    store.forEach("large", [&](BytesConstRef, BytesConstRef v) {
+        visited = v.toString();
+        return true;
+    });
+    BOOST_CHECK(visited == large);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,200 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/LogKVStore.h>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+namespace dev { namespace test {
+
+// 创建临时目录
+static std::string makeTempDir() {
+    char dir[] = "/tmp/LogKVStoreTestXXXXXX";
+    BOOST_REQUIRE(mkdtemp(dir));
+    return dir;
+}
+
+// 删除临时目录
+static void removeDir(const std::string& dir) {
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+// 读取字符串值
+static std::string getString(const KVStore& store, const std::string& key) {
+    Bytes value;
+    if (!store.get(key, value)) {
+        return "<none>";
+    }
+    return std::string(value.begin(), value.end());
+}
+
+BOOST_AUTO_TEST_SUITE(LogKVStoreTests)
+
+BOOST_AUTO_TEST_CASE(logKVStoreTest)
+{
+    std::string dir = makeTempDir();
+    std::string large(1000, 'v');
+    {
+        LogKVOptions options;
+        options.compress = true;
+        options.compressThreshold = 64;
+        LogKVStore store(dir, options);
+        store.put("a", "1");
+        store.put("b", "2", true);
+        WriteBatch batch;
+        batch.put("acc/1", "x");
+        batch.put("acc/2", large);
+        batch.remove("a");
+        store.write(batch, true);
+        BOOST_CHECK(getString(store, "a") == "<none>");
+        BOOST_CHECK(getString(store, "acc/2") == large);
+        BOOST_CHECK(store.size() == 3);
+
+        // 前缀遍历
+        std::string visited;
+        store.forEach("acc/", [&](BytesConstRef key, BytesConstRef value) {
+            visited += key.toString() + "=" + std::to_string(value.size()) + ",";
+            return true;
+        });
+        BOOST_CHECK(visited == "acc/1=1,acc/2=1000,");
+    }
+
+    // 重新打开后回放段文件
+    {
+        LogKVStore store(dir);
+        BOOST_CHECK(store.size() == 3);
+        BOOST_CHECK(getString(store, "a") == "<none>");
+        BOOST_CHECK(getString(store, "b") == "2");
+        BOOST_CHECK(getString(store, "acc/2") == large);
+        store.put("b", "3");
+    }
+
+    // 末尾写了一半的帧被截掉，之前的数据不受影响
+    {
+        int fd = open((dir + "/000001.log").c_str(), O_WRONLY | O_APPEND);
+        BOOST_REQUIRE(fd >= 0);
+        Byte garbage[] = {0x40, 0x00, 0x00, 0x00, 0x01, 0x02};
+        BOOST_CHECK(sizeof(garbage) == write(fd, garbage, sizeof(garbage)));
+        close(fd);
+
+        LogKVStore store(dir);
+        BOOST_CHECK(getString(store, "b") == "3");
+        store.put("c", "4");
+    }
+    {
+        LogKVStore store(dir);
+        BOOST_CHECK(getString(store, "c") == "4");
+        BOOST_CHECK(store.size() == 4);
+    }
+    removeDir(dir);
+}
+
+BOOST_AUTO_TEST_CASE(logKVStoreCompactTest)
+{
+    std::string dir = makeTempDir();
+    {
+        LogKVOptions options;
+        options.maxSegmentSize = 4096;
+        LogKVStore store(dir, options);
+
+        // 反复覆盖写入，产生多个段文件
+        for (int round = 0; round < 20; ++round) {
+            WriteBatch batch;
+            for (int i = 0; i < 20; ++i) {
+                batch.put("key" + std::to_string(i), "value" + std::to_string(round));
+            }
+            store.write(batch);
+        }
+        store.remove("key0");
+        BOOST_CHECK(store.segmentCount() > 1);
+        uint64_t before = store.diskSize();
+
+        // 压缩后只保留存活的键值，快照仍然可以读取旧数据
+        store.put("key1", "old");
+        auto snapshot = store.snapshot();
+        store.compact();
+        store.put("key1", "new");
+        BOOST_CHECK(store.diskSize() < before);
+        BOOST_CHECK(store.segmentCount() == 1);
+        BOOST_CHECK(store.size() == 19);
+        BOOST_CHECK(getString(store, "key0") == "<none>");
+        BOOST_CHECK(getString(store, "key1") == "new");
+        BOOST_CHECK(getString(store, "key2") == "value19");
+
+        Bytes value;
+        BOOST_CHECK(snapshot->get("key1", value) && std::string(value.begin(), value.end()) == "old");
+    }
+    {
+        LogKVStore store(dir);
+        BOOST_CHECK(store.size() == 19);
+        BOOST_CHECK(getString(store, "key0") == "<none>");
+        BOOST_CHECK(getString(store, "key1") == "new");
+        BOOST_CHECK(getString(store, "key19") == "value19");
+    }
+    removeDir(dir);
+}
+
+BOOST_AUTO_TEST_CASE(logKVStoreChecksumTest)
+{
+    // 最后一帧的负载被改动后校验失败，这一帧被截掉
+    std::string dir = makeTempDir();
+    {
+        LogKVStore store(dir);
+        store.put("a", "1");
+        store.put("b", "2");
+    }
+    {
+        int fd = open((dir + "/000001.log").c_str(), O_RDWR);
+        BOOST_REQUIRE(fd >= 0);
+        off_t end = lseek(fd, 0, SEEK_END);
+        Byte c = '3';
+        BOOST_CHECK(1 == pwrite(fd, &c, 1, end - 1));
+        close(fd);
+
+        LogKVStore store(dir);
+        BOOST_CHECK(getString(store, "a") == "1");
+        BOOST_CHECK(getString(store, "b") == "<none>");
+    }
+    removeDir(dir);
+}
+
+BOOST_AUTO_TEST_CASE(logKVStoreWriteFailureTest)
+{
+    // 用RLIMIT_FSIZE让一次写入只写进去一部分，之后切换段文件，重新打开时不能报告损坏
+    std::string dir = makeTempDir();
+    {
+        LogKVOptions options;
+        options.maxSegmentSize = 4096;
+        LogKVStore store(dir, options);
+        store.put("a", std::string(1000, 'a'));
+
+        auto oldHandler = signal(SIGXFSZ, SIG_IGN);
+        rlimit oldLimit;
+        getrlimit(RLIMIT_FSIZE, &oldLimit);
+        rlimit limit = oldLimit;
+        limit.rlim_cur = store.diskSize() + 500;
+        setrlimit(RLIMIT_FSIZE, &limit);
+        BOOST_CHECK_THROW(store.put("b", std::string(1000, 'b')), StorageIOError);
+        setrlimit(RLIMIT_FSIZE, &oldLimit);
+        signal(SIGXFSZ, oldHandler);
+
+        // 比残留数据短的写入之后切换段文件
+        store.put("c", "3");
+        store.put("d", std::string(4000, 'd'));
+        BOOST_CHECK(store.segmentCount() > 1);
+    }
+    {
+        LogKVStore store(dir);
+        BOOST_CHECK(getString(store, "a") == std::string(1000, 'a'));
+        BOOST_CHECK(getString(store, "b") == "<none>");
+        BOOST_CHECK(getString(store, "c") == "3");
+        BOOST_CHECK(getString(store, "d") == std::string(4000, 'd'));
+    }
+    removeDir(dir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,167 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/MetricsExporter.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace dev { namespace test {
+
+// 向本地端口发送一个HTTP请求，返回完整响应
+static std::string httpRequest(uint16_t port, const std::string& request) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    BOOST_REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    BOOST_REQUIRE(send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    std::string response;
+    char buf[1024];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+        response.append(buf, n);
+    }
+    close(fd);
+    return response;
+}
+
+BOOST_AUTO_TEST_SUITE(MetricsTests)
+
+BOOST_AUTO_TEST_CASE(counterTest)
+{
+    MetricsRegistry registry;
+    Counter& counter = registry.counter("test_total", "help");
+    BOOST_CHECK(&counter == &registry.counter("test_total", "help"));
+
+    // 多个线程写不同的分片，读取时加起来
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < 10000; ++j) {
+                counter.inc();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    counter.inc(5);
+    BOOST_CHECK(counter.value() == 80005);
+}
+
+BOOST_AUTO_TEST_CASE(gaugeTest)
+{
+    MetricsRegistry registry;
+    Gauge& gauge = registry.gauge("test_gauge", "help");
+    gauge.set(10);
+    gauge.add(-15);
+    BOOST_CHECK(gauge.value() == -5);
+}
+
+BOOST_AUTO_TEST_CASE(histogramTest)
+{
+    Histogram histogram({1, 2, 4});
+    for (double v : {0.5, 1.0, 1.5, 3.0, 100.0}) {
+        histogram.observe(v);
+    }
+    BOOST_CHECK(histogram.bucketCount(0) == 2);
+    BOOST_CHECK(histogram.bucketCount(1) == 1);
+    BOOST_CHECK(histogram.bucketCount(2) == 1);
+    BOOST_CHECK(histogram.bucketCount(3) == 1);
+    BOOST_CHECK(histogram.count() == 5);
+    BOOST_CHECK(histogram.sum() == 106);
+
+    BOOST_CHECK_THROW(Histogram({1, 1}), BadMetric);
+    std::vector<double> bounds = Histogram::exponentialBuckets(1, 2, 4);
+    BOOST_CHECK((bounds == std::vector<double>{1, 2, 4, 8}));
+}
+
+BOOST_AUTO_TEST_CASE(badMetricTest)
+{
+    MetricsRegistry registry;
+    registry.counter("dup", "help");
+    BOOST_CHECK_THROW(registry.gauge("dup", "help"), BadMetric);
+    BOOST_CHECK_THROW(registry.counter("1abc", "help"), BadMetric);
+    BOOST_CHECK_THROW(registry.counter("a-b", "help"), BadMetric);
+    BOOST_CHECK_THROW(registry.counter("ok", "help", {{"__reserved", "x"}}), BadMetric);
+    BOOST_CHECK_THROW(registry.counter("ok", "help", {{"a", "x"}, {"a", "y"}}), BadMetric);
+    BOOST_CHECK_THROW(registry.histogram("h", "help", {1}, {{"le", "x"}}), BadMetric);
+}
+
+BOOST_AUTO_TEST_CASE(prometheusTest)
+{
+    MetricsRegistry registry;
+    registry.counter("requests_total", "Requests\nserved", {{"op", "b"}, {"code", "200"}}).inc(3);
+    registry.counter("requests_total", "ignored", {{"code", "500"}, {"op", "a\"b"}}).inc();
+    registry.gauge("depth", "Queue depth").set(-2);
+    Histogram& histogram = registry.histogram("latency_seconds", "Latency", {0.25, 1});
+    histogram.observe(0.1);
+    histogram.observe(0.5);
+
+    std::string expected =
+        "# HELP depth Queue depth\n"
+        "# TYPE depth gauge\n"
+        "depth -2\n"
+        "# HELP latency_seconds Latency\n"
+        "# TYPE latency_seconds histogram\n"
+        "latency_seconds_bucket{le=\"0.25\"} 1\n"
+        "latency_seconds_bucket{le=\"1\"} 2\n"
+        "latency_seconds_bucket{le=\"+Inf\"} 2\n"
+        "latency_seconds_sum 0.6\n"
+        "latency_seconds_count 2\n"
+        "# HELP requests_total Requests\\nserved\n"
+        "# TYPE requests_total counter\n"
+        "requests_total{code=\"200\",op=\"b\"} 3\n"
+        "requests_total{code=\"500\",op=\"a\\\"b\"} 1\n";
+    BOOST_CHECK_EQUAL(registry.toPrometheus(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(textfileTest)
+{
+    MetricsRegistry registry;
+    registry.counter("written_total", "help").inc(7);
+    std::string path = "/tmp/learn-bcos-metrics-test.prom";
+    writeMetricsTextfile(path, registry);
+
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    BOOST_CHECK_EQUAL(content.str(), registry.toPrometheus());
+    std::remove(path.c_str());
+
+    BOOST_CHECK_THROW(writeMetricsTextfile("/nonexistent/dir/metrics.prom", registry), MetricsIOError);
+}
+
+BOOST_AUTO_TEST_CASE(httpServerTest)
+{
+    MetricsRegistry registry;
+    registry.counter("served_total", "help").inc(2);
+    MetricsHTTPServer server("127.0.0.1", 0, registry);
+    BOOST_REQUIRE(server.port() != 0);
+
+    std::string response = httpRequest(server.port(), "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    BOOST_CHECK(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    BOOST_CHECK(response.find("version=0.0.4") != std::string::npos);
+    BOOST_CHECK(response.find("\r\n\r\n" + registry.toPrometheus()) != std::string::npos);
+
+    response = httpRequest(server.port(), "GET /other HTTP/1.1\r\n\r\n");
+    BOOST_CHECK(response.compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+
+    response = httpRequest(server.port(), "POST /metrics HTTP/1.1\r\n\r\n");
+    BOOST_CHECK(response.compare(0, 12, "HTTP/1.1 405") == 0);
+
+    BOOST_CHECK_THROW(MetricsHTTPServer("not-an-ip", 0, registry), MetricsIOError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,109 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/Profiler.h>
+#include <string>
+#include <thread>
+
+namespace dev { namespace test {
+
+// 在快照中查找作用域
+static const ScopeStats* findScope(const ProfileSnapshot& snapshot, const std::string& name) {
+    for (auto& stats : snapshot) {
+        if (stats.name == name) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+BOOST_AUTO_TEST_SUITE(ProfilerTests)
+
+BOOST_AUTO_TEST_CASE(latencyHistogramTest)
+{
+    // 桶的边界连续，每个值都落在所在桶的范围内
+    for (unsigned b = 0; b + 1 < LatencyHistogram::c_bucketCount; ++b) {
+        BOOST_REQUIRE(LatencyHistogram::bucketUpper(b) + 1 == LatencyHistogram::bucketLower(b + 1));
+    }
+    for (uint64_t v : {0ull, 1ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull, ~0ull}) {
+        unsigned b = LatencyHistogram::bucketOf(v);
+        BOOST_CHECK(LatencyHistogram::bucketLower(b) <= v && v <= LatencyHistogram::bucketUpper(b));
+    }
+
+    // 百分位数的相对误差不超过1/8
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 10000; ++v) {
+        h.record(v);
+    }
+    BOOST_CHECK(h.count == 10000 && h.min == 1 && h.max == 10000);
+    BOOST_CHECK(h.mean() == 5000.5);
+    for (double p : {0.5, 0.9, 0.99}) {
+        double expected = p * 10000;
+        BOOST_CHECK(h.percentile(p) >= expected && h.percentile(p) <= expected * 1.125);
+    }
+    BOOST_CHECK(h.percentile(1.0) == 10000);
+
+    LatencyHistogram other;
+    other.record(20000);
+    h.merge(other);
+    BOOST_CHECK(h.count == 10001 && h.max == 20000);
+}
+
+BOOST_AUTO_TEST_CASE(profilerTest)
+{
+    size_t scope = Profiler::registerScope("test.sleep");
+    BOOST_CHECK(Profiler::registerScope("test.sleep") == scope);
+    size_t other = Profiler::registerScope("test.other");
+    BOOST_CHECK(other != scope);
+
+    auto before = Profiler::snapshot();
+
+    // 多个线程分别记录，快照合并所有线程
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([scope] {
+            for (int i = 0; i < 100; ++i) {
+                ScopeTimer timer(scope);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Profiler::setTracing(true);
+    {
+        ScopeTimer timer(other);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    Profiler::setTracing(false);
+
+    auto now = Profiler::snapshot();
+    auto delta = Profiler::diff(now, before);
+    auto sleep = findScope(delta, "test.sleep");
+    BOOST_REQUIRE(sleep);
+    BOOST_CHECK(sleep->histogram.count == 400);
+    auto slow = findScope(delta, "test.other");
+    BOOST_REQUIRE(slow);
+    BOOST_CHECK(slow->histogram.count == 1);
+    BOOST_CHECK(slow->histogram.max >= 2000000);
+
+    // 导出
+    std::string text = Profiler::toText(now);
+    BOOST_CHECK(text.find("test.sleep") != std::string::npos);
+    std::string json = Profiler::toJSON(now);
+    BOOST_CHECK(json.find("\"name\":\"test.other\"") != std::string::npos);
+    std::string trace = Profiler::toChromeTrace();
+    BOOST_CHECK(trace.find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"test.other\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"test.sleep\"") == std::string::npos);
+
+    // 周期性报告
+    std::atomic<int> reports(0);
+    {
+        ProfileReporter reporter(std::chrono::milliseconds(5), [&](const ProfileSnapshot&) { ++reports; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    }
+    BOOST_CHECK(reports > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
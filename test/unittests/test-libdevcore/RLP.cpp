@@ -39,6 +39,10 @@ BOOST_AUTO_TEST_CASE(encodeTest)
     s.appendList(0);
     BOOST_CHECK(toHex0x(s.take()) == "0xc0");
 
+    // 嵌套的空列表也算一个数据项
+    s.appendList(2).appendList(0).appendList(0);
+    BOOST_CHECK(toHex0x(s.take()) == "0xc2c0c0");
+
     // 字符串长度为1且属于[0x00, 0x7f]
     s << static_cast<uint32_t>(0x01);
     BOOST_CHECK(toHex0x(s.take()) == "0x01");
@@ -100,6 +104,46 @@ BOOST_AUTO_TEST_CASE(encodeTest)
     BOOST_CHECK_THROW(s.peek(), RLPIncompleteList);
 }
 
+BOOST_AUTO_TEST_CASE(rlpSizeTest)
+{
+    // 整型（覆盖单字节，前缀编码长度的各个边界）
+    for (uint64_t u : {0ull, 1ull, 0x7full, 0x80ull, 0xffull, 0x100ull, 0xffffffffull, ~0ull}) {
+        BOOST_CHECK_EQUAL(rlpSize(u), rlpData(u).size());
+    }
+    U256 big("0xf170d8e0ae1b57d7ecc121f6fe5ceb03c1267801ff720edd2f8463e7effac6c6");
+    BOOST_CHECK_EQUAL(rlpSize(big), 33);
+    BOOST_CHECK_EQUAL(rlpSize(U512(big) << 200), rlpData(U512(big) << 200).size());
+
+    // 字符串（覆盖长度55/56，256字节长度编码等边界）
+    for (size_t len : {0, 1, 2, 55, 56, 255, 256, 65536}) {
+        Bytes bs(len, 0x80);
+        BOOST_CHECK_EQUAL(rlpSize(bs), rlpData(bs).size());
+    }
+    BOOST_CHECK_EQUAL(rlpSize(Bytes{0x7f}), 1);
+    BOOST_CHECK_EQUAL(rlpSize(std::string("dog")), 4);
+
+    // 定长字节数组
+    BOOST_CHECK_EQUAL(rlpSize(H256()), 33);
+    BOOST_CHECK_EQUAL(rlpSize(H2048()), 259);
+    BOOST_CHECK_EQUAL(rlpSize(FixedBytes<1>("0x7f")), 1);
+    BOOST_CHECK_EQUAL(rlpSize(FixedBytes<1>("0x80")), 2);
+
+    // 列表
+    BOOST_CHECK_EQUAL(rlpListSize(), rlpList().size());
+    Bytes list = rlpList(H256(), uint64_t(1024), Bytes(60, 1), "cat", U256(0));
+    BOOST_CHECK_EQUAL(rlpListSize(H256(), uint64_t(1024), Bytes(60, 1), "cat", U256(0)), list.size());
+    BOOST_CHECK_EQUAL(rlpSize(RLP(list)), list.size());
+    std::vector<H256> hashes(10);
+    RLPStream hs(hashes.size());
+    for (const auto& h : hashes) {
+        hs << h;
+    }
+    Bytes hashList = hs.take();
+    BOOST_CHECK_EQUAL(rlpSize(hashes), hashList.size());
+    BOOST_CHECK_EQUAL(rlpSize(hashes), rlpListSizeOfPayload(330));
+    BOOST_CHECK_EQUAL(rlpListSize(hashes, RLP(list)), rlpList(RLP(hashList), RLP(list)).size());
+}
+
 BOOST_AUTO_TEST_CASE(decodeTest)
 {
     // null
@@ -110,6 +154,7 @@ BOOST_AUTO_TEST_CASE(decodeTest)
     BOOST_CHECK_THROW(nullItem.convert<U160>(), RLPBadCast);
     BOOST_CHECK_THROW(nullItem.convert<H160>(), RLPBadCast);
     BOOST_CHECK_THROW(nullItem.convert<std::string>(), RLPBadCast);
+    BOOST_CHECK_THROW(nullItem.toStringView(), RLPBadCast);
     BOOST_CHECK_THROW(nullItem.convert<Bytes>(), RLPBadCast);
 
     // 空字符串
@@ -134,6 +179,8 @@ BOOST_AUTO_TEST_CASE(decodeTest)
     BOOST_CHECK(singleByteItem.convert<U512>() == 0x7f);
     BOOST_CHECK(toHex0x(singleByteItem.convert<Bytes>()) == "0x7f");
     BOOST_CHECK(singleByteItem.convert<std::string>() == "\x7f");
+    BOOST_CHECK(singleByteItem.toStringView() == "\x7f");
+    BOOST_CHECK(singleByteItem.toStringView().data() == reinterpret_cast<const char*>(bs.data()));
     BOOST_CHECK(singleByteItem.toFixedBytes<H160>(Align::c_right).hex() == "000000000000000000000000000000000000007f");
 
     // 字符串长度编码到前缀
@@ -159,6 +206,14 @@ BOOST_AUTO_TEST_CASE(decodeTest)
     BOOST_CHECK(immListItems.size() == 2);
     BOOST_CHECK(toHex0x(immListItems[0].convert<Bytes>()) == "0x1234567890");
     BOOST_CHECK(toHex0x(immListItems[1].convert<Bytes>()) == "0x1234567890");
+    BOOST_CHECK(toHex0x(immListItems[1].convert<SmallBytes>()) == "0x1234567890");
+    BOOST_CHECK_THROW(immListItem.toSmallBytes(), RLPBadCast);
+
+    // 列表长度为55时仍然编码到前缀（0xf7）
+    bs = fromHex("0xf78a111111111111111111118a111111111111111111118a111111111111111111118a111111111111111111118a11111111111111111111");
+    RLP maxImmListItem(bs);
+    BOOST_CHECK(maxImmListItem.payload().size() == 55);
+    BOOST_CHECK(maxImmListItem.splitList().size() == 5);
 
     // 列表长度单独编码
     bs = fromHex("0xf838871234567890abcd871234567890abcd871234567890abcd871234567890abcd871234567890abcd871234567890abcd871234567890abcd");
@@ -167,6 +222,16 @@ BOOST_AUTO_TEST_CASE(decodeTest)
     BOOST_CHECK(indListItems.size() == 7);
     BOOST_CHECK(toHex0x(indListItems[0].convert<Bytes>()) == "0x1234567890abcd");
 
+    // 迭代器与splitList结果一致
+    size_t count = 0;
+    for (const auto& item : indListItem) {
+        BOOST_CHECK(item.actualData().data() == indListItems[count].actualData().data());
+        ++count;
+    }
+    BOOST_CHECK(count == indListItems.size());
+    BOOST_CHECK(RLP(c_rlpEmptyList).begin() == RLP(c_rlpEmptyList).end());
+    BOOST_CHECK_THROW(RLP(c_rlpEmptyData).begin(), RLPBadCast);
+
     // 本来应该是单字节编码但是长度编码到前缀
     bs = fromHex("0x817f");
     BOOST_CHECK_THROW(RLP rlp100(bs), BadRLP);
@@ -217,6 +282,128 @@ BOOST_AUTO_TEST_CASE(decodeTest)
     BOOST_CHECK_THROW(wrongListItem.splitList(), BadRLP);
 }
 
+BOOST_AUTO_TEST_CASE(fixedStrideTest)
+{
+    // 哈希列表
+    H256s hashes(21);
+    RLPStream s(hashes.size());
+    for (auto& h : hashes) {
+        h = H256::random();
+        s << h;
+    }
+    Bytes bs = s.take();
+    RLP rlp(bs);
+    BOOST_CHECK_EQUAL(rlp.itemCount(), 21);
+    BOOST_CHECK(rlp.isFixedStrideList(32));
+    BOOST_CHECK(!rlp.isFixedStrideList(20));
+    RLPFixedBytesView<32> view = rlp.toFixedBytesView<32>();
+    BOOST_REQUIRE_EQUAL(view.size(), 21);
+    BOOST_CHECK(view[20] == hashes[20]);
+    BOOST_CHECK(view.ref(3).data() == rlp.splitList()[3].payload().data());
+    BOOST_CHECK(view.toVector() == hashes);
+    BOOST_CHECK(rlp.convert<H256s>() == hashes);
+    BOOST_CHECK_THROW(rlp.convert<H160s>(), RLPBadCast);
+
+    // 空列表
+    RLP empty(c_rlpEmptyList);
+    BOOST_CHECK_EQUAL(empty.itemCount(), 0);
+    BOOST_CHECK(empty.toFixedBytesView<32>().empty());
+    BOOST_CHECK(empty.convert<H160s>().empty());
+
+    // 混合长度的数据项
+    RLPStream m(5);
+    m << hashes[0] << H160::random() << "dog" << Bytes(100, 0x11);
+    m.appendList(2) << 1u << hashes[1];
+    bs = m.take();
+    BOOST_CHECK_EQUAL(RLP(bs).itemCount(), 5);
+    BOOST_CHECK(!RLP(bs).isFixedStrideList(32));
+    BOOST_CHECK_THROW(RLP(bs).toFixedBytesView<32>(), RLPBadCast);
+
+    // 长度恰好是步长的倍数，但前缀不符
+    bs = rlpList(hashes[0], Bytes(31, 0x11), 1u);
+    BOOST_CHECK_EQUAL(RLP(bs).itemCount(), 3);
+    BOOST_CHECK(!RLP(bs).isFixedStrideList(32));
+
+    // 不是列表
+    BOOST_CHECK_THROW(RLP(rlpData(hashes[0])).itemCount(), RLPBadCast);
+    BOOST_CHECK_THROW(RLP(rlpData(hashes[0])).toFixedBytesView<32>(), RLPBadCast);
+    BOOST_CHECK(!RLP(rlpData(hashes[0])).isFixedStrideList(32));
+
+    // 列表中碰到错误编码的数据项
+    bs = fromHex("0xcc851234567890861234567890");
+    BOOST_CHECK_THROW(RLP(bs).itemCount(), BadRLP);
+    BOOST_CHECK_THROW(RLP(bs).toFixedBytesView<5>(), BadRLP);
+    bs = fromHex("0xc481008100");
+    BOOST_CHECK_THROW(RLP(bs).itemCount(), BadRLP);
+}
+
+BOOST_AUTO_TEST_CASE(validateTest)
+{
+    // 合法的编码
+    BOOST_CHECK(validateRLP(fromHex("0x7f")) == RLPValidity::c_valid);
+    BOOST_CHECK(validateRLP(fromHex("0x80")) == RLPValidity::c_valid);
+    BOOST_CHECK(validateRLP(fromHex("0xc0")) == RLPValidity::c_valid);
+    BOOST_CHECK(validateRLP(fromHex("0xcc851234567890851234567890")) == RLPValidity::c_valid);
+    BOOST_CHECK(validateRLP(fromHex("0xc7c0c1c0c3c0c1c0")) == RLPValidity::c_valid);
+    RLPStream s(3);
+    s << Bytes(1000, 0x11) << std::numeric_limits<U512>::max();
+    s.appendList(2) << H256::random() << "dog";
+    Bytes bs = s.take();
+    BOOST_CHECK(validateRLP(bs) == RLPValidity::c_valid);
+
+    // 不完整
+    BOOST_CHECK(validateRLP(Bytes()) == RLPValidity::c_truncated);
+    BOOST_CHECK(validateRLP(fromHex("0x81")) == RLPValidity::c_truncated);
+    BOOST_CHECK(validateRLP(fromHex("0xb838")) == RLPValidity::c_truncated);
+    BOOST_CHECK(validateRLP(fromHex("0xbfffffffffffffffff00")) == RLPValidity::c_truncated);
+    BOOST_CHECK(validateRLP(fromHex("0xf8")) == RLPValidity::c_truncated);
+    BOOST_CHECK(validateRLP(BytesConstRef(bs.data(), bs.size() - 1)) == RLPValidity::c_truncated);
+    // 列表中的数据项超出列表的范围
+    BOOST_CHECK(validateRLP(fromHex("0xc28300000000")) == RLPValidity::c_truncated);
+
+    // 不是最短编码
+    BOOST_CHECK(validateRLP(fromHex("0x8100")) == RLPValidity::c_nonCanonical);
+    BOOST_CHECK(validateRLP(fromHex("0xb800")) == RLPValidity::c_nonCanonical);
+    BOOST_CHECK(validateRLP(fromHex("0xb90038")) == RLPValidity::c_nonCanonical);
+    BOOST_CHECK(validateRLP(fromHex("0xf80100")) == RLPValidity::c_nonCanonical);
+    BOOST_CHECK(validateRLP(fromHex("0xc28100")) == RLPValidity::c_nonCanonical);
+
+    // 多余的数据
+    BOOST_CHECK(validateRLP(fromHex("0x8080")) == RLPValidity::c_trailingBytes);
+    BOOST_CHECK(validateRLP(fromHex("0xcc85123456789085123456789000")) == RLPValidity::c_trailingBytes);
+
+    // 嵌套层数
+    Bytes nested = rlpList();
+    for (int i = 1; i < 100; ++i) {
+        nested = rlpList(RLP(nested));
+    }
+    BOOST_CHECK(validateRLP(nested) == RLPValidity::c_tooDeep);
+    RLPLimits limits;
+    limits.maxDepth = 100;
+    BOOST_CHECK(validateRLP(nested, limits) == RLPValidity::c_valid);
+    limits.maxDepth = 99;
+    BOOST_CHECK(validateRLP(nested, limits) == RLPValidity::c_tooDeep);
+
+    // 超过栈上数组大小的maxDepth按c_maxDepth处理
+    for (size_t i = 100; i < RLPLimits::c_maxDepth; ++i) {
+        nested = rlpList(RLP(nested));
+    }
+    limits.maxDepth = std::numeric_limits<size_t>::max();
+    BOOST_CHECK(validateRLP(nested, limits) == RLPValidity::c_valid);
+    nested = rlpList(RLP(nested));
+    BOOST_CHECK(validateRLP(nested, limits) == RLPValidity::c_tooDeep);
+
+    // 数据项总数和输入长度
+    limits = RLPLimits();
+    limits.maxItems = 6;
+    BOOST_CHECK(validateRLP(bs, limits) == RLPValidity::c_valid);
+    limits.maxItems = 5;
+    BOOST_CHECK(validateRLP(bs, limits) == RLPValidity::c_tooManyItems);
+    limits = RLPLimits();
+    limits.maxSize = bs.size() - 1;
+    BOOST_CHECK(validateRLP(bs, limits) == RLPValidity::c_tooLarge);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}   // namespace dev::test
\ No newline at end of file
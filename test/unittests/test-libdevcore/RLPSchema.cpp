@@ -0,0 +1,171 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/RLPSchema.h>
+#include <string>
+#include <vector>
+
+namespace dev { namespace test {
+
+// 全部为定长字段
+struct FixedRecord {
+    H256 hash;
+    H160 address;
+
+    RLP_FIELDS(hash, address)
+};
+
+// 包含变长字段和嵌套结构体
+struct Record {
+    uint64_t number = 0;
+    U256 amount;
+    H256 parent;
+    Bytes payload;
+    std::string name;
+    SmallBytes tag;
+    FixedRecord fixed;
+    std::vector<H256> hashes;
+    std::vector<FixedRecord> children;
+
+    RLP_FIELDS(number, amount, parent, payload, name, tag, fixed, hashes, children)
+};
+
+BOOST_AUTO_TEST_SUITE(RLPSchemaTests)
+
+BOOST_AUTO_TEST_CASE(fixedSizeTest)
+{
+    // 定长字段的编码长度在编译期确定
+    static_assert(RLPCodec<H256>::c_fixedSize == 33, "H256");
+    static_assert(RLPCodec<H160>::c_fixedSize == 21, "H160");
+    static_assert(RLPCodec<H2048>::c_fixedSize == 259, "H2048");
+    static_assert(RLPCodec<FixedRecord>::c_fixedSize == 55, "FixedRecord");
+    static_assert(RLPCodec<Record>::c_fixedSize == 0, "Record");
+    static_assert(RLPCodec<uint64_t>::c_fixedSize == 0, "uint64_t");
+
+    // H160/H256的列表按固定步长解码
+    static_assert(isFixedStrideBytes<H160>::value && isFixedStrideBytes<H256>::value, "fixed stride");
+    static_assert(!isFixedStrideBytes<H512>::value && !isFixedStrideBytes<U256>::value, "not fixed stride");
+
+    FixedRecord r{H256::random(), H160::random()};
+    RLPStream s(2);
+    s << r.hash << r.address;
+    Bytes expected = s.take();
+    BOOST_CHECK_EQUAL(rlpSize(r), expected.size());
+    BOOST_CHECK(rlpEncode(r) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(encodeTest)
+{
+    Record r;
+    r.number = 1024;
+    r.amount = U256("0xf170d8e0ae1b57d7ecc121f6fe5ceb03c1267801ff720edd2f8463e7effac6c6");
+    r.parent = H256::random();
+    r.payload = Bytes(100, 0x42);
+    r.name = "a";
+    r.tag = SmallBytes(BytesConstRef(fromHex("0x7f")));
+    r.fixed = FixedRecord{H256::random(), H160::random()};
+    r.hashes = {H256::random(), H256::random(), H256::random()};
+    r.children = {FixedRecord{H256::random(), H160::random()}};
+
+    // 与手写的RLPStream编码一致
+    RLPStream s(9);
+    s << r.number << r.amount << r.parent << r.payload << r.name << r.tag.ref();
+    s.appendList(2) << r.fixed.hash << r.fixed.address;
+    s.appendList(3) << r.hashes[0] << r.hashes[1] << r.hashes[2];
+    s.appendList(1).appendList(2) << r.children[0].hash << r.children[0].address;
+    Bytes expected = s.take();
+
+    BOOST_CHECK_EQUAL(rlpSize(r), expected.size());
+    Bytes out = rlpEncode(r);
+    BOOST_CHECK(out == expected);
+
+    // 编码到调用方提供的内存
+    Bytes buf(expected.size());
+    BOOST_CHECK_EQUAL(rlpEncode(r, BytesRef(buf)), expected.size());
+    BOOST_CHECK(buf == expected);
+    BOOST_CHECK_THROW(rlpEncode(r, BytesRef(buf.data(), buf.size() - 1)), OutOfRange);
+
+    // 零值和空值
+    Record empty;
+    RLPStream e(9);
+    e << uint64_t(0) << U256(0) << H256() << Bytes() << std::string() << BytesConstRef();
+    e.appendList(2) << H256() << H160();
+    e.appendList(0);
+    e.appendList(0);
+    BOOST_CHECK(rlpEncode(empty) == e.take());
+}
+
+BOOST_AUTO_TEST_CASE(bigIntegerTest)
+{
+    // 55字节以内用短格式，56字节及以上的整数（只有U512能达到）用长格式的长度前缀
+    for (unsigned bytes : {1u, 54u, 55u, 56u, 63u, 64u}) {
+        U512 v = U512(0xab) << ((bytes - 1) * 8);
+        RLPStream s;
+        s << v;
+        Bytes expected = s.take();
+        BOOST_CHECK_EQUAL(rlpSize(v), expected.size());
+        BOOST_CHECK(rlpEncode(v) == expected);
+        BOOST_CHECK(rlpDecode<U512>(expected) == v);
+    }
+    Bytes expected{0xb8, 0x38, 0x80};
+    expected.resize(2 + 56);
+    BOOST_CHECK(rlpEncode(U512(1) << 447) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(decodeTest)
+{
+    Record r;
+    r.number = 0x7f;
+    r.amount = 56;
+    r.parent = H256::random();
+    r.payload = Bytes(1000, 0x11);
+    r.name = "hello";
+    r.tag = SmallBytes(BytesConstRef(fromHex("0x1234")));
+    r.fixed = FixedRecord{H256::random(), H160::random()};
+    r.hashes = {H256::random(), H256::random(), H256::random(), H256::random(), H256::random()};
+    r.children = {FixedRecord{H256::random(), H160::random()}, FixedRecord{H256::random(), H160::random()}};
+
+    Bytes out = rlpEncode(r);
+    Record d = rlpDecode<Record>(out);
+    BOOST_CHECK_EQUAL(d.number, r.number);
+    BOOST_CHECK(d.amount == r.amount);
+    BOOST_CHECK(d.parent == r.parent);
+    BOOST_CHECK(d.payload == r.payload);
+    BOOST_CHECK_EQUAL(d.name, r.name);
+    BOOST_CHECK(d.tag == r.tag);
+    BOOST_CHECK(d.fixed.hash == r.fixed.hash && d.fixed.address == r.fixed.address);
+    BOOST_CHECK(d.hashes == r.hashes);
+    BOOST_REQUIRE_EQUAL(d.children.size(), 2);
+    BOOST_CHECK(d.children[1].address == r.children[1].address);
+    BOOST_CHECK(rlpEncode(d) == out);
+}
+
+BOOST_AUTO_TEST_CASE(badDecodeTest)
+{
+    H256 h = H256::random();
+    H160 a = H160::random();
+
+    // 字段太少或太多
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(rlpList(h)), RLPBadCast);
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(rlpList(h, a, a)), RLPBadCast);
+
+    // 字段类型不符
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(rlpList(h, h)), RLPBadCast);
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(rlpList(a, a)), RLPBadCast);
+    BOOST_CHECK_THROW(rlpDecode<std::vector<H512>>(rlpList(h)), RLPBadCast);
+    BOOST_CHECK_THROW(rlpDecode<std::vector<H256>>(rlpList(h, a)), RLPBadCast);
+    RLPStream s(2);
+    s << h;
+    s.appendList(0);
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(s.take()), RLPBadCast);
+
+    // 不是列表
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(RLPStream().append(h).take()), RLPBadCast);
+
+    // 编码不完整
+    Bytes truncated = rlpList(h, a);
+    truncated.pop_back();
+    BOOST_CHECK_THROW(rlpDecode<FixedRecord>(truncated), BadRLP);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,74 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/SecureRandom.h>
+#include <libdevcore/FixedBytes.h>
+#include <libdevcore/Hex.h>
+#include <thread>
+#include <set>
+#include <algorithm>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(SecureRandomTests)
+
+BOOST_AUTO_TEST_CASE(chacha20Test)
+{
+    // RFC 7539 2.3.2测试向量（96位nonce的版本，转换为64位计数器+64位nonce的形式）
+    uint32_t key[8];
+    for (int i = 0; i < 8; ++i) {
+        key[i] = (4 * i) | (4 * i + 1) << 8 | (4 * i + 2) << 16 | (4 * i + 3) << 24;
+    }
+    Byte out[64];
+    chacha20Block(key, 0x0900000000000001ull, 0x4a000000ull, out);
+    BOOST_CHECK(toHex(out) ==
+        "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+        "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+}
+
+BOOST_AUTO_TEST_CASE(secureRandomTest)
+{
+    // 两次生成的随机数不同
+    Bytes b1(100), b2(100);
+    secureRandom(b1);
+    secureRandom(b2);
+    BOOST_CHECK(b1 != b2);
+    BOOST_CHECK(secureRandom64() != secureRandom64());
+
+    // 跨越缓存边界，以及超过重新获取种子的间隔
+    Bytes big(CSPRNG::c_reseedInterval + 3000);
+    secureRandom(big);
+    size_t zeros = std::count(big.begin(), big.end(), 0);
+    BOOST_CHECK(zeros < big.size() / 128);
+
+    // 不同线程生成的随机数不同
+    H256 h1, h2;
+    std::thread t1([&h1] { h1.randomize(); });
+    std::thread t2([&h2] { h2.randomize(); });
+    t1.join();
+    t2.join();
+    BOOST_CHECK(h1 != h2);
+}
+
+BOOST_AUTO_TEST_CASE(csprngTest)
+{
+    // 独立的生成器之间输出互不相同
+    CSPRNG rng1, rng2;
+    std::set<H256> outputs;
+    for (int i = 0; i < 100; ++i) {
+        H256 h;
+        rng1.fill(h.ref());
+        outputs.insert(h);
+        rng2.fill(h.ref());
+        outputs.insert(h);
+    }
+    BOOST_CHECK(outputs.size() == 200);
+
+    // 重新获取种子之后仍可正常输出
+    rng1.reseed();
+    H256 h;
+    rng1.fill(h.ref());
+    BOOST_CHECK(static_cast<bool>(h));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
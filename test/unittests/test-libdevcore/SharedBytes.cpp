@@ -0,0 +1,96 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/SharedBytes.h>
+#include <libdevcore/SmallBytes.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/Hex.h>
+#include <future>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(SharedBytesTests)
+
+BOOST_AUTO_TEST_CASE(sharedBytesTest)
+{
+    // 空数组
+    SharedBytes empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK(toHex(empty) == "");
+
+    // 接管Bytes不拷贝
+    Bytes bs = fromHex("0x00112233445566778899");
+    const Byte* bsData = bs.data();
+    SharedBytes sb(std::move(bs));
+    BOOST_CHECK(sb.data() == bsData);
+    BOOST_CHECK(toHex(sb) == "00112233445566778899");
+
+    // 截取子数组不拷贝
+    SharedBytes sub = sb.cropped(2, 3);
+    BOOST_CHECK(toHex(sub) == "223344");
+    BOOST_CHECK(sub.data() == bsData + 2);
+    BOOST_CHECK(sb.useCount() == 2);
+    BOOST_CHECK(toHex(sb.cropped(8)) == "8899");
+    BOOST_CHECK_THROW(sb.cropped(11), OutOfRange);
+
+    // 引用转换为SharedBytes
+    SharedBytes sliced = sb.slice(sb.ref().cropped(4, 2));
+    BOOST_CHECK(toHex(sliced) == "4455");
+    BOOST_CHECK(sliced.data() == bsData + 4);
+    Bytes other(10);
+    BOOST_CHECK_THROW(sb.slice(other), OutOfRange);
+    BOOST_CHECK_THROW(sub.slice(sb.ref()), OutOfRange);
+
+    // 原对象释放后子数组仍然有效
+    sb = SharedBytes();
+    BOOST_CHECK(toHex(sub) == "223344");
+    BOOST_CHECK(sub == SharedBytes(fromHex("0x223344")));
+}
+
+BOOST_AUTO_TEST_CASE(smallBytesInteropTest)
+{
+    // 与SmallBytes的共享存储互相转换不拷贝
+    SharedBytes sb(Bytes(100, 0x11));
+    SmallBytes small = sb.cropped(10, 80).toSmallBytes();
+    BOOST_CHECK(!small.isInline());
+    BOOST_CHECK(small.data() == sb.data() + 10);
+    BOOST_CHECK(sb.useCount() == 2);
+    SharedBytes back(small);
+    BOOST_CHECK(back.data() == small.data() && back.size() == 80);
+    BOOST_CHECK(sb.useCount() == 3);
+
+    // SmallBytes修改时写时复制，SharedBytes引用的内存不变
+    small.mutableData()[0] = 0x22;
+    BOOST_CHECK(small.data() != back.data());
+    BOOST_CHECK(back[0] == 0x11 && sb[10] == 0x11);
+
+    // 内联存储时拷贝
+    SmallBytes inlined(BytesConstRef(fromHex("0x0102")));
+    BOOST_CHECK(toHex(SharedBytes(inlined)) == "0102");
+    BOOST_CHECK(SharedBytes(SmallBytes()).empty());
+    BOOST_CHECK(SharedBytes().toSmallBytes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(sharedRLPTest)
+{
+    SharedRLP rlp(SharedBytes(fromHex("0xcc851234567890851234567891")));
+    BOOST_CHECK(rlp.isList());
+
+    // 子数据项在原对象释放后仍然有效，并且可以交给其它线程
+    std::vector<SharedRLP> items = rlp.splitList();
+    rlp = SharedRLP(SharedBytes(fromHex("0x80")));
+    BOOST_CHECK(items.size() == 2);
+    BOOST_CHECK(items[0].buffer().useCount() == 2);
+    auto fut = std::async(std::launch::async, [&items] {
+        return toHex(items[1].sharedPayload());
+    });
+    BOOST_CHECK(fut.get() == "1234567891");
+    BOOST_CHECK(toHex(items[0].sharedActualData()) == "851234567890");
+    BOOST_CHECK(toHex(items[0].convert<Bytes>()) == "1234567890");
+    BOOST_CHECK(items[1].rlp().toInt<uint64_t>() == 0x1234567891);
+
+    // 非列表
+    BOOST_CHECK_THROW(items[0].splitList(), RLPBadCast);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
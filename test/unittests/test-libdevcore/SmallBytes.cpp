@@ -0,0 +1,89 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/SmallBytes.h>
+#include <libdevcore/Hex.h>
+#include <memory>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(SmallBytesTests)
+
+BOOST_AUTO_TEST_CASE(inlineTest)
+{
+    // 空数组
+    SmallBytes empty;
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK(empty.isInline());
+    BOOST_CHECK(toHex(empty) == "");
+
+    // 不超过64字节时内联存储
+    Bytes bs = fromHex("0x1234567890");
+    SmallBytes sb(bs);
+    BOOST_CHECK(sb.isInline());
+    BOOST_CHECK(sb.size() == 5);
+    BOOST_CHECK(toHex(sb) == "1234567890");
+    BOOST_CHECK(sb.toBytes() == bs);
+
+    // 追加到64字节仍然内联存储，超过后转为堆存储
+    SmallBytes grow;
+    for (int i = 0; i < 64; ++i) {
+        grow.push_back(static_cast<Byte>(i));
+    }
+    BOOST_CHECK(grow.isInline());
+    grow.push_back(64);
+    BOOST_CHECK(!grow.isInline());
+    BOOST_CHECK(grow.size() == 65);
+    for (int i = 0; i < 65; ++i) {
+        BOOST_CHECK(grow[i] == i);
+    }
+
+    // 调整长度
+    SmallBytes zeros(3);
+    BOOST_CHECK(toHex(zeros) == "000000");
+    zeros.mutableData()[1] = 0xff;
+    zeros.resize(100);
+    BOOST_CHECK(zeros.size() == 100 && zeros[1] == 0xff && zeros[99] == 0);
+    zeros.resize(2);
+    BOOST_CHECK(toHex(zeros) == "00ff");
+}
+
+BOOST_AUTO_TEST_CASE(sharedTest)
+{
+    // 接管大的Bytes不拷贝
+    Bytes big(1000, 0xab);
+    const Byte* bigData = big.data();
+    SmallBytes sb(std::move(big));
+    BOOST_CHECK(!sb.isInline());
+    BOOST_CHECK(sb.data() == bigData);
+
+    // 拷贝和截取只增加引用计数
+    SmallBytes copied = sb;
+    BOOST_CHECK(copied.data() == sb.data());
+    SmallBytes slice = sb.cropped(100, 200);
+    BOOST_CHECK(slice.size() == 200 && slice.data() == sb.data() + 100);
+    BOOST_CHECK_THROW(sb.cropped(1001), OutOfRange);
+
+    // 写时复制
+    copied.mutableData()[0] = 0x00;
+    BOOST_CHECK(copied.data() != sb.data());
+    BOOST_CHECK(sb[0] == 0xab && copied[0] == 0x00);
+
+    // 引用大消息中的一段
+    auto frame = std::make_shared<Bytes>(fromHex("0x00112233445566778899"));
+    SmallBytes part = SmallBytes::share(frame, 2, 3);
+    BOOST_CHECK(toHex(part) == "223344");
+    BOOST_CHECK(part.data() == frame->data() + 2);
+    BOOST_CHECK_THROW(SmallBytes::share(frame, 8, 3), OutOfRange);
+
+    // 追加自身的数据
+    part.append(part);
+    BOOST_CHECK(toHex(part) == "223344223344");
+    BOOST_CHECK(toHex(*frame) == "00112233445566778899");
+
+    // 比较
+    BOOST_CHECK(SmallBytes(fromHex("0x223344223344")) == part);
+    BOOST_CHECK(SmallBytes(fromHex("0x223344")) != part);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -33,6 +33,24 @@ BOOST_AUTO_TEST_CASE(snappyCompressTest)
     compressedOriginInput.resize(compressedOriginInput.size() - 1);
     BOOST_CHECK_THROW(SnappyCompress::uncompress(compressedOriginInput), CorruptedInput);
     BOOST_CHECK_THROW(SnappyCompress::uncompress(""), CorruptedInput);
+
+    // 输出到SmallBytes
+    SmallBytes compressedSmall, uncompressedSmall;
+    SnappyCompress::compress(input, compressedSmall);
+    BOOST_CHECK(compressedSmall.isInline());
+    SnappyCompress::uncompress(compressedSmall, uncompressedSmall);
+    BOOST_CHECK(uncompressedSmall.toString() == input);
+    BOOST_CHECK_THROW(SnappyCompress::uncompress("", uncompressedSmall), CorruptedInput);
+
+    // 输入较长但压缩结果很短时也放在内联存储中
+    std::string repeated(200, 'x');
+    SnappyCompress::compress(repeated, compressedSmall);
+    BOOST_CHECK(compressedSmall.isInline());
+    BOOST_CHECK(SnappyCompress::uncompress(compressedSmall.ref()) == Bytes(repeated.begin(), repeated.end()));
+    std::string large(10000, 'y');
+    SnappyCompress::compress(large, compressedSmall);
+    SnappyCompress::uncompress(compressedSmall, uncompressedSmall);
+    BOOST_CHECK(uncompressedSmall.toString() == large);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,9 @@
 #include <libdevcore/ThreadPool.h>
 #include <algorithm>
 #include <future>
+#include <atomic>
+#include <vector>
+#include <stdexcept>
 
 namespace dev { namespace test {
 
@@ -43,6 +46,41 @@ BOOST_AUTO_TEST_CASE(ThreadPoolTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(parallelForTest)
+{
+    ThreadPool pool(4);
+    BOOST_CHECK(pool.size() == 4);
+
+    // 每个下标恰好被处理一次
+    std::vector<int> counts(10007, 0);
+    pool.parallelFor(counts.size(), 100, [&counts](size_t beg, size_t end) {
+        for (size_t i = beg; i < end; ++i) {
+            ++counts[i];
+        }
+    });
+    BOOST_CHECK(std::all_of(counts.begin(), counts.end(), [](int c) { return 1 == c; }));
+
+    // 空任务
+    pool.parallelFor(0, 100, [](size_t, size_t) { BOOST_ERROR("should not run"); });
+
+    // 在线程池的线程中嵌套调用不会死锁
+    std::promise<size_t> p;
+    auto fut = p.get_future();
+    pool.enqueue([&pool, &p] {
+        std::atomic<size_t> sum(0);
+        pool.parallelFor(1000, 1, [&sum](size_t beg, size_t end) { sum += end - beg; });
+        p.set_value(sum);
+    });
+    BOOST_CHECK(fut.get() == 1000);
+
+    // 异常传递到调用线程
+    BOOST_CHECK_THROW(pool.parallelFor(100, 1, [](size_t beg, size_t) {
+        if (50 == beg) {
+            throw std::runtime_error("error");
+        }
+    }), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}   // namespace dev::test
\ No newline at end of file
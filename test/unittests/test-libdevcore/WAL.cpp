@@ -0,0 +1,152 @@
+#include <boost/test/unit_test.hpp>
+#include <libdevcore/WAL.h>
+#include <string>
+#include <thread>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dev { namespace test {
+
+// 创建临时目录
+static std::string makeWALDir() {
+    char dir[] = "/tmp/WALTestXXXXXX";
+    BOOST_REQUIRE(mkdtemp(dir));
+    return dir;
+}
+
+// 回放所有记录
+static std::vector<std::pair<uint64_t, std::string>> replayAll(const WAL& wal, uint64_t from = 0) {
+    std::vector<std::pair<uint64_t, std::string>> records;
+    wal.replay(from, [&](uint64_t seq, BytesConstRef data) {
+        records.emplace_back(seq, data.toString());
+    });
+    return records;
+}
+
+// 找到最后一个段文件
+static std::string lastSegment(const std::string& dir) {
+    std::string last;
+    DIR* d = opendir(dir.c_str());
+    while (dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.substr(name.size() - 4) == ".wal" && name > last) {
+            last = name;
+        }
+    }
+    closedir(d);
+    return dir + "/" + last;
+}
+
+BOOST_AUTO_TEST_SUITE(WALTests)
+
+BOOST_AUTO_TEST_CASE(walTest)
+{
+    std::string dir = makeWALDir();
+    {
+        WAL wal(dir);
+        BOOST_CHECK(wal.lastSequence() == 0);
+        BOOST_CHECK(wal.append("block1") == 1);
+        BOOST_CHECK(wal.append("block2") == 2);
+        BOOST_CHECK(wal.append("") == 3);
+        BOOST_CHECK(wal.lastSequence() == 3);
+        auto records = replayAll(wal, 2);
+        BOOST_REQUIRE(records.size() == 2);
+        BOOST_CHECK(records[0].first == 2 && records[0].second == "block2");
+        BOOST_CHECK(records[1].first == 3 && records[1].second.empty());
+    }
+
+    // 末尾写了一半的记录在重新打开时被截掉
+    {
+        int fd = open(lastSegment(dir).c_str(), O_WRONLY | O_APPEND);
+        BOOST_REQUIRE(fd >= 0);
+        Byte torn[] = {0x00, 0x00, 0x00, 0x20, 0x12, 0x34};
+        BOOST_CHECK(sizeof(torn) == write(fd, torn, sizeof(torn)));
+        close(fd);
+
+        WAL wal(dir);
+        BOOST_CHECK(wal.lastSequence() == 3);
+        BOOST_CHECK(replayAll(wal).size() == 3);
+        BOOST_CHECK(wal.append("block4") == 4);
+    }
+    {
+        WAL wal(dir);
+        auto records = replayAll(wal);
+        BOOST_REQUIRE(records.size() == 4);
+        BOOST_CHECK(records[3].first == 4 && records[3].second == "block4");
+    }
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE(walRotateTest)
+{
+    std::string dir = makeWALDir();
+    WALOptions options;
+    options.maxSegmentSize = 256;
+    options.sync = false;
+    {
+        WAL wal(dir, options);
+        for (int i = 1; i <= 100; ++i) {
+            wal.append(std::string(20, 'a' + i % 26));
+        }
+        BOOST_CHECK(wal.segmentCount() > 5);
+
+        // 检查点之后删除旧的段文件，序号不小于检查点的记录都保留
+        size_t before = wal.segmentCount();
+        wal.truncate(60);
+        BOOST_CHECK(wal.segmentCount() < before);
+        auto records = replayAll(wal, 60);
+        BOOST_REQUIRE(records.size() == 41);
+        BOOST_CHECK(records.front().first == 60);
+        BOOST_CHECK(records.back().first == 100);
+        BOOST_CHECK(replayAll(wal).front().first <= 60);
+    }
+    WAL wal(dir, options);
+    BOOST_CHECK(wal.lastSequence() == 100);
+    BOOST_CHECK(wal.append("next") == 101);
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE(walGroupCommitTest)
+{
+    std::string dir = makeWALDir();
+    WALOptions options;
+    options.commitDelay = std::chrono::microseconds(2000);
+    {
+        WAL wal(dir, options);
+        const int threads = 8;
+        const int perThread = 20;
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&wal, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    wal.append(std::to_string(t) + ":" + std::to_string(i));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        // 并发追加被合并为较少的组提交
+        BOOST_CHECK(wal.lastSequence() == threads * perThread);
+        BOOST_CHECK(wal.commitCount() < static_cast<uint64_t>(threads * perThread));
+
+        // 序号连续，每个线程的记录按追加顺序出现
+        auto records = replayAll(wal);
+        BOOST_REQUIRE(records.size() == threads * perThread);
+        std::vector<int> next(threads, 0);
+        for (size_t i = 0; i < records.size(); ++i) {
+            BOOST_CHECK(records[i].first == i + 1);
+            auto colon = records[i].second.find(':');
+            int t = std::stoi(records[i].second.substr(0, colon));
+            BOOST_CHECK(std::stoi(records[i].second.substr(colon + 1)) == next[t]++);
+        }
+    }
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -1,6 +1,8 @@
 #include <boost/test/unit_test.hpp>
 #include <libethcore/Address.h>
 #include <libcrypto/ECDSA.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/Exceptions.h>
 
 namespace dev { namespace test {
 
@@ -19,6 +21,38 @@ BOOST_AUTO_TEST_CASE(toAddressTest)
     BOOST_CHECK(eth::toAddress(sender, nonce).hex0x() == "0xcd234a471b72ba2f1ccf0a70fcaba648a5eecd8d");
 }
 
+BOOST_AUTO_TEST_CASE(batchToAddressTest)
+{
+    ThreadPool pool(4);
+
+    // 批量计算外部账户地址与逐个计算一致
+    std::vector<PubKey> pubs(3000);
+    for (auto& pub : pubs) {
+        pub.randomize();
+    }
+    eth::Addresses addrs = eth::toAddresses(pubs, &pool);
+    BOOST_CHECK(addrs.size() == pubs.size());
+    for (size_t i = 0; i < pubs.size(); ++i) {
+        BOOST_CHECK(addrs[i] == eth::toAddress(pubs[i]));
+    }
+
+    // 合约账户地址：覆盖nonce的各种RLP编码长度，与通用RLP编码结果一致
+    eth::Addresses senders;
+    std::vector<U256> nonces;
+    for (U256 nonce : {U256(0), U256(1), U256(0x7f), U256(0x80), U256(0xffff), std::numeric_limits<U256>::max()}) {
+        for (int i = 0; i < 500; ++i) {
+            senders.push_back(eth::Address::random());
+            nonces.push_back(nonce);
+        }
+    }
+    addrs = eth::toAddresses(senders, nonces, &pool);
+    for (size_t i = 0; i < senders.size(); ++i) {
+        BOOST_CHECK(addrs[i] == right160(keccak256(rlpList(senders[i], nonces[i]))));
+        BOOST_CHECK(addrs[i] == eth::toAddress(senders[i], nonces[i]));
+    }
+    BOOST_CHECK_THROW(eth::toAddresses(senders, std::vector<U256>(1)), OutOfRange);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}   // namespace dev::test
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/BlockArchive.h>
+#include <string>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace dev { namespace test {
+
+// 构造第n个测试区块
+static Bytes makeBlock(uint64_t n) {
+    return rlpList(n, std::string(100 + n % 50, 'a' + n % 26));
+}
+
+// 拷贝区块数据
+static Bytes toBytes(const eth::ArchivedBlock& block) {
+    return Bytes(block.data().begin(), block.data().end());
+}
+
+// 创建临时目录
+static std::string makeArchiveDir() {
+    char dir[] = "/tmp/BlockArchiveTestXXXXXX";
+    BOOST_REQUIRE(mkdtemp(dir));
+    return dir;
+}
+
+BOOST_AUTO_TEST_SUITE(BlockArchiveTests)
+
+BOOST_AUTO_TEST_CASE(blockArchiveTest)
+{
+    std::string dir = makeArchiveDir();
+    eth::BlockArchiveOptions options;
+    options.maxSegmentSize = 4096;
+    {
+        eth::BlockArchive archive(dir, options);
+        BOOST_CHECK(archive.size() == 0);
+        for (uint64_t i = 0; i < 200; ++i) {
+            BOOST_CHECK(archive.append(makeBlock(i), i % 50 == 0) == i);
+        }
+        BOOST_CHECK(archive.size() == 200);
+
+        // 读取直接指向映射内存
+        eth::ArchivedBlock block;
+        BOOST_CHECK(!archive.get(200, block));
+        for (uint64_t i = 0; i < 200; ++i) {
+            BOOST_REQUIRE(archive.get(i, block));
+            BOOST_CHECK(block.mapped());
+            BOOST_CHECK(toBytes(block) == makeBlock(i));
+            BOOST_CHECK(block.rlp().begin()->toInt<uint64_t>() == i);
+        }
+    }
+
+    // 重新打开（多个数据文件）
+    {
+        struct stat st;
+        BOOST_CHECK(0 == stat((dir + "/000002.dat").c_str(), &st));
+        eth::BlockArchive archive(dir, options);
+        BOOST_CHECK(archive.size() == 200);
+        eth::ArchivedBlock block;
+        BOOST_REQUIRE(archive.get(123, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(123));
+        BOOST_CHECK(archive.append(makeBlock(200)) == 200);
+    }
+
+    // 最后一个区块的数据不完整时被丢弃
+    {
+        std::string last;
+        for (int id = 1; ; ++id) {
+            char name[32];
+            snprintf(name, sizeof(name), "/%06d.dat", id);
+            struct stat st;
+            if (0 != stat((dir + name).c_str(), &st)) {
+                break;
+            }
+            last = dir + name;
+        }
+        struct stat st;
+        BOOST_REQUIRE(0 == stat(last.c_str(), &st));
+        BOOST_REQUIRE(0 == truncate(last.c_str(), st.st_size - 10));
+
+        eth::BlockArchive archive(dir, options);
+        BOOST_CHECK(archive.size() == 200);
+        eth::ArchivedBlock block;
+        BOOST_REQUIRE(archive.get(199, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(199));
+        BOOST_CHECK(archive.append(makeBlock(200)) == 200);
+        BOOST_REQUIRE(archive.get(200, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(200));
+    }
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE(unsyncedBlockArchiveTest)
+{
+    // sync为false时中间的记录可能没有落盘而之后的索引项落盘了，从第一个无效的区块开始丢弃
+    std::string dir = makeArchiveDir();
+    uint64_t offset = 0;
+    {
+        eth::BlockArchive archive(dir);
+        for (uint64_t i = 0; i < 10; ++i) {
+            archive.append(makeBlock(i));
+            if (i < 4) {
+                offset += 9 + makeBlock(i).size();
+            }
+        }
+    }
+    {
+        // 改掉区块4的最后一个字节
+        int fd = open((dir + "/000001.dat").c_str(), O_RDWR);
+        BOOST_REQUIRE(fd >= 0);
+        Byte c = 0;
+        BOOST_CHECK(1 == pwrite(fd, &c, 1, offset + 9 + makeBlock(4).size() - 1));
+        close(fd);
+
+        eth::BlockArchive archive(dir);
+        BOOST_CHECK(archive.size() == 4);
+        eth::ArchivedBlock block;
+        BOOST_REQUIRE(archive.get(3, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(3));
+        BOOST_CHECK(archive.append(makeBlock(4)) == 4);
+        BOOST_REQUIRE(archive.get(4, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(4));
+    }
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE(compressedBlockArchiveTest)
+{
+    std::string dir = makeArchiveDir();
+    eth::BlockArchiveOptions options;
+    options.compress = true;
+    {
+        eth::BlockArchive archive(dir, options);
+        for (uint64_t i = 0; i < 10; ++i) {
+            archive.append(makeBlock(i));
+        }
+        archive.sync();
+    }
+    eth::BlockArchive archive(dir, options);
+    BOOST_CHECK(archive.size() == 10);
+    eth::ArchivedBlock block;
+    for (uint64_t i = 0; i < 10; ++i) {
+        BOOST_REQUIRE(archive.get(i, block));
+        BOOST_CHECK(toBytes(block) == makeBlock(i));
+    }
+    BOOST_CHECK(0 == system(("rm -rf " + dir).c_str()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
@@ -0,0 +1,111 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/BlockHeader.h>
+#include <libethcore/Exceptions.h>
+#include <libcrypto/Keccak.h>
+#include <libdevcore/Hex.h>
+#include <libdevcore/RLP.h>
+
+namespace dev { namespace test {
+
+// 构造一个字段都已填写的区块头
+static eth::BlockHeader makeHeader() {
+    eth::BlockHeader header;
+    header.setParentHash(H256::random());
+    header.setStateRoot(H256::random());
+    header.setTransactionsRoot(H256::random());
+    header.setReceiptsRoot(H256::random());
+    header.setLogBloom(H2048::random());
+    header.setNumber(100);
+    header.setGasLimit(U256("3000000000"));
+    header.setGasUsed(21000);
+    header.setTimestamp(1611480000000);
+    header.setExtraData(fromHex("0x1234"));
+    return header;
+}
+
+BOOST_AUTO_TEST_SUITE(BlockHeaderTests)
+
+BOOST_AUTO_TEST_CASE(encodeDecodeTest)
+{
+    eth::BlockHeader header = makeHeader();
+    H256 hash = header.hash();
+    BOOST_CHECK(eth::BlockHeader(header.rlp()).hash() == hash);
+
+    // 签名不影响区块哈希
+    header.addSignature(Signature(H256::random(), H256::random(), 1));
+    header.addSignature(Signature(H256::random(), H256::random(), 0));
+    BOOST_CHECK(header.hash() == hash);
+
+    // 区块哈希为不含签名的子列表的keccak256
+    SharedBytes encoded = header.rlp();
+    RLP rlp(encoded);
+    BOOST_CHECK(hash == keccak256(rlp.splitList()[0].actualData()));
+
+    // 解码后字段一致，并且直接返回原始编码
+    eth::BlockHeader decoded(encoded);
+    BOOST_CHECK(decoded.rlp().data() == encoded.data());
+    BOOST_CHECK(decoded.hash() == hash);
+    BOOST_CHECK(decoded.parentHash() == header.parentHash());
+    BOOST_CHECK(decoded.stateRoot() == header.stateRoot());
+    BOOST_CHECK(decoded.transactionsRoot() == header.transactionsRoot());
+    BOOST_CHECK(decoded.receiptsRoot() == header.receiptsRoot());
+    BOOST_CHECK(decoded.logBloom() == header.logBloom());
+    BOOST_CHECK(decoded.number() == 100);
+    BOOST_CHECK(decoded.gasLimit() == U256("3000000000"));
+    BOOST_CHECK(decoded.gasUsed() == 21000);
+    BOOST_CHECK(decoded.timestamp() == 1611480000000);
+    BOOST_CHECK(toHex(decoded.extraData()) == "1234");
+    BOOST_CHECK(decoded.signatures().size() == 2);
+    BOOST_CHECK(decoded.signatures()[0].r == header.signatures()[0].r);
+    BOOST_CHECK(decoded.signatures()[1].v == 0);
+
+    // 拷贝保留缓存，修改字段后哈希重新计算
+    eth::BlockHeader copy = decoded;
+    BOOST_CHECK(copy.hash() == hash);
+    copy.setNumber(101);
+    BOOST_CHECK(copy.hash() != hash);
+    BOOST_CHECK(eth::BlockHeader(copy.rlp()).hash() == copy.hash());
+}
+
+BOOST_AUTO_TEST_CASE(badHeaderTest)
+{
+    BOOST_CHECK_THROW(eth::BlockHeader(SharedBytes(fromHex("0x80"))), eth::BadBlockHeader);
+    BOOST_CHECK_THROW(eth::BlockHeader(SharedBytes(rlpList())), eth::BadBlockHeader);
+
+    // 字段数不对
+    RLPStream s(2);
+    s.appendList(1) << H256();
+    s.appendList(0);
+    BOOST_CHECK_THROW(eth::BlockHeader(SharedBytes(s.take())), eth::BadBlockHeader);
+
+    // 签名长度不对
+    eth::BlockHeader header = makeHeader();
+    SharedBytes encoded = header.rlp();
+    RLP fields = RLP(encoded).splitList()[0];
+    RLPStream s2(2);
+    s2.append(fields);
+    s2.appendList(1) << H256();
+    BOOST_CHECK_THROW(eth::BlockHeader(SharedBytes(s2.take())), eth::BadBlockHeader);
+
+    // 定长字段长度不对（parentHash只有31字节，logBloom是列表）
+    for (size_t bad : {0, 4}) {
+        auto items = fields.splitList();
+        RLPStream s3(2);
+        s3.appendList(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i != bad) {
+                s3.append(items[i]);
+            } else if (0 == bad) {
+                s3 << Bytes(31, 0x11);
+            } else {
+                s3.appendList(0);
+            }
+        }
+        s3.appendList(0);
+        BOOST_CHECK_THROW(eth::BlockHeader(SharedBytes(s3.take())), eth::BadBlockHeader);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
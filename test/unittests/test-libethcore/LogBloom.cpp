@@ -0,0 +1,140 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/LogBloom.h>
+#include <libethcore/Address.h>
+#include <libcrypto/Keccak.h>
+#include <algorithm>
+
+namespace dev { namespace test {
+
+// 统计置位的位数
+static size_t popcount(const eth::LogBloom& bloom) {
+    size_t ret = 0;
+    for (auto b : bloom) {
+        ret += __builtin_popcount(b);
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(LogBloomTests)
+
+BOOST_AUTO_TEST_CASE(bloomTest)
+{
+    // 按定义计算位下标
+    eth::Address addr = eth::Address::random();
+    H256 h = keccak256(addr);
+    eth::LogBloom expected;
+    for (size_t i = 0; i < 6; i += 2) {
+        unsigned bit = ((h[i] << 8) | h[i + 1]) & 2047;
+        expected[255 - bit / 8] |= 1 << (bit % 8);
+    }
+    eth::LogBloom bloom = eth::bloomOf(addr);
+    BOOST_CHECK(bloom == expected);
+    BOOST_CHECK(popcount(bloom) >= 1 && popcount(bloom) <= 3);
+
+    // 累加与包含
+    eth::LogBloom block;
+    H256 topic = H256::random();
+    eth::addToBloom(block, addr);
+    eth::LogBloom receipt;
+    eth::addToBloom(receipt, topic);
+    eth::accumulateBloom(block, receipt);
+    BOOST_CHECK(eth::containsBloom(block, bloom));
+    BOOST_CHECK(eth::containsBloom(block, eth::bloomOf(topic)));
+    BOOST_CHECK(eth::containsBloom(block, eth::LogBloom()));
+    BOOST_CHECK(!eth::containsBloom(eth::LogBloom(), bloom));
+}
+
+BOOST_AUTO_TEST_CASE(matchBloomsTest)
+{
+    eth::LogBlooms blooms(1000);
+    for (auto& b : blooms) {
+        for (int i = 0; i < 20; ++i) {
+            eth::addToBloom(b, H256::random());
+        }
+    }
+
+    // 稀疏查询与稠密查询的结果都与逐个比较一致
+    for (size_t items : {1, 2, 40}) {
+        eth::LogBloom query;
+        for (size_t i = 0; i < items; ++i) {
+            eth::addToBloom(query, H256::random());
+        }
+        for (size_t i = 0; i < blooms.size(); i += 7) {
+            blooms[i] |= query;
+        }
+
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < blooms.size(); ++i) {
+            if (eth::containsBloom(blooms[i], query)) {
+                expected.push_back(i);
+            }
+        }
+        BOOST_CHECK(eth::matchBlooms(blooms, query) == expected);
+        BOOST_CHECK(expected.size() >= (blooms.size() + 6) / 7);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bloomIndexTest)
+{
+    eth::BloomIndex index;
+    eth::Address addr = eth::Address::random();
+    H256 topic = H256::random();
+
+    // 在第0段和第2段中放入匹配的区块
+    uint64_t blocks = eth::BloomIndex::c_sectionSize * 3;
+    std::vector<uint64_t> hits{5, 4095, 8192 + 17, 8192 + 4000};
+    for (uint64_t n = 0; n < blocks; n += 3) {
+        eth::LogBloom bloom;
+        eth::addToBloom(bloom, H256::random());
+        index.add(n, bloom);
+    }
+    for (auto n : hits) {
+        eth::LogBloom bloom;
+        eth::addToBloom(bloom, addr);
+        eth::addToBloom(bloom, topic);
+        index.add(n, bloom);
+    }
+    BOOST_CHECK(index.sectionCount() == 3);
+
+    // 地址与topic同时匹配
+    std::vector<eth::LogBlooms> filters{{eth::bloomOf(addr)}, {eth::bloomOf(topic)}};
+    std::vector<uint64_t> result = index.query(0, blocks, filters);
+    for (auto n : hits) {
+        BOOST_CHECK(std::find(result.begin(), result.end(), n) != result.end());
+    }
+    BOOST_CHECK(result.size() < 20);
+
+    // 区间限制
+    result = index.query(4096, 8192 + 100, filters);
+    BOOST_CHECK(std::find(result.begin(), result.end(), 5) == result.end());
+    BOOST_CHECK(std::find(result.begin(), result.end(), 8192 + 17) != result.end());
+    BOOST_CHECK(std::find(result.begin(), result.end(), 8192 + 4000) == result.end());
+
+    // 组内为或
+    H256 other = H256::random();
+    filters = {{eth::bloomOf(other), eth::bloomOf(addr)}};
+    result = index.query(0, blocks, filters);
+    BOOST_CHECK(std::find(result.begin(), result.end(), 4095) != result.end());
+
+    // 单个布隆过滤器
+    BOOST_CHECK(index.query(0, 10, eth::bloomOf(addr)) == std::vector<uint64_t>{5});
+}
+
+BOOST_AUTO_TEST_CASE(bloomIndexEmptyFilterTest)
+{
+    // 没有查询条件（或全0的布隆过滤器）时只返回添加过的区块，不包括超过最新区块的区块号
+    eth::BloomIndex index;
+    for (uint64_t n = 0; n <= 10; ++n) {
+        index.add(n, eth::LogBloom());
+    }
+    index.add(20, eth::bloomOf(H256::random()));
+    std::vector<uint64_t> expected{8, 9, 10, 20};
+    BOOST_CHECK(index.query(8, 100, std::vector<eth::LogBlooms>()) == expected);
+    BOOST_CHECK(index.query(8, 100, std::vector<eth::LogBlooms>{{}, {}}) == expected);
+    BOOST_CHECK(index.query(8, 100, eth::LogBloom()) == expected);
+    BOOST_CHECK(index.query(21, 4000, eth::LogBloom()).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
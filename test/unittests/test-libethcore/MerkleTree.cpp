@@ -0,0 +1,137 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/MerkleTree.h>
+#include <libcrypto/Keccak.h>
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/RLP.h>
+#include <cstring>
+
+namespace dev { namespace test {
+
+// 按定义计算的叶子节点keccak256(0x00 || leaf)
+static H256 naiveLeaf(const H256& leaf) {
+    Bytes buf{0x00};
+    buf.insert(buf.end(), leaf.begin(), leaf.end());
+    return keccak256(buf);
+}
+
+// 按定义计算的父节点keccak256(0x01 || left || right)
+static H256 naivePair(const H256& left, const H256& right) {
+    Bytes buf{0x01};
+    buf.insert(buf.end(), left.begin(), left.end());
+    buf.insert(buf.end(), right.begin(), right.end());
+    return keccak256(buf);
+}
+
+// 按定义逐层计算的默克尔根
+static H256 naiveRoot(H256s level) {
+    if (level.empty()) {
+        return keccak256(BytesConstRef());
+    }
+    for (auto& node : level) {
+        node = naiveLeaf(node);
+    }
+    while (level.size() > 1) {
+        H256s parents;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            parents.push_back(i + 1 < level.size() ? naivePair(level[i], level[i + 1]) : level[i]);
+        }
+        level.swap(parents);
+    }
+    return level.front();
+}
+
+static H256s randomLeaves(size_t n) {
+    H256s leaves(n);
+    for (auto& leaf : leaves) {
+        leaf.randomize();
+    }
+    return leaves;
+}
+
+BOOST_AUTO_TEST_SUITE(MerkleTreeTests)
+
+BOOST_AUTO_TEST_CASE(merkleRootTest)
+{
+    ThreadPool pool(4);
+
+    // 空树和单个叶子
+    BOOST_CHECK(eth::merkleRoot(H256s()) == keccak256(BytesConstRef()));
+    H256 one = H256::random();
+    BOOST_CHECK(eth::merkleRoot(H256s{one}) == naiveLeaf(one));
+    BOOST_CHECK(eth::merkleRoot(H256s{one}) != one);
+
+    // 各种叶子数（包含奇数层）与按定义计算的结果一致
+    for (size_t n : {2, 3, 5, 7, 8, 100, 1025, 5000}) {
+        H256s leaves = randomLeaves(n);
+        H256 expected = naiveRoot(leaves);
+        BOOST_CHECK(eth::merkleRoot(leaves) == expected);
+        BOOST_CHECK(eth::merkleRoot(leaves, &pool) == expected);
+        BOOST_CHECK(eth::MerkleTree(leaves, &pool).root() == expected);
+    }
+
+    // RLP编码的数据项
+    std::vector<Bytes> items;
+    H256s leaves;
+    for (size_t i = 0; i < 3000; ++i) {
+        items.push_back(rlpData(U256(i)));
+        leaves.push_back(keccak256(items.back()));
+    }
+    BOOST_CHECK(eth::merkleRoot(items, &pool) == naiveRoot(leaves));
+    BOOST_CHECK(eth::merkleRoot(items) == naiveRoot(leaves));
+}
+
+BOOST_AUTO_TEST_CASE(merkleProofTest)
+{
+    for (size_t n : {1, 2, 3, 6, 11, 64}) {
+        eth::MerkleTree tree(randomLeaves(n));
+        BOOST_CHECK(tree.size() == n);
+        for (size_t i = 0; i < n; ++i) {
+            eth::MerkleProof proof = tree.proof(i);
+            BOOST_CHECK(eth::MerkleTree::verify(tree.root(), tree.leaf(i), i, n, proof));
+            BOOST_CHECK(!eth::MerkleTree::verify(tree.root(), H256::random(), i, n, proof));
+            if (!proof.empty()) {
+                proof.back().randomize();
+                BOOST_CHECK(!eth::MerkleTree::verify(tree.root(), tree.leaf(i), i, n, proof));
+            }
+        }
+        BOOST_CHECK_THROW(tree.proof(n), OutOfRange);
+        BOOST_CHECK_THROW(tree.leaf(n), OutOfRange);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(secondPreimageTest)
+{
+    // 把内部节点当作叶子，用更短的证明和一半的叶子数验证，不能通过
+    H256s leaves = randomLeaves(8);
+    eth::MerkleTree tree(leaves);
+    H256 left = naivePair(naiveLeaf(leaves[0]), naiveLeaf(leaves[1]));
+    H256 right = naivePair(naiveLeaf(leaves[2]), naiveLeaf(leaves[3]));
+    eth::MerkleProof proof = tree.proof(0);
+    BOOST_REQUIRE_EQUAL(proof.size(), 3);
+    BOOST_CHECK(proof[1] == right);
+    eth::MerkleProof shorter(proof.begin() + 1, proof.end());
+    BOOST_CHECK(!eth::MerkleTree::verify(tree.root(), left, 0, 4, shorter));
+    BOOST_CHECK(!eth::MerkleTree::verify(tree.root(), naivePair(left, right), 0, 2, eth::MerkleProof(proof.begin() + 2, proof.end())));
+
+    // 只有一个叶子时，根不能当作叶子通过验证
+    BOOST_CHECK(!eth::MerkleTree::verify(tree.root(), tree.root(), 0, 1, eth::MerkleProof()));
+    BOOST_CHECK(eth::MerkleTree::verify(naiveLeaf(leaves[0]), leaves[0], 0, 1, eth::MerkleProof()));
+}
+
+BOOST_AUTO_TEST_CASE(merkleUpdateTest)
+{
+    ThreadPool pool(4);
+    H256s leaves = randomLeaves(2049);
+    eth::MerkleTree tree(leaves, &pool);
+    for (size_t i : {0, 1, 1000, 2047, 2048}) {
+        leaves[i].randomize();
+        tree.update(i, leaves[i]);
+        BOOST_CHECK(tree.root() == eth::merkleRoot(leaves));
+        BOOST_CHECK(eth::MerkleTree::verify(tree.root(), leaves[i], i, leaves.size(), tree.proof(i)));
+    }
+    BOOST_CHECK_THROW(tree.update(2049, H256()), OutOfRange);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
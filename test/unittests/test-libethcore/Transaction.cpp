@@ -0,0 +1,89 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/Transaction.h>
+#include <libethcore/Exceptions.h>
+#include <libcrypto/Keccak.h>
+#include <libdevcore/Hex.h>
+#include <libdevcore/RLP.h>
+#include <thread>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(TransactionTests)
+
+BOOST_AUTO_TEST_CASE(decodeTest)
+{
+    // EIP-155示例交易
+    Bytes bs = fromHex("0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83");
+    H256 hash = keccak256(bs);
+    eth::Transaction tx{SharedBytes(std::move(bs))};
+    BOOST_CHECK(tx.hash() == hash);
+    BOOST_CHECK(tx.nonce() == 9);
+    BOOST_CHECK(tx.gasPrice() == U256("20000000000"));
+    BOOST_CHECK(tx.gas() == 21000);
+    BOOST_CHECK(!tx.isCreation());
+    BOOST_CHECK(tx.to() == eth::Address("3535353535353535353535353535353535353535"));
+    BOOST_CHECK(tx.value() == U256("1000000000000000000"));
+    BOOST_CHECK(tx.data().empty());
+    BOOST_CHECK(tx.chainId() == 1);
+    BOOST_CHECK(tx.signature().v == 0);
+    BOOST_CHECK(tx.signature().r == H256("28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"));
+    BOOST_CHECK(tx.signingHash() == H256("daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53"));
+
+    // 不合法的编码
+    BOOST_CHECK_THROW(eth::Transaction(SharedBytes(fromHex("0x80"))), eth::BadTransaction);
+    BOOST_CHECK_THROW(eth::Transaction(SharedBytes(fromHex("0xc2"))), eth::BadTransaction);
+    eth::Transaction badCount{SharedBytes(rlpList(U256(1), U256(2)))};
+    BOOST_CHECK_THROW(badCount.nonce(), eth::BadTransaction);
+    BOOST_CHECK_THROW(badCount.sender(), eth::BadTransaction);
+    eth::Transaction badV{SharedBytes(rlpList(U256(0), U256(0), U256(0), Bytes(), U256(0), Bytes(), U256(29), U256(1), U256(1)))};
+    BOOST_CHECK_THROW(badV.signature(), eth::BadTransaction);
+    eth::Transaction highS{SharedBytes(rlpList(U256(0), U256(0), U256(0), Bytes(), U256(0), Bytes(), U256(27), U256(1), c_secp256k1n - 1))};
+    BOOST_CHECK_THROW(highS.signature(), eth::BadTransaction);
+    eth::Transaction badTo{SharedBytes(rlpList(U256(0), U256(0), U256(0), Bytes(19, 0x11), U256(0), Bytes(), U256(27), U256(1), U256(1)))};
+    BOOST_CHECK_THROW(badTo.to(), eth::BadTransaction);
+    BOOST_CHECK_THROW(badTo.sender(), eth::BadTransaction);
+}
+
+BOOST_AUTO_TEST_CASE(signTest)
+{
+    SecKey sec = SecKey::random();
+    eth::Address from = eth::toAddress(toPubKey(sec));
+
+    for (uint64_t chainId : {0, 1, 1234}) {
+        eth::TransactionSkeleton ts;
+        ts.nonce = 7;
+        ts.gasPrice = 1;
+        ts.gas = 100000;
+        ts.creation = 0 == chainId;
+        ts.to = eth::Address::random();
+        ts.value = 100;
+        ts.data = fromHex("0x6001600101");
+        ts.chainId = chainId;
+
+        auto tx = eth::Transaction::sign(ts, sec);
+        BOOST_CHECK(tx->hash() == keccak256(tx->rlp()));
+        BOOST_CHECK(tx->chainId() == chainId);
+        BOOST_CHECK(tx->isCreation() == ts.creation);
+        BOOST_CHECK(ts.creation || tx->to() == ts.to);
+        BOOST_CHECK(tx->data() == ts.data);
+        BOOST_CHECK(tx->sender() == from);
+
+        // 多线程访问只计算一次，结果一致
+        eth::Transaction copy{tx->rlp()};
+        std::vector<std::thread> threads;
+        std::vector<eth::Address> senders(4);
+        for (size_t i = 0; i < senders.size(); ++i) {
+            threads.emplace_back([&copy, &senders, i] { senders[i] = copy.sender(); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (const auto& s : senders) {
+            BOOST_CHECK(s == from);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
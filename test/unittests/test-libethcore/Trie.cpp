@@ -0,0 +1,140 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/Trie.h>
+#include <libethcore/Exceptions.h>
+#include <libcrypto/Keccak.h>
+#include <libdevcore/RLP.h>
+#include <algorithm>
+#include <map>
+
+namespace dev { namespace test {
+
+BOOST_AUTO_TEST_SUITE(TrieTests)
+
+BOOST_AUTO_TEST_CASE(trieRootTest)
+{
+    auto store = std::make_shared<eth::MemoryTrieStore>();
+
+    // 空树
+    eth::Trie trie(store);
+    BOOST_CHECK(trie.commit() == H256("56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421"));
+
+    // 以太坊测试向量
+    trie.insert(BytesConstRef("doe"), BytesConstRef("reindeer"));
+    trie.insert(BytesConstRef("dog"), BytesConstRef("puppy"));
+    trie.insert(BytesConstRef("dogglesworth"), BytesConstRef("cat"));
+    BOOST_CHECK(trie.dirty());
+    BOOST_CHECK(trie.commit() == H256("8aad789dff2f538bca5d8ea56e8abe10f4c7ba3a5dea95fea4cd6e7c3a1168d3"));
+    BOOST_CHECK(!trie.dirty());
+
+    eth::Trie trie2(store);
+    trie2.insert(BytesConstRef("do"), BytesConstRef("verb"));
+    trie2.insert(BytesConstRef("ether"), BytesConstRef("wookiedoo"));
+    trie2.insert(BytesConstRef("horse"), BytesConstRef("stallion"));
+    trie2.insert(BytesConstRef("shaman"), BytesConstRef("horse"));
+    trie2.insert(BytesConstRef("doge"), BytesConstRef("coin"));
+    trie2.insert(BytesConstRef("ether"), BytesConstRef());
+    trie2.insert(BytesConstRef("dog"), BytesConstRef("puppy"));
+    trie2.insert(BytesConstRef("shaman"), BytesConstRef());
+    BOOST_CHECK(trie2.commit() == H256("5991bb8c6514148a29db676a14ac506cd2cd5775ace63c30a4fe457715e9ac84"));
+}
+
+BOOST_AUTO_TEST_CASE(emptyTrieRootTest)
+{
+    // 空树的根在静态初始化时确定，不依赖其它编译单元的全局变量（与链接顺序无关）
+    BOOST_CHECK(eth::c_emptyTrieRoot == keccak256(Bytes{0x80}));
+    BOOST_CHECK(eth::c_emptyTrieRoot == keccak256(c_rlpEmptyData));
+    eth::Trie trie(std::make_shared<eth::MemoryTrieStore>());
+    BOOST_CHECK(!trie.dirty() && trie.root() == eth::c_emptyTrieRoot);
+}
+
+BOOST_AUTO_TEST_CASE(trieOperationTest)
+{
+    auto store = std::make_shared<eth::MemoryTrieStore>();
+    ThreadPool pool(4);
+
+    // 随机键（包含长度不同，互为前缀的键）
+    std::map<Bytes, Bytes> kvs;
+    for (size_t i = 0; i < 2000; ++i) {
+        H256 k = H256::random();
+        kvs[Bytes(k.begin(), k.begin() + 1 + k[0] % 32)] = rlpData(U256(i));
+    }
+
+    eth::Trie trie(store);
+    for (const auto& kv : kvs) {
+        trie.insert(kv.first, kv.second);
+    }
+    H256 root = trie.commit(&pool);
+
+    // 插入顺序不影响根，并行与串行计算的结果一致
+    std::vector<std::pair<Bytes, Bytes>> shuffled(kvs.begin(), kvs.end());
+    std::reverse(shuffled.begin(), shuffled.end());
+    eth::Trie trie2(std::make_shared<eth::MemoryTrieStore>());
+    for (const auto& kv : shuffled) {
+        trie2.insert(kv.first, kv.second);
+    }
+    BOOST_CHECK(trie2.commit() == root);
+
+    // 查找
+    for (const auto& kv : kvs) {
+        Bytes value;
+        BOOST_CHECK(trie.get(kv.first, value));
+        BOOST_CHECK(value == kv.second);
+    }
+    BOOST_CHECK(!trie.contains(BytesConstRef("not exist key, longer than any inserted key")));
+
+    // 从存储中重新打开
+    eth::Trie reopened(store, root);
+    BOOST_CHECK(!reopened.dirty());
+    for (const auto& kv : kvs) {
+        Bytes value;
+        BOOST_CHECK(reopened.get(kv.first, value));
+        BOOST_CHECK(value == kv.second);
+    }
+
+    // 删除一半后与只插入另一半的树一致
+    eth::Trie half(std::make_shared<eth::MemoryTrieStore>());
+    size_t i = 0;
+    for (const auto& kv : kvs) {
+        if (i++ % 2) {
+            BOOST_CHECK(reopened.remove(kv.first));
+            BOOST_CHECK(!reopened.remove(kv.first));
+        } else {
+            half.insert(kv.first, kv.second);
+        }
+    }
+    BOOST_CHECK(reopened.commit(&pool) == half.commit());
+
+    // 全部删除后为空树
+    for (const auto& kv : kvs) {
+        reopened.remove(kv.first);
+    }
+    BOOST_CHECK(reopened.commit() == eth::c_emptyTrieRoot);
+}
+
+BOOST_AUTO_TEST_CASE(trieStoreTest)
+{
+    // 缺少节点
+    auto store = std::make_shared<eth::MemoryTrieStore>();
+    eth::Trie missing(store, keccak256(BytesConstRef("missing")));
+    BOOST_CHECK_THROW(missing.contains(BytesConstRef("key")), eth::MissingTrieNode);
+
+    // 节点编码不合法
+    H256 bad = keccak256(BytesConstRef("bad"));
+    std::vector<std::pair<H256, Bytes>> nodes;
+    nodes.emplace_back(bad, rlpList(U256(1), U256(2), U256(3)));
+    store->put(std::move(nodes));
+    eth::Trie corrupted(store, bad);
+    BOOST_CHECK_THROW(corrupted.contains(BytesConstRef("key")), eth::BadTrieNode);
+
+    // 短节点内联，不单独写入存储
+    eth::Trie trie(store);
+    size_t before = store->size();
+    trie.insert(BytesConstRef("a"), BytesConstRef("1"));
+    trie.insert(BytesConstRef("b"), BytesConstRef("2"));
+    trie.commit();
+    BOOST_CHECK(store->size() == before + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test
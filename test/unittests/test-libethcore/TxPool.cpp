@@ -0,0 +1,214 @@
+#include <boost/test/unit_test.hpp>
+#include <libethcore/TxPool.h>
+#include <libdevcore/RLP.h>
+#include <algorithm>
+#include <map>
+
+namespace dev { namespace test {
+
+// 构造并签名一个交易
+static eth::Transaction::SP makeTx(const SecKey& sec, uint64_t nonce, uint64_t gasPrice) {
+    eth::TransactionSkeleton ts;
+    ts.nonce = nonce;
+    ts.gasPrice = gasPrice;
+    ts.gas = 21000;
+    ts.to = eth::Address::random();
+    ts.value = 1;
+    ts.chainId = 1;
+    return eth::Transaction::sign(ts, sec);
+}
+
+BOOST_AUTO_TEST_SUITE(TxPoolTests)
+
+BOOST_AUTO_TEST_CASE(importTest)
+{
+    eth::TxPool pool;
+    SecKey sec = SecKey::random();
+
+    auto tx0 = makeTx(sec, 0, 10);
+    BOOST_CHECK(pool.import(tx0) == eth::ImportResult::c_success);
+    BOOST_CHECK(pool.import(tx0) == eth::ImportResult::c_alreadyKnown);
+    BOOST_CHECK(pool.contains(tx0->hash()));
+
+    // 同nonce交易替换
+    BOOST_CHECK(pool.import(makeTx(sec, 0, 10)) == eth::ImportResult::c_underpriced);
+    auto tx0b = makeTx(sec, 0, 20);
+    BOOST_CHECK(pool.import(tx0b) == eth::ImportResult::c_success);
+    BOOST_CHECK(!pool.contains(tx0->hash()));
+    BOOST_CHECK(pool.size() == 1);
+
+    // 签名不合法
+    Bytes bad = rlpList(U256(0), U256(1), U256(1), Bytes(), U256(0), Bytes(), U256(27), U256(1), U256(1));
+    BOOST_CHECK(pool.import(std::make_shared<eth::Transaction>(SharedBytes(std::move(bad)))) == eth::ImportResult::c_malformed);
+
+    // nonce过低
+    auto tx1 = makeTx(sec, 1, 10);
+    BOOST_CHECK(pool.import(tx1) == eth::ImportResult::c_success);
+    pool.removeMined(eth::Transactions{tx0b});
+    BOOST_CHECK(pool.size() == 1);
+    BOOST_CHECK(pool.import(makeTx(sec, 0, 100)) == eth::ImportResult::c_nonceTooLow);
+
+    // 删除
+    BOOST_CHECK(pool.drop(tx1->hash()));
+    BOOST_CHECK(!pool.drop(tx1->hash()));
+    BOOST_CHECK(pool.size() == 0);
+    BOOST_CHECK(pool.bytes() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(minedTest)
+{
+    // 模拟世界状态中各账户的下一个nonce
+    std::map<eth::Address, U256> state;
+    eth::TxPool pool(eth::TxPoolLimits(), nullptr, [&state](const eth::Address& sender) {
+        auto it = state.find(sender);
+        return it != state.end() ? it->second : U256(0);
+    });
+    SecKey sec = SecKey::random();
+    eth::Address from = eth::toAddress(toPubKey(sec));
+
+    // 发送者最后一个排队的交易上链后不能再次导入（nonce记录随队列删除，从状态中查询）
+    auto tx0 = makeTx(sec, 0, 10);
+    BOOST_CHECK(pool.import(tx0) == eth::ImportResult::c_success);
+    BOOST_CHECK(pool.nonceRecords() == 1);
+    state[from] = 1;
+    pool.removeMined(eth::Transactions{tx0});
+    BOOST_CHECK(pool.size() == 0);
+    BOOST_CHECK(pool.nonceRecords() == 0);
+    BOOST_CHECK(pool.import(tx0) == eth::ImportResult::c_nonceTooLow);
+    BOOST_CHECK(pool.pending(10).empty());
+
+    // 状态中nonce为5的账户从5开始可执行
+    SecKey other = SecKey::random();
+    state[eth::toAddress(toPubKey(other))] = 5;
+    BOOST_CHECK(pool.import(makeTx(other, 4, 10)) == eth::ImportResult::c_nonceTooLow);
+    BOOST_CHECK(pool.import(makeTx(other, 5, 10)) == eth::ImportResult::c_success);
+    BOOST_CHECK(pool.pending(10).size() == 1);
+
+    // 没有排队交易的发送者不保留记录，内存不随见过的账户数增长
+    for (int i = 0; i < 100; ++i) {
+        pool.setNonce(eth::Address::random(), 7);
+    }
+    BOOST_CHECK(pool.nonceRecords() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(pendingTest)
+{
+    eth::TxPool pool;
+    SecKey a = SecKey::random();
+    SecKey b = SecKey::random();
+
+    // a的交易gasPrice递增，b的交易gasPrice居中，打包时a的交易也要保持nonce顺序
+    pool.import(makeTx(a, 0, 1));
+    pool.import(makeTx(a, 1, 100));
+    pool.import(makeTx(b, 0, 50));
+    pool.import(makeTx(b, 1, 40));
+    pool.import(makeTx(b, 3, 1000));     // nonce不连续，不可执行
+    SecKey c = SecKey::random();
+    pool.import(makeTx(c, 2, 1000));     // 没有nonce记录时从0开始，不可执行
+
+    eth::Transactions txs = pool.pending(10);
+    BOOST_CHECK(txs.size() == 4);
+    BOOST_CHECK(txs[0]->gasPrice() == 50);
+    BOOST_CHECK(txs[1]->gasPrice() == 40);
+    BOOST_CHECK(txs[2]->gasPrice() == 1);
+    BOOST_CHECK(txs[3]->gasPrice() == 100);
+    BOOST_CHECK(pool.pending(1).size() == 1);
+
+    // 设置nonce后从新的nonce开始
+    pool.setNonce(eth::toAddress(toPubKey(b)), 2);
+    BOOST_CHECK(pool.pending(10).size() == 2);
+    pool.setNonce(eth::toAddress(toPubKey(b)), 3);
+    BOOST_CHECK(pool.pending(10).size() == 3);
+    pool.setNonce(eth::toAddress(toPubKey(c)), 2);
+    BOOST_CHECK(pool.pending(10).size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(evictionTest)
+{
+    eth::TxPoolLimits limits;
+    limits.maxTransactions = 64;
+    eth::TxPool pool(limits);
+
+    // 同一发送者的交易落在同一分片，池满后只有更贵的交易能淘汰更便宜的交易
+    SecKey sec = SecKey::random();
+    std::vector<SecKey> secs;
+    size_t imported = 0;
+    for (size_t i = 0; i < 200; ++i) {
+        secs.push_back(SecKey::random());
+        if (eth::ImportResult::c_success == pool.import(makeTx(secs.back(), 0, 10))) {
+            ++imported;
+        }
+    }
+    BOOST_CHECK(pool.size() == 64);
+    BOOST_CHECK(imported == 64);
+    BOOST_CHECK(pool.import(makeTx(sec, 0, 5)) == eth::ImportResult::c_poolFull);
+
+    // 更贵的交易需要所在分片有可淘汰的交易
+    size_t success = 0;
+    for (size_t i = 0; i < 50; ++i) {
+        if (eth::ImportResult::c_success == pool.import(makeTx(SecKey::random(), 0, 20))) {
+            ++success;
+        }
+    }
+    BOOST_CHECK(success > 0);
+    BOOST_CHECK(pool.size() == 64);
+}
+
+BOOST_AUTO_TEST_CASE(replaceWhenFullTest)
+{
+    SecKey sec = SecKey::random();
+    auto tx0 = makeTx(sec, 0, 10);
+    eth::TxPoolLimits limits;
+    limits.maxTransactions = 1;
+    limits.maxBytes = tx0->rlp().size();
+    eth::TxPool pool(limits);
+    BOOST_CHECK(pool.import(tx0) == eth::ImportResult::c_success);
+
+    // 被替换的交易腾出的空间可以使用
+    eth::Transaction::SP tx0b;
+    do {
+        tx0b = makeTx(sec, 0, 20);
+    } while (tx0b->rlp().size() != tx0->rlp().size());
+    BOOST_CHECK(pool.import(tx0b) == eth::ImportResult::c_success);
+    BOOST_CHECK(pool.size() == 1);
+    BOOST_CHECK(!pool.contains(tx0->hash()));
+
+    // 替换后超出容量时保留原交易
+    auto tx0c = makeTx(sec, 0, 100000);
+    BOOST_REQUIRE(tx0c->rlp().size() > limits.maxBytes);
+    BOOST_CHECK(pool.import(tx0c) == eth::ImportResult::c_poolFull);
+    BOOST_CHECK(pool.contains(tx0b->hash()));
+    BOOST_CHECK(!pool.contains(tx0c->hash()));
+    BOOST_CHECK(pool.size() == 1);
+    BOOST_CHECK(pool.pending(10).size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrentImportTest)
+{
+    ThreadPool threads(4);
+    eth::TxPool pool(eth::TxPoolLimits(), &threads);
+
+    eth::Transactions txs;
+    for (size_t s = 0; s < 50; ++s) {
+        SecKey sec = SecKey::random();
+        for (uint64_t n = 0; n < 20; ++n) {
+            txs.push_back(makeTx(sec, n, 1 + n));
+        }
+    }
+    // 重复的交易只导入一次
+    eth::Transactions all = txs;
+    all.insert(all.end(), txs.begin(), txs.begin() + 100);
+
+    std::vector<eth::ImportResult> results = pool.import(all);
+    size_t success = std::count(results.begin(), results.end(), eth::ImportResult::c_success);
+    BOOST_CHECK(success == txs.size());
+    BOOST_CHECK(pool.size() == txs.size());
+    BOOST_CHECK(pool.pending(txs.size()).size() == txs.size());
+
+    pool.removeMined(txs);
+    BOOST_CHECK(pool.size() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}   // namespace dev::test